@@ -0,0 +1,794 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <iterator>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#include "../containers/containers.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double ElapsedMs(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+      .count();
+}
+
+// Bytes in use on the heap, or 0 where the C library does not report it.
+std::size_t HeapBytes() {
+#ifdef __GLIBC__
+  return mallinfo2().uordblks;
+#else
+  return 0;
+#endif
+}
+
+// Sorted keys spread over [0, 4 * tree_size) so that roughly half of them
+// hit stored keys.
+std::vector<int> MakeSortedKeys(int count, int tree_size) {
+  std::vector<int> keys;
+  keys.reserve(count);
+  double step = 4.0 * tree_size / count;
+  for (int i = 0; i < count; ++i) {
+    keys.push_back(static_cast<int>(i * step) | 1);
+  }
+  return keys;
+}
+
+// Stored keys are 0, 2, 4, ... so odd batch keys are new and the even ones
+// produced by the erase half hit stored keys.
+void BenchSet(int tree_size, int batch_size) {
+  using set = RBtreeMapSet::set<int>;
+  using RBtreeMapSet::BatchAction;
+
+  std::vector<int> keys = MakeSortedKeys(batch_size, tree_size);
+  std::vector<set::batch_op> ops;
+  ops.reserve(batch_size);
+  for (int i = 0; i < batch_size; ++i) {
+    if (i % 2) {
+      ops.push_back({BatchAction::kErase, keys[i] - 1});
+    } else {
+      ops.push_back({BatchAction::kInsert, keys[i]});
+    }
+  }
+
+  set loop;
+  set batch;
+  for (int key = 0; key < 2 * tree_size; key += 2) {
+    loop.insert(key);
+    batch.insert(key);
+  }
+
+  Clock::time_point start = Clock::now();
+  for (const set::batch_op &op : ops) {
+    if (op.action == BatchAction::kInsert) {
+      loop.insert(op.key);
+    } else {
+      set::iterator it = loop.find(op.key);
+      if (it != loop.end()) {
+        loop.erase(it);
+      }
+    }
+  }
+  double loop_ms = ElapsedMs(start);
+
+  start = Clock::now();
+  batch.apply_batch(ops.begin(), ops.end());
+  double batch_ms = ElapsedMs(start);
+
+  std::printf("set  insert/erase  tree %8d  batch %8d  loop %9.2f ms  "
+              "apply_batch %9.2f ms\n",
+              tree_size, batch_size, loop_ms, batch_ms);
+}
+
+void BenchMap(int tree_size, int batch_size) {
+  using map = RBtreeMapSet::map<int, int>;
+  using RBtreeMapSet::BatchAction;
+
+  std::vector<int> keys = MakeSortedKeys(batch_size, tree_size);
+  std::vector<map::batch_op> ops;
+  ops.reserve(batch_size);
+  for (int i = 0; i < batch_size; ++i) {
+    ops.push_back({BatchAction::kAssign, {keys[i] - i % 2, i}});
+  }
+
+  map loop;
+  map batch;
+  for (int key = 0; key < 2 * tree_size; key += 2) {
+    loop.insert(key, key);
+    batch.insert(key, key);
+  }
+
+  Clock::time_point start = Clock::now();
+  for (const map::batch_op &op : ops) {
+    loop.insert_or_assign(op.key.first, op.key.second);
+  }
+  double loop_ms = ElapsedMs(start);
+
+  start = Clock::now();
+  batch.apply_batch(ops.begin(), ops.end());
+  double batch_ms = ElapsedMs(start);
+
+  std::printf("map  upsert        tree %8d  batch %8d  loop %9.2f ms  "
+              "apply_batch %9.2f ms\n",
+              tree_size, batch_size, loop_ms, batch_ms);
+}
+
+// Lookups that walk forward through the keys in small steps, as with
+// time-ordered events.
+void BenchFinger(int tree_size) {
+  using map = RBtreeMapSet::map<int, int>;
+
+  map plain;
+  map finger;
+  finger.set_finger_mode(true);
+  for (int key = 0; key < tree_size; ++key) {
+    plain.insert(key, key);
+    finger.insert(key, key);
+  }
+
+  std::vector<int> keys;
+  keys.reserve(tree_size);
+  unsigned seed = 1;
+  for (int key = 0; key < tree_size;) {
+    keys.push_back(key);
+    seed = seed * 1103515245 + 12345;
+    key += 1 + (seed >> 16) % 8;
+  }
+
+  long sum = 0;
+  Clock::time_point start = Clock::now();
+  for (int key : keys) {
+    sum += plain.contains(key);
+  }
+  double plain_ms = ElapsedMs(start);
+
+  start = Clock::now();
+  for (int key : keys) {
+    sum += finger.contains(key);
+  }
+  double finger_ms = ElapsedMs(start);
+
+  std::printf("map  local lookups tree %8d  count %8zu  root %9.2f ms  "
+              "finger %9.2f ms  (%ld)\n",
+              tree_size, keys.size(), plain_ms, finger_ms, sum);
+}
+
+// Builds a map whose nodes are scattered over the heap: keys arrive in
+// random order, unrelated allocations land between them and half of the keys
+// are erased and inserted again.
+void Fragment(RBtreeMapSet::map<int, int> &map, int tree_size,
+              std::vector<std::vector<char>> &garbage) {
+  unsigned seed = 7;
+  auto next = [&seed]() {
+    seed = seed * 1103515245 + 12345;
+    return seed >> 8;
+  };
+
+  std::vector<int> keys(tree_size);
+  for (int i = 0; i < tree_size; ++i) {
+    keys[i] = i;
+  }
+  for (int i = tree_size - 1; i > 0; --i) {
+    std::swap(keys[i], keys[next() % (i + 1)]);
+  }
+
+  for (int key : keys) {
+    map.insert(key, key);
+    garbage.emplace_back(next() % 96);
+  }
+  for (int i = 0; i < tree_size; i += 2) {
+    map.erase(map.find(keys[i]));
+    garbage.emplace_back(next() % 96);
+  }
+  for (int i = 0; i < tree_size; i += 2) {
+    map.insert(keys[i], keys[i]);
+  }
+}
+
+void BenchLayout(const char *name, RBtreeMapSet::map<int, int> &map,
+                 const std::vector<int> &lookups) {
+  long sum = 0;
+  Clock::time_point start = Clock::now();
+  for (int key : lookups) {
+    sum += (*map.find(key)).second;
+  }
+  double lookup_ms = ElapsedMs(start);
+
+  start = Clock::now();
+  for (const auto &item : map) {
+    sum += item.second;
+  }
+  double scan_ms = ElapsedMs(start);
+
+  std::printf("map  %-13s tree %8zu  lookups %9.2f ms  scan %9.2f ms  "
+              "(%ld)\n",
+              name, map.size(), lookup_ms, scan_ms, sum);
+}
+
+void BenchCompact(int tree_size) {
+  std::vector<std::vector<char>> garbage;
+  RBtreeMapSet::map<int, int> map;
+  Fragment(map, tree_size, garbage);
+
+  std::vector<int> lookups;
+  unsigned seed = 3;
+  for (int i = 0; i < tree_size; ++i) {
+    seed = seed * 1103515245 + 12345;
+    lookups.push_back((seed >> 8) % tree_size);
+  }
+
+  BenchLayout("fragmented", map, lookups);
+  map.compact(RBtreeMapSet::NodeLayout::kInOrder);
+  BenchLayout("in-order", map, lookups);
+  map.compact(RBtreeMapSet::NodeLayout::kVanEmdeBoas);
+  BenchLayout("van Emde Boas", map, lookups);
+}
+
+template <typename Map>
+double BenchLookups(const Map &map, const std::vector<int> &lookups,
+                    long &sum) {
+  Clock::time_point start = Clock::now();
+  for (int key : lookups) {
+    sum += map.contains(key);
+  }
+  return ElapsedMs(start);
+}
+
+// Random point lookups, half of them misses, with and without the hash
+// index.
+void BenchHashed(int tree_size) {
+  RBtreeMapSet::map<int, int> plain;
+  RBtreeMapSet::hashed_map<int, int> hashed;
+  for (int key = 0; key < tree_size; ++key) {
+    plain.insert(key * 2, key);
+    hashed.insert(key * 2, key);
+  }
+
+  std::vector<int> lookups;
+  unsigned seed = 5;
+  for (int i = 0; i < tree_size; ++i) {
+    seed = seed * 1103515245 + 12345;
+    lookups.push_back((seed >> 8) % (tree_size * 2));
+  }
+
+  long sum = 0;
+  double plain_ms = BenchLookups(plain, lookups, sum);
+  double hashed_ms = BenchLookups(hashed, lookups, sum);
+
+  std::printf("map  point lookups tree %8d  root %9.2f ms  hashed %9.2f ms  "
+              "index %5.1f B/elem  (%ld)\n",
+              tree_size, plain_ms, hashed_ms,
+              static_cast<double>(hashed.index_memory_usage()) / tree_size,
+              sum);
+}
+
+// Keys drawn from a Zipf distribution with the given exponent: the key of
+// rank r is drawn with probability proportional to 1 / r^exponent. Ranks are
+// scattered over the key space so that hot keys are not neighbours.
+std::vector<int> MakeZipfKeys(int count, int tree_size, double exponent) {
+  std::vector<double> cdf(tree_size);
+  double total = 0;
+  for (int rank = 0; rank < tree_size; ++rank) {
+    total += 1 / std::pow(rank + 1, exponent);
+    cdf[rank] = total;
+  }
+
+  std::vector<int> keys;
+  keys.reserve(count);
+  unsigned long long seed = 11;
+  for (int i = 0; i < count; ++i) {
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    double point = static_cast<double>(seed >> 11) / (1ULL << 53) * total;
+    long rank = std::lower_bound(cdf.begin(), cdf.end(), point) - cdf.begin();
+    keys.push_back(static_cast<int>(rank * 7919 % tree_size));
+  }
+
+  return keys;
+}
+
+void BenchZipf(int tree_size, double exponent) {
+  RBtreeMapSet::map<int, int> plain;
+  RBtreeMapSet::cached_map<int, int> cached;
+  for (int key = 0; key < tree_size; ++key) {
+    plain.insert(key, key);
+    cached.insert(key, key);
+  }
+
+  std::vector<int> lookups = MakeZipfKeys(tree_size, tree_size, exponent);
+
+  long sum = 0;
+  double plain_ms = BenchLookups(plain, lookups, sum);
+  double cached_ms = BenchLookups(cached, lookups, sum);
+
+  std::printf("map  zipf s=%.2f    tree %8d  root %9.2f ms  cached %9.2f ms  "
+              "(%ld)\n",
+              exponent, tree_size, plain_ms, cached_ms, sum);
+}
+
+// Runs ops_per_thread random operations on keys in [0, key_range) from each
+// of thread_count threads: half inserts, a quarter erases and a quarter
+// lookups. Returns the wall time.
+template <typename Insert, typename Erase, typename Lookup>
+double RunMixed(int thread_count, int ops_per_thread, int key_range,
+                Insert insert, Erase erase, Lookup lookup) {
+  std::vector<std::thread> threads;
+  Clock::time_point start = Clock::now();
+
+  for (int id = 0; id < thread_count; ++id) {
+    threads.emplace_back([=, &insert, &erase, &lookup]() {
+      unsigned seed = id * 2654435761U + 1;
+      for (int i = 0; i < ops_per_thread; ++i) {
+        seed = seed * 1103515245 + 12345;
+        int key = (seed >> 8) % key_range;
+        switch (seed >> 30) {
+          case 0:
+          case 1:
+            insert(key);
+            break;
+          case 2:
+            erase(key);
+            break;
+          default:
+            lookup(key);
+        }
+      }
+    });
+  }
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+
+  return ElapsedMs(start);
+}
+
+// Write-heavy mix on a shared set from 1 to 64 threads: the lock-free skip
+// list against set behind a mutex. Each thread does the same number of
+// operations, so perfect scaling keeps the time constant.
+void BenchConcurrent(int ops_per_thread, int key_range) {
+  for (int thread_count : {1, 2, 4, 8, 16, 32, 64}) {
+    RBtreeMapSet::set<int> locked;
+    std::mutex mutex;
+    double locked_ms = RunMixed(
+        thread_count, ops_per_thread, key_range,
+        [&](int key) {
+          std::lock_guard<std::mutex> lock(mutex);
+          locked.insert(key);
+        },
+        [&](int key) {
+          std::lock_guard<std::mutex> lock(mutex);
+          auto it = locked.find(key);
+          if (it != locked.end()) {
+            locked.erase(it);
+          }
+        },
+        [&](int key) {
+          std::lock_guard<std::mutex> lock(mutex);
+          return locked.contains(key);
+        });
+
+    RBtreeMapSet::concurrent_skiplist_set<int> skiplist;
+    double skiplist_ms = RunMixed(
+        thread_count, ops_per_thread, key_range,
+        [&](int key) { skiplist.insert(key); },
+        [&](int key) { skiplist.erase(key); },
+        [&](int key) { return skiplist.contains(key); });
+
+    std::printf("set  mixed threads %3d  ops %9d  mutex %9.2f ms  "
+                "skiplist %9.2f ms\n",
+                thread_count, ops_per_thread * thread_count, locked_ms,
+                skiplist_ms);
+  }
+}
+
+// Diff of two versions of a map that differ in 1% of the keys, next to the
+// full lock-step walk of operator== on two equal maps.
+void BenchDiff(int tree_size) {
+  RBtreeMapSet::map<int, int> old_map;
+  for (int key = 0; key < tree_size; ++key) {
+    old_map.insert(key, key);
+  }
+
+  RBtreeMapSet::map<int, int> same(old_map);
+  RBtreeMapSet::map<int, int> new_map(old_map);
+  for (int key = 0; key < tree_size; key += 300) {
+    new_map.erase(new_map.find(key));
+    new_map[key + 100] = -1;
+    new_map.insert(tree_size + key, key);
+  }
+
+  struct Counter {
+    void added(const std::pair<const int, int> &) { ++count; }
+    void removed(const std::pair<const int, int> &) { ++count; }
+    void changed(const std::pair<const int, int> &,
+                 const std::pair<const int, int> &) {
+      ++count;
+    }
+
+    long count = 0;
+  } counter;
+
+  Clock::time_point start = Clock::now();
+  bool equal = old_map == same;
+  double equal_ms = ElapsedMs(start);
+
+  start = Clock::now();
+  RBtreeMapSet::diff(old_map, new_map, counter);
+  double diff_ms = ElapsedMs(start);
+
+  std::printf("map  diff          tree %8d  operator== %9.2f ms  diff %9.2f ms"
+              "  (%ld changes, %d)\n",
+              tree_size, equal_ms, diff_ms, counter.count, equal);
+}
+
+// A replica refreshed by assignment from a source that changes 1% of its
+// keys between rounds, next to copying the source and dropping the old
+// replica.
+void BenchAssign(int tree_size, int rounds) {
+  using map = RBtreeMapSet::map<int, int>;
+
+  map source;
+  for (int key = 0; key < tree_size; ++key) {
+    source.insert(key, key);
+  }
+
+  map assigned(source);
+  map copied(source);
+  double assign_ms = 0;
+  double copy_ms = 0;
+
+  for (int round = 0; round < rounds; ++round) {
+    for (int key = round; key < tree_size; key += 100) {
+      source.erase(source.find(key));
+      source.insert(tree_size + key, round);
+    }
+
+    Clock::time_point start = Clock::now();
+    assigned = source;
+    assign_ms += ElapsedMs(start);
+
+    start = Clock::now();
+    map copy(source);
+    copied.swap(copy);
+    copy.clear();
+    copy_ms += ElapsedMs(start);
+  }
+
+  std::printf("map  assign        tree %8d  rounds %3d  copy+free %9.2f ms  "
+              "operator= %9.2f ms  (%d)\n",
+              tree_size, rounds, copy_ms, assign_ms, assigned == copied);
+}
+
+// URL keys that share long prefixes, stored in set<std::string> and in
+// string_set: heap bytes per key and the time to find every key.
+void BenchStrings(int count) {
+  std::vector<std::string> keys;
+  keys.reserve(count);
+  for (int i = 0; i < count; ++i) {
+    int id = static_cast<int>(i * 2654435761U % count);
+    keys.push_back("https://cdn.example.com/static/v" +
+                   std::to_string(id % 4) + "/users/" + std::to_string(id) +
+                   (id % 3 ? "/avatar.png" : "/profile.json"));
+  }
+
+  std::size_t before = HeapBytes();
+  RBtreeMapSet::set<std::string> set;
+  for (const std::string &key : keys) {
+    set.insert(key);
+  }
+  double set_bytes = static_cast<double>(HeapBytes() - before) / count;
+
+  before = HeapBytes();
+  RBtreeMapSet::string_set string_set;
+  for (const std::string &key : keys) {
+    string_set.insert(key);
+  }
+  double string_set_bytes = static_cast<double>(HeapBytes() - before) / count;
+
+  long found = 0;
+  Clock::time_point start = Clock::now();
+  for (const std::string &key : keys) {
+    found += set.contains(key);
+  }
+  double set_ms = ElapsedMs(start);
+
+  start = Clock::now();
+  for (const std::string &key : keys) {
+    found += string_set.contains(key);
+  }
+  double string_set_ms = ElapsedMs(start);
+
+  std::printf("set  strings       keys %8d  set %6.1f B/key %9.2f ms  "
+              "string_set %6.1f B/key %9.2f ms  (%ld)\n",
+              count, set_bytes, set_ms, string_set_bytes, string_set_ms,
+              found);
+}
+
+// Two sets of count 32-bit IDs: a random 60% of [0, 5/3 count), and runs of
+// 1000 IDs with gaps of 500 over an overlapping range. Heap bytes per key of
+// set<std::uint32_t> and int_set, before and after optimize(), and the time
+// for union, intersection and difference: std::set_union and the like over
+// the two sets into a vector, against the int_set operators.
+void BenchIntSet(int count) {
+  std::vector<std::uint32_t> random_ids;
+  std::vector<std::uint32_t> run_ids;
+  random_ids.reserve(count);
+  run_ids.reserve(count);
+  std::uint32_t range = count / 3U * 5U;
+  for (int i = 0; i < count; ++i) {
+    random_ids.push_back(i * 2654435761U % range);
+    run_ids.push_back(range / 2 + i / 1000 * 1500 + i % 1000);
+  }
+
+  std::size_t before = HeapBytes();
+  RBtreeMapSet::set<std::uint32_t> set_a;
+  RBtreeMapSet::set<std::uint32_t> set_b;
+  for (int i = 0; i < count; ++i) {
+    set_a.insert(random_ids[i]);
+    set_b.insert(run_ids[i]);
+  }
+  double set_bytes = static_cast<double>(HeapBytes() - before) /
+                     (set_a.size() + set_b.size());
+
+  before = HeapBytes();
+  RBtreeMapSet::int_set<std::uint32_t> int_a;
+  RBtreeMapSet::int_set<std::uint32_t> int_b;
+  for (int i = 0; i < count; ++i) {
+    int_a.insert(random_ids[i]);
+    int_b.insert(run_ids[i]);
+  }
+  double int_bytes = static_cast<double>(HeapBytes() - before) /
+                     (int_a.size() + int_b.size());
+  int_a.optimize();
+  int_b.optimize();
+  double optimized_bytes = static_cast<double>(HeapBytes() - before) /
+                           (int_a.size() + int_b.size());
+
+  std::vector<std::uint32_t> out;
+  out.reserve(2 * count);
+  Clock::time_point start = Clock::now();
+  std::set_union(set_a.begin(), set_a.end(), set_b.begin(), set_b.end(),
+                 std::back_inserter(out));
+  std::size_t set_sizes = out.size();
+  out.clear();
+  std::set_intersection(set_a.begin(), set_a.end(), set_b.begin(),
+                        set_b.end(), std::back_inserter(out));
+  set_sizes += out.size();
+  out.clear();
+  std::set_difference(set_a.begin(), set_a.end(), set_b.begin(), set_b.end(),
+                      std::back_inserter(out));
+  set_sizes += out.size();
+  double set_ms = ElapsedMs(start);
+
+  start = Clock::now();
+  std::size_t int_sizes = (int_a | int_b).size() + (int_a & int_b).size() +
+                          (int_a - int_b).size();
+  double int_ms = ElapsedMs(start);
+
+  std::printf("set  uint32        keys %8d  set %6.1f B/key %9.2f ms  "
+              "int_set %5.2f B/key (%5.2f optimized) %9.2f ms  (%d)\n",
+              count, set_bytes, set_ms, int_bytes, optimized_bytes, int_ms,
+              set_sizes == int_sizes);
+}
+
+// Point queries against intervals of length up to 64 spread over
+// [0, 4 * tree_size), answered by the interval tree and by a scan of all
+// intervals.
+void BenchIntervals(int tree_size, int queries) {
+  RBtreeMapSet::interval_set<int> set;
+  std::vector<RBtreeMapSet::Interval<int>> intervals;
+  intervals.reserve(tree_size);
+  for (int i = 0; i < tree_size; ++i) {
+    int lo = static_cast<int>(i * 2654435761U % (4U * tree_size));
+    int hi = lo + 1 + i % 64;
+    if (set.insert(lo, hi).second) {
+      intervals.push_back({lo, hi});
+    }
+  }
+
+  long tree_hits = 0;
+  Clock::time_point start = Clock::now();
+  for (int i = 0; i < queries; ++i) {
+    int point = static_cast<int>(i * 40503U % (4U * tree_size));
+    set.for_each_overlapping(point, [&tree_hits](const auto &) {
+      ++tree_hits;
+    });
+  }
+  double tree_ms = ElapsedMs(start);
+
+  long scan_hits = 0;
+  start = Clock::now();
+  for (int i = 0; i < queries / 100; ++i) {
+    int point = static_cast<int>(i * 40503U % (4U * tree_size));
+    for (const auto &interval : intervals) {
+      scan_hits += interval.Contains(point);
+    }
+  }
+  double scan_ms = ElapsedMs(start) * 100;
+
+  std::printf("intervals  tree %8d  queries %7d  tree %9.2f ms  scan %9.2f ms"
+              "  (%ld hits, scan extrapolated from 1%%, %ld)\n",
+              tree_size, queries, tree_ms, scan_ms, tree_hits, scan_hits);
+}
+
+// A scheduler queue of pending jobs keyed by due time: every step pops the
+// next job and schedules it again up to 1024 ticks later, then the queue is
+// drained. The low bits keep the keys distinct.
+template <typename Queue, typename Pop>
+void RunScheduler(Queue &queue, int jobs, int steps, Pop pop, double &run_ms,
+                  double &drain_ms, long &sum) {
+  for (long job = 0; job < jobs; ++job) {
+    queue.insert(job * 2654435761L % (jobs * 64L) << 20 | job);
+  }
+
+  Clock::time_point start = Clock::now();
+  for (int i = 0; i < steps; ++i) {
+    long key = pop(queue);
+    sum += key;
+    queue.insert(((key >> 20) + 1 + i * 7919U % 1024) << 20 | (key & 0xfffff));
+  }
+  run_ms = ElapsedMs(start);
+
+  start = Clock::now();
+  while (!queue.empty()) {
+    sum -= pop(queue);
+  }
+  drain_ms = ElapsedMs(start);
+}
+
+// extract_min steps from the removed node to its neighbour. The baseline
+// pays the descent from the root that the tree used to make after every
+// removal of its smallest node: it looks the smallest key up again and
+// erases it through the found iterator.
+void BenchScheduler(int jobs, int steps) {
+  double run_ms[3];
+  double drain_ms[3];
+  long sum = 0;
+
+  RBtreeMapSet::set<long> queue;
+  RunScheduler(
+      queue, jobs, steps,
+      [](RBtreeMapSet::set<long> &queue) { return queue.extract_min(); },
+      run_ms[0], drain_ms[0], sum);
+
+  RBtreeMapSet::set<long> descent_queue;
+  RunScheduler(
+      descent_queue, jobs, steps,
+      [](RBtreeMapSet::set<long> &queue) {
+        long key = *queue.begin();
+        queue.erase(queue.find(key));
+        return key;
+      },
+      run_ms[1], drain_ms[1], sum);
+
+  std::set<long> std_queue;
+  RunScheduler(
+      std_queue, jobs, steps,
+      [](std::set<long> &queue) {
+        long key = *queue.begin();
+        queue.erase(queue.begin());
+        return key;
+      },
+      run_ms[2], drain_ms[2], sum);
+
+  std::printf("set  scheduler     jobs %8d  steps %8d  extract_min %9.2f ms  "
+              "re-descent %9.2f ms  std::set %9.2f ms\n",
+              jobs, steps, run_ms[0], run_ms[1], run_ms[2]);
+  std::printf("set  drain         jobs %8d  extract_min %9.2f ms  "
+              "re-descent %9.2f ms  std::set %9.2f ms  (%ld)\n",
+              jobs, drain_ms[0], drain_ms[1], drain_ms[2], sum);
+}
+
+// Clock of the ttl benchmark, advanced by hand.
+struct BenchClock {
+  using duration = std::chrono::microseconds;
+  using rep = duration::rep;
+  using period = duration::period;
+  using time_point = std::chrono::time_point<BenchClock>;
+  static constexpr bool is_steady = true;
+
+  static time_point now() noexcept { return current; }
+
+  static time_point current;
+};
+
+BenchClock::time_point BenchClock::current{};
+
+// A cache under churn: every step inserts a key with a ttl of up to 4096
+// steps, refreshes the ttl of an older key, and expires the entries that are
+// due every 64 steps. ttl_map is compared with a map by key kept in sync
+// with a map by (deadline, key).
+void BenchTtl(int steps) {
+  using us = std::chrono::microseconds;
+  using time_point = BenchClock::time_point;
+
+  BenchClock::current = time_point{};
+  RBtreeMapSet::ttl_map<int, int, std::less<int>, BenchClock> ttl;
+  long ttl_expired = 0;
+  Clock::time_point start = Clock::now();
+  for (int i = 0; i < steps; ++i) {
+    BenchClock::current += us(1);
+    ttl.insert(i, i, us(1 + i * 7919U % 4096));
+    ttl.touch(i * 31 % (i + 1), us(1 + i * 104729U % 4096));
+    if (i % 64 == 0) {
+      ttl_expired += ttl.expire_until(BenchClock::current);
+    }
+  }
+  double ttl_ms = ElapsedMs(start);
+
+  BenchClock::current = time_point{};
+  RBtreeMapSet::map<int, std::pair<int, time_point>> by_key;
+  RBtreeMapSet::map<std::pair<time_point, int>, int> by_deadline;
+  long maps_expired = 0;
+  start = Clock::now();
+  for (int i = 0; i < steps; ++i) {
+    BenchClock::current += us(1);
+    time_point deadline = BenchClock::current + us(1 + i * 7919U % 4096);
+    if (by_key.insert(i, {i, deadline}).second) {
+      by_deadline.insert({deadline, i}, i);
+    }
+
+    int key = i * 31 % (i + 1);
+    auto it = by_key.find(key);
+    if (it != by_key.end()) {
+      by_deadline.erase(by_deadline.find({(*it).second.second, key}));
+      (*it).second.second = BenchClock::current + us(1 + i * 104729U % 4096);
+      by_deadline.insert({(*it).second.second, key}, (*it).second.first);
+    }
+
+    if (i % 64 == 0) {
+      while (!by_deadline.empty() &&
+             !(BenchClock::current < (*by_deadline.begin()).first.first)) {
+        by_key.erase(by_key.find((*by_deadline.begin()).first.second));
+        by_deadline.erase(by_deadline.begin());
+        ++maps_expired;
+      }
+    }
+  }
+  double maps_ms = ElapsedMs(start);
+
+  std::printf("ttl  churn         steps %7d  ttl_map %9.2f ms  "
+              "two maps %9.2f ms  (%ld, %ld expired)\n",
+              steps, ttl_ms, maps_ms, ttl_expired, maps_expired);
+}
+
+}  // namespace
+
+int main() {
+  const int tree_size = 1000000;
+
+  for (int batch_size : {1000, 10000, 100000, 250000, 1000000}) {
+    BenchSet(tree_size, batch_size);
+  }
+  for (int batch_size : {1000, 10000, 100000, 250000, 1000000}) {
+    BenchMap(tree_size, batch_size);
+  }
+  BenchFinger(tree_size);
+  BenchCompact(tree_size);
+  BenchHashed(tree_size);
+  for (double exponent : {0.6, 0.8, 1.0, 1.2}) {
+    BenchZipf(tree_size, exponent);
+  }
+  BenchDiff(tree_size);
+  BenchAssign(tree_size, 10);
+  BenchStrings(tree_size);
+  BenchIntSet(tree_size);
+  BenchIntervals(tree_size, 100000);
+  BenchTtl(tree_size);
+  for (int jobs : {1000, 100000, 1000000}) {
+    BenchScheduler(jobs, 2000000);
+  }
+  BenchConcurrent(200000, 1 << 16);
+
+  return 0;
+}
@@ -0,0 +1,19 @@
+#ifndef CONTAINERS_CACHED_MAP_H_
+#define CONTAINERS_CACHED_MAP_H_
+
+#include "map.h"
+#include "red_black_tree/cache_lookup.h"
+
+namespace RBtreeMapSet {
+
+// map with a cache of recently found keys in front of the tree, for skewed
+// workloads where a few keys take most of the lookups: find, contains, at and
+// operator[] of a cached key take constant time, see CacheLookup. The cache
+// has a fixed size of Slots entries.
+template <typename Key, typename T, typename Hash = std::hash<Key>,
+          typename Compare = std::less<Key>, std::size_t Slots = 1024>
+using cached_map = map<Key, T, Compare, CacheLookup<Hash, Slots>>;
+
+}  // namespace RBtreeMapSet
+
+#endif  // CONTAINERS_CACHED_MAP_H_
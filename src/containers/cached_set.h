@@ -0,0 +1,17 @@
+#ifndef CONTAINERS_CACHED_SET_H_
+#define CONTAINERS_CACHED_SET_H_
+
+#include "red_black_tree/cache_lookup.h"
+#include "set.h"
+
+namespace RBtreeMapSet {
+
+// set with a cache of recently found keys in front of the tree, see
+// cached_map.
+template <typename Key, typename Hash = std::hash<Key>,
+          typename Compare = std::less<Key>, std::size_t Slots = 1024>
+using cached_set = set<Key, Compare, CacheLookup<Hash, Slots>>;
+
+}  // namespace RBtreeMapSet
+
+#endif  // CONTAINERS_CACHED_SET_H_
@@ -0,0 +1,152 @@
+#ifndef CONTAINERS_CONCURRENT_SKIPLIST_CONCURRENT_SKIPLIST_H_
+#define CONTAINERS_CONCURRENT_SKIPLIST_CONCURRENT_SKIPLIST_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+
+#include "../red_black_tree/compare_traits.h"
+#include "epoch.h"
+
+namespace RBtreeMapSet {
+
+// Lock-free ordered set of keys (a Fraser/Harris skip list). Insert, Erase,
+// Find and iteration may run concurrently from any number of threads; only
+// construction and destruction must not overlap other calls. A node is
+// removed by marking the low bit of its links from the top level down, the
+// mark on level 0 deciding which eraser wins, and is then snipped out by the
+// next traversal that passes it. Removed nodes are freed through
+// EpochDomain.
+//
+// Iterators are forward only and hold an EpochGuard: an element stays
+// readable while an iterator refers to it, even after it is erased, but a
+// long-lived iterator delays the reclamation of every erased node. Iterators
+// must not be passed between threads. Keys cannot be modified in place.
+template <typename Key, typename Compare = std::less<Key>>
+class ConcurrentSkipList {
+ private:
+  struct Node;
+  struct Iterator;
+
+ public:
+  using key_type = Key;
+  using const_reference = const key_type &;
+  using iterator = Iterator;
+  using const_iterator = Iterator;
+  using size_type = std::size_t;
+  using key_compare = Compare;
+
+  ConcurrentSkipList();
+  explicit ConcurrentSkipList(const key_compare &comp);
+  ConcurrentSkipList(const ConcurrentSkipList &other);
+  ConcurrentSkipList &operator=(const ConcurrentSkipList &other) = delete;
+  ~ConcurrentSkipList();
+
+  iterator Begin() const;
+  iterator End() const;
+
+  bool isEmpty() const noexcept;
+  size_type GetSize() const noexcept;
+  size_type GetMaxSize() const noexcept;
+
+  std::pair<iterator, bool> Insert(const key_type &key);
+  bool Erase(const_reference key);
+  iterator Find(const_reference key) const;
+  bool Contains(const_reference key) const;
+  key_compare GetComparator() const;
+
+ private:
+  using Link = std::atomic<std::uintptr_t>;
+
+  static constexpr int kMaxHeight = 32;
+  // Set while the inserting thread links the upper levels, and when the node
+  // is erased. Whichever of the two threads finishes last retires the node.
+  static constexpr unsigned kLinking = 1;
+  static constexpr unsigned kErased = 2;
+
+  static Node *CreateNode(const key_type &key, int height);
+  static void DestroyNode(void *node) noexcept;
+  static Node *GetPointer(std::uintptr_t link) noexcept;
+  static bool IsMarked(std::uintptr_t link) noexcept;
+  static std::uintptr_t ToLink(Node *node) noexcept;
+  static int RandomHeight() noexcept;
+
+  Link *GetLinks(Node *node) const noexcept;
+  bool Search(const_reference key, Node **preds, Node **succs,
+              bool past_equal) const;
+  bool TrySearch(const_reference key, Node **preds, Node **succs,
+                 bool past_equal) const;
+  void LinkUpperLevels(Node *node, Node **preds, Node **succs);
+  void RetireErased(Node *node, unsigned flag);
+  void RaiseHeight(int height) noexcept;
+  static Node *SkipErased(Node *node) noexcept;
+
+  bool IsLess(const_reference key_1, const_reference key_2) const;
+
+  struct alignas(Link) Node {
+    Node(const key_type &key, int height)
+        : key(key), height(height), state(kLinking) {}
+
+    // The links of a node follow it in the same allocation, one per level.
+    Link *GetLinks() noexcept { return reinterpret_cast<Link *>(this + 1); }
+
+    key_type key;
+    int height;
+    std::atomic<unsigned> state;
+  };
+
+  struct Iterator {
+    using iterator_category = std::forward_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = typename ConcurrentSkipList::key_type;
+    using pointer = const value_type *;
+    using reference = const value_type &;
+
+    Iterator() = delete;
+
+    explicit Iterator(Node *node) : node_(node) {}
+
+    reference operator*() const noexcept { return node_->key; }
+
+    pointer operator->() const noexcept { return &node_->key; }
+
+    iterator &operator++() noexcept {
+      node_ = SkipErased(GetPointer(node_->GetLinks()[0].load(
+          std::memory_order_acquire)));
+      return *this;
+    }
+
+    iterator operator++(int) noexcept {
+      iterator tmp{*this};
+      ++(*this);
+      return tmp;
+    }
+
+    bool operator==(const iterator &other) const noexcept {
+      return node_ == other.node_;
+    }
+
+    bool operator!=(const iterator &other) const noexcept {
+      return node_ != other.node_;
+    }
+
+    EpochGuard guard_;
+    Node *node_;
+  };
+
+  using compare_traits = CompareTraits<Compare, Key>;
+
+  Link head[kMaxHeight];
+  // Number of levels in use. Searches start at this level, insertions raise
+  // it before linking a taller node.
+  std::atomic<int> height;
+  std::atomic<std::ptrdiff_t> size;
+  Compare cmp;
+};
+
+}  // namespace RBtreeMapSet
+
+#include "concurrent_skiplist.tpp"
+#endif  // CONTAINERS_CONCURRENT_SKIPLIST_CONCURRENT_SKIPLIST_H_
@@ -0,0 +1,390 @@
+#include <limits>
+#include <new>
+
+#include "concurrent_skiplist.h"
+
+namespace RBtreeMapSet {
+
+template <typename Key, typename Compare>
+ConcurrentSkipList<Key, Compare>::ConcurrentSkipList()
+    : ConcurrentSkipList(key_compare{}) {}
+
+template <typename Key, typename Compare>
+ConcurrentSkipList<Key, Compare>::ConcurrentSkipList(const key_compare &comp)
+    : height(1), size(0), cmp(comp) {
+  for (Link &link : head) {
+    link.store(0, std::memory_order_relaxed);
+  }
+}
+
+template <typename Key, typename Compare>
+ConcurrentSkipList<Key, Compare>::ConcurrentSkipList(
+    const ConcurrentSkipList &other)
+    : ConcurrentSkipList(other.cmp) {
+  for (iterator it = other.Begin(); it != other.End(); ++it) {
+    Insert(*it);
+  }
+}
+
+template <typename Key, typename Compare>
+ConcurrentSkipList<Key, Compare>::~ConcurrentSkipList() {
+  Node *node = GetPointer(head[0].load(std::memory_order_acquire));
+
+  while (node) {
+    Node *next =
+        GetPointer(node->GetLinks()[0].load(std::memory_order_relaxed));
+    DestroyNode(node);
+    node = next;
+  }
+}
+
+template <typename Key, typename Compare>
+typename ConcurrentSkipList<Key, Compare>::Node *
+ConcurrentSkipList<Key, Compare>::CreateNode(const key_type &key,
+                                             int height) {
+  void *memory = ::operator new(sizeof(Node) + sizeof(Link) * height);
+  Node *node;
+
+  try {
+    node = ::new (memory) Node(key, height);
+  } catch (...) {
+    ::operator delete(memory);
+    throw;
+  }
+
+  for (int level = 0; level < height; ++level) {
+    ::new (static_cast<void *>(node->GetLinks() + level)) Link(0);
+  }
+
+  return node;
+}
+
+template <typename Key, typename Compare>
+void ConcurrentSkipList<Key, Compare>::DestroyNode(void *node) noexcept {
+  static_cast<Node *>(node)->~Node();
+  ::operator delete(node);
+}
+
+template <typename Key, typename Compare>
+typename ConcurrentSkipList<Key, Compare>::Node *
+ConcurrentSkipList<Key, Compare>::GetPointer(std::uintptr_t link) noexcept {
+  return reinterpret_cast<Node *>(link & ~std::uintptr_t{1});
+}
+
+template <typename Key, typename Compare>
+bool ConcurrentSkipList<Key, Compare>::IsMarked(std::uintptr_t link) noexcept {
+  return link & 1;
+}
+
+template <typename Key, typename Compare>
+std::uintptr_t ConcurrentSkipList<Key, Compare>::ToLink(Node *node) noexcept {
+  return reinterpret_cast<std::uintptr_t>(node);
+}
+
+template <typename Key, typename Compare>
+int ConcurrentSkipList<Key, Compare>::RandomHeight() noexcept {
+  thread_local std::uint64_t seed =
+      reinterpret_cast<std::uintptr_t>(&seed) | 1;
+
+  seed ^= seed << 13;
+  seed ^= seed >> 7;
+  seed ^= seed << 17;
+
+  int res = 1;
+  for (std::uint64_t bits = seed; res < kMaxHeight && (bits & 1); bits >>= 1) {
+    ++res;
+  }
+
+  return res;
+}
+
+template <typename Key, typename Compare>
+typename ConcurrentSkipList<Key, Compare>::Link *
+ConcurrentSkipList<Key, Compare>::GetLinks(Node *node) const noexcept {
+  return node ? node->GetLinks() : const_cast<Link *>(head);
+}
+
+template <typename Key, typename Compare>
+bool ConcurrentSkipList<Key, Compare>::IsLess(const_reference key_1,
+                                              const_reference key_2) const {
+  return compare_traits::Less(cmp, key_1, key_2);
+}
+
+template <typename Key, typename Compare>
+typename ConcurrentSkipList<Key, Compare>::iterator
+ConcurrentSkipList<Key, Compare>::Begin() const {
+  EpochGuard guard;
+  return iterator(
+      SkipErased(GetPointer(head[0].load(std::memory_order_acquire))));
+}
+
+template <typename Key, typename Compare>
+typename ConcurrentSkipList<Key, Compare>::iterator
+ConcurrentSkipList<Key, Compare>::End() const {
+  return iterator(nullptr);
+}
+
+template <typename Key, typename Compare>
+bool ConcurrentSkipList<Key, Compare>::isEmpty() const noexcept {
+  return GetSize() == 0;
+}
+
+template <typename Key, typename Compare>
+typename ConcurrentSkipList<Key, Compare>::size_type
+ConcurrentSkipList<Key, Compare>::GetSize() const noexcept {
+  // An erase may be counted before the insertion it undoes.
+  std::ptrdiff_t res = size.load(std::memory_order_relaxed);
+  return res > 0 ? res : 0;
+}
+
+template <typename Key, typename Compare>
+typename ConcurrentSkipList<Key, Compare>::size_type
+ConcurrentSkipList<Key, Compare>::GetMaxSize() const noexcept {
+  return std::numeric_limits<size_type>::max() / 2 /
+         (sizeof(Node) + 2 * sizeof(Link));
+}
+
+template <typename Key, typename Compare>
+typename ConcurrentSkipList<Key, Compare>::Node *
+ConcurrentSkipList<Key, Compare>::SkipErased(Node *node) noexcept {
+  while (node) {
+    std::uintptr_t next = node->GetLinks()[0].load(std::memory_order_acquire);
+    if (!IsMarked(next)) {
+      break;
+    }
+    node = GetPointer(next);
+  }
+
+  return node;
+}
+
+template <typename Key, typename Compare>
+bool ConcurrentSkipList<Key, Compare>::Search(const_reference key,
+                                              Node **preds, Node **succs,
+                                              bool past_equal) const {
+  while (!TrySearch(key, preds, succs, past_equal)) {
+  }
+
+  return succs[0] && !IsLess(key, succs[0]->key);
+}
+
+// Finds on every level in use the last node before key and the node after
+// it, snipping out erased nodes on the way. With past_equal the nodes equal
+// to key are walked as well, so that erased ones among them are snipped out
+// too. Returns false if a snip lost a race and the search has to start over.
+template <typename Key, typename Compare>
+bool ConcurrentSkipList<Key, Compare>::TrySearch(const_reference key,
+                                                 Node **preds, Node **succs,
+                                                 bool past_equal) const {
+  Node *pred = nullptr;
+
+  for (int level = height.load(std::memory_order_acquire) - 1; level >= 0;
+       --level) {
+    Node *prev = pred;
+    Node *curr =
+        GetPointer(GetLinks(pred)[level].load(std::memory_order_acquire));
+
+    while (curr) {
+      std::uintptr_t next =
+          curr->GetLinks()[level].load(std::memory_order_acquire);
+
+      if (IsMarked(next)) {
+        std::uintptr_t expected = ToLink(curr);
+        if (!GetLinks(prev)[level].compare_exchange_strong(
+                expected, next & ~std::uintptr_t{1},
+                std::memory_order_acq_rel)) {
+          return false;
+        }
+      } else if (IsLess(curr->key, key)) {
+        pred = curr;
+        prev = curr;
+      } else if (past_equal && !IsLess(key, curr->key)) {
+        prev = curr;
+      } else {
+        break;
+      }
+      curr = GetPointer(next);
+    }
+
+    preds[level] = pred;
+    succs[level] = curr;
+  }
+
+  return true;
+}
+
+template <typename Key, typename Compare>
+void ConcurrentSkipList<Key, Compare>::RaiseHeight(int node_height) noexcept {
+  int current = height.load(std::memory_order_relaxed);
+
+  while (current < node_height &&
+         !height.compare_exchange_weak(current, node_height,
+                                       std::memory_order_acq_rel)) {
+  }
+}
+
+template <typename Key, typename Compare>
+std::pair<typename ConcurrentSkipList<Key, Compare>::iterator, bool>
+ConcurrentSkipList<Key, Compare>::Insert(const key_type &key) {
+  EpochGuard guard;
+  Node *preds[kMaxHeight];
+  Node *succs[kMaxHeight];
+  int node_height = RandomHeight();
+  Node *node = nullptr;
+
+  RaiseHeight(node_height);
+
+  while (true) {
+    if (Search(key, preds, succs, false)) {
+      if (node) {
+        DestroyNode(node);
+      }
+      return {iterator(succs[0]), false};
+    }
+
+    if (!node) {
+      node = CreateNode(key, node_height);
+    }
+
+    for (int level = 0; level < node_height; ++level) {
+      node->GetLinks()[level].store(ToLink(succs[level]),
+                                    std::memory_order_relaxed);
+    }
+
+    std::uintptr_t expected = ToLink(succs[0]);
+    if (GetLinks(preds[0])[0].compare_exchange_strong(
+            expected, ToLink(node), std::memory_order_acq_rel)) {
+      break;
+    }
+  }
+
+  size.fetch_add(1, std::memory_order_relaxed);
+  iterator res(node);
+  LinkUpperLevels(node, preds, succs);
+
+  return {res, true};
+}
+
+// Links a node that is already in the list on level 0 into its upper levels,
+// giving up as soon as it gets erased.
+template <typename Key, typename Compare>
+void ConcurrentSkipList<Key, Compare>::LinkUpperLevels(Node *node,
+                                                       Node **preds,
+                                                       Node **succs) {
+  for (int level = 1; level < node->height; ++level) {
+    while (true) {
+      std::uintptr_t next =
+          node->GetLinks()[level].load(std::memory_order_acquire);
+      if (IsMarked(next)) {
+        RetireErased(node, kLinking);
+        return;
+      }
+
+      if (GetPointer(next) != succs[level] &&
+          !node->GetLinks()[level].compare_exchange_strong(
+              next, ToLink(succs[level]), std::memory_order_acq_rel)) {
+        continue;
+      }
+
+      std::uintptr_t expected = ToLink(succs[level]);
+      if (GetLinks(preds[level])[level].compare_exchange_strong(
+              expected, ToLink(node), std::memory_order_acq_rel)) {
+        break;
+      }
+
+      Search(node->key, preds, succs, false);
+      if (succs[0] != node) {
+        RetireErased(node, kLinking);
+        return;
+      }
+    }
+  }
+
+  RetireErased(node, kLinking);
+}
+
+template <typename Key, typename Compare>
+bool ConcurrentSkipList<Key, Compare>::Erase(const_reference key) {
+  EpochGuard guard;
+  Node *preds[kMaxHeight];
+  Node *succs[kMaxHeight];
+
+  if (!Search(key, preds, succs, false)) {
+    return false;
+  }
+
+  Node *node = succs[0];
+  for (int level = node->height - 1; level > 0; --level) {
+    std::uintptr_t next =
+        node->GetLinks()[level].load(std::memory_order_acquire);
+    while (!IsMarked(next) &&
+           !node->GetLinks()[level].compare_exchange_weak(
+               next, next | 1, std::memory_order_acq_rel)) {
+    }
+  }
+
+  std::uintptr_t next = node->GetLinks()[0].load(std::memory_order_acquire);
+  do {
+    if (IsMarked(next)) {
+      return false;
+    }
+  } while (!node->GetLinks()[0].compare_exchange_weak(
+      next, next | 1, std::memory_order_acq_rel));
+
+  size.fetch_sub(1, std::memory_order_relaxed);
+  RetireErased(node, kErased);
+
+  return true;
+}
+
+// Called by the eraser of a node and by its inserter once it stops linking
+// the node, each passing its own flag. The second of them snips the node out
+// of every level it may have been linked into and retires it.
+template <typename Key, typename Compare>
+void ConcurrentSkipList<Key, Compare>::RetireErased(Node *node,
+                                                    unsigned flag) {
+  bool is_last;
+  if (flag == kErased) {
+    is_last =
+        !(node->state.fetch_or(kErased, std::memory_order_acq_rel) & kLinking);
+  } else {
+    is_last =
+        node->state.fetch_and(~kLinking, std::memory_order_acq_rel) & kErased;
+  }
+
+  if (!is_last) {
+    return;
+  }
+
+  Node *preds[kMaxHeight];
+  Node *succs[kMaxHeight];
+  Search(node->key, preds, succs, true);
+  EpochDomain::Global().Retire(node, &DestroyNode);
+}
+
+template <typename Key, typename Compare>
+typename ConcurrentSkipList<Key, Compare>::iterator
+ConcurrentSkipList<Key, Compare>::Find(const_reference key) const {
+  EpochGuard guard;
+  Node *preds[kMaxHeight];
+  Node *succs[kMaxHeight];
+
+  return iterator(Search(key, preds, succs, false) ? succs[0] : nullptr);
+}
+
+template <typename Key, typename Compare>
+bool ConcurrentSkipList<Key, Compare>::Contains(const_reference key) const {
+  EpochGuard guard;
+  Node *preds[kMaxHeight];
+  Node *succs[kMaxHeight];
+
+  return Search(key, preds, succs, false);
+}
+
+template <typename Key, typename Compare>
+typename ConcurrentSkipList<Key, Compare>::key_compare
+ConcurrentSkipList<Key, Compare>::GetComparator() const {
+  return cmp;
+}
+
+}  // namespace RBtreeMapSet
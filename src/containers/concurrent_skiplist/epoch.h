@@ -0,0 +1,104 @@
+#ifndef CONTAINERS_CONCURRENT_SKIPLIST_EPOCH_H_
+#define CONTAINERS_CONCURRENT_SKIPLIST_EPOCH_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(__SANITIZE_THREAD__)
+#define CONTAINERS_EPOCH_TSAN 1
+#elif defined(__has_feature)
+#if __has_feature(thread_sanitizer)
+#define CONTAINERS_EPOCH_TSAN 1
+#endif
+#endif
+
+namespace RBtreeMapSet {
+
+// Epoch-based reclamation for lock-free containers. A thread reads shared
+// nodes only inside a critical section (between Enter and Exit, usually
+// through an EpochGuard). A node unlinked from its container is passed to
+// Retire and freed once every thread that was inside a critical section at
+// that time has left it: the global epoch advances only when all active
+// threads have observed it, and a node retired in epoch e is freed in epoch
+// e + 2. A thread that stays inside a critical section holds back
+// reclamation for everybody.
+class EpochDomain {
+ public:
+  using Deleter = void (*)(void *);
+
+  static EpochDomain &Global();
+
+  EpochDomain(const EpochDomain &other) = delete;
+  EpochDomain &operator=(const EpochDomain &other) = delete;
+  ~EpochDomain();
+
+  // Critical sections nest within a thread.
+  void Enter();
+  void Exit() noexcept;
+  void Retire(void *ptr, Deleter deleter);
+
+ private:
+  static constexpr std::size_t kCollectThreshold = 64;
+
+  struct Retired {
+    void *ptr;
+    Deleter deleter;
+    std::uint64_t epoch;
+  };
+
+  // Per-thread state. Records are never freed before the domain, a record
+  // released by an exiting thread is reused by the next new thread together
+  // with the nodes still waiting in it.
+  struct Record {
+    // (epoch << 1) | 1 while inside a critical section, 0 otherwise.
+    std::atomic<std::uint64_t> state{0};
+    std::atomic<bool> in_use{true};
+    unsigned nesting = 0;
+    std::vector<Retired> retired;
+    // Size of retired at which the next collection runs. It grows with the
+    // nodes that could not be freed, which keeps retiring O(1) amortized
+    // while a slow thread holds the epoch back.
+    std::size_t collect_at = kCollectThreshold;
+    Record *next = nullptr;
+  };
+
+  // Releases the record of a thread when the thread exits.
+  struct Holder {
+    ~Holder();
+    Record *record = nullptr;
+  };
+
+  EpochDomain() = default;
+
+  Record *GetRecord();
+  Record *Acquire();
+  void Release(Record *record) noexcept;
+  void TryAdvance() noexcept;
+  void Collect(Record *record) noexcept;
+  void Fence() noexcept;
+
+  std::atomic<std::uint64_t> epoch{0};
+  std::atomic<Record *> records{nullptr};
+#ifdef CONTAINERS_EPOCH_TSAN
+  // ThreadSanitizer does not model fences, see Fence.
+  std::atomic<std::uint64_t> fence_word{0};
+#endif
+};
+
+// Keeps the calling thread inside a critical section of the global domain
+// for its lifetime. Copies nest, so a guard must stay on the thread that
+// created it.
+class EpochGuard {
+ public:
+  EpochGuard() { EpochDomain::Global().Enter(); }
+  EpochGuard(const EpochGuard &) : EpochGuard() {}
+  EpochGuard &operator=(const EpochGuard &) noexcept { return *this; }
+  ~EpochGuard() { EpochDomain::Global().Exit(); }
+};
+
+}  // namespace RBtreeMapSet
+
+#include "epoch.tpp"
+#endif  // CONTAINERS_CONCURRENT_SKIPLIST_EPOCH_H_
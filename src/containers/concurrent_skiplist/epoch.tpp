@@ -0,0 +1,142 @@
+#include <algorithm>
+
+#include "epoch.h"
+
+namespace RBtreeMapSet {
+
+inline EpochDomain &EpochDomain::Global() {
+  static EpochDomain domain;
+  return domain;
+}
+
+inline EpochDomain::~EpochDomain() {
+  Record *record = records.load(std::memory_order_acquire);
+
+  while (record) {
+    for (const Retired &item : record->retired) {
+      item.deleter(item.ptr);
+    }
+    Record *next = record->next;
+    delete record;
+    record = next;
+  }
+}
+
+inline EpochDomain::Holder::~Holder() {
+  if (record) {
+    EpochDomain::Global().Release(record);
+  }
+}
+
+inline typename EpochDomain::Record *EpochDomain::GetRecord() {
+  thread_local Holder holder;
+
+  if (!holder.record) {
+    holder.record = Acquire();
+  }
+
+  return holder.record;
+}
+
+inline typename EpochDomain::Record *EpochDomain::Acquire() {
+  for (Record *record = records.load(std::memory_order_acquire); record;
+       record = record->next) {
+    bool expected = false;
+    if (record->in_use.compare_exchange_strong(expected, true)) {
+      return record;
+    }
+  }
+
+  Record *record = new Record;
+  record->next = records.load(std::memory_order_relaxed);
+  while (!records.compare_exchange_weak(record->next, record,
+                                        std::memory_order_release,
+                                        std::memory_order_relaxed)) {
+  }
+
+  return record;
+}
+
+inline void EpochDomain::Release(Record *record) noexcept {
+  TryAdvance();
+  Collect(record);
+  record->in_use.store(false, std::memory_order_release);
+}
+
+inline void EpochDomain::Enter() {
+  Record *record = GetRecord();
+
+  if (record->nesting++ == 0) {
+    std::uint64_t current = epoch.load(std::memory_order_relaxed);
+    record->state.store((current << 1) | 1, std::memory_order_relaxed);
+    Fence();
+  }
+}
+
+inline void EpochDomain::Exit() noexcept {
+  Record *record = GetRecord();
+
+  if (--record->nesting == 0) {
+    record->state.store(0, std::memory_order_release);
+  }
+}
+
+inline void EpochDomain::Retire(void *ptr, Deleter deleter) {
+  Record *record = GetRecord();
+
+  record->retired.push_back(
+      {ptr, deleter, epoch.load(std::memory_order_seq_cst)});
+  if (record->retired.size() >= record->collect_at) {
+    TryAdvance();
+    Collect(record);
+  }
+}
+
+inline void EpochDomain::TryAdvance() noexcept {
+  Fence();
+  std::uint64_t current = epoch.load(std::memory_order_relaxed);
+
+  for (Record *record = records.load(std::memory_order_acquire); record;
+       record = record->next) {
+    std::uint64_t state = record->state.load(std::memory_order_acquire);
+    if ((state & 1) && (state >> 1) != current) {
+      return;
+    }
+  }
+
+  epoch.compare_exchange_strong(current, current + 1,
+                                std::memory_order_acq_rel);
+}
+
+inline void EpochDomain::Collect(Record *record) noexcept {
+  std::uint64_t current = epoch.load(std::memory_order_acquire);
+  std::size_t kept = 0;
+
+  for (std::size_t i = 0; i < record->retired.size(); ++i) {
+    Retired item = record->retired[i];
+    if (item.epoch + 2 <= current) {
+      item.deleter(item.ptr);
+    } else {
+      record->retired[kept++] = item;
+    }
+  }
+
+  record->retired.resize(kept);
+  record->collect_at = std::max(kCollectThreshold, kept * 2);
+}
+
+// Orders the state store of Enter against the state loads of TryAdvance.
+// ThreadSanitizer ignores std::atomic_thread_fence (and GCC rejects it under
+// -fsanitize=thread with -Werror), so sanitized builds use a read-modify-write
+// on one shared word instead: these are totally ordered and each synchronizes
+// with the previous one, which gives the same guarantee at the cost of
+// contention on that word.
+inline void EpochDomain::Fence() noexcept {
+#ifdef CONTAINERS_EPOCH_TSAN
+  fence_word.fetch_add(1, std::memory_order_acq_rel);
+#else
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+#endif
+}
+
+}  // namespace RBtreeMapSet
@@ -0,0 +1,70 @@
+#ifndef CONTAINERS_CONCURRENT_SKIPLIST_MAP_H_
+#define CONTAINERS_CONCURRENT_SKIPLIST_MAP_H_
+
+#include <initializer_list>
+#include <stdexcept>
+
+#include "concurrent_skiplist/concurrent_skiplist.h"
+#include "red_black_tree/map_compare.h"
+
+namespace RBtreeMapSet {
+
+// map that many threads may modify at once without locks, see
+// ConcurrentSkipList and concurrent_skiplist_set. Elements are immutable
+// once inserted: iterators give const access, and at() returns a copy of the
+// mapped value because the element may be erased and freed by another thread
+// as soon as the call returns.
+template <typename Key, typename T, typename Compare = std::less<Key>>
+class concurrent_skiplist_map {
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<const key_type, mapped_type>;
+  using reference = value_type &;
+  using const_reference = const value_type &;
+  using key_compare = Compare;
+
+  using MapCompare = MapKeyCompare<key_type, mapped_type, key_compare>;
+
+  using list_type = ConcurrentSkipList<value_type, MapCompare>;
+  using iterator = typename list_type::iterator;
+  using const_iterator = typename list_type::const_iterator;
+  using size_type = std::size_t;
+
+  concurrent_skiplist_map();
+  explicit concurrent_skiplist_map(const key_compare &comp);
+  concurrent_skiplist_map(std::initializer_list<value_type> const &items);
+  concurrent_skiplist_map(const concurrent_skiplist_map &other);
+  ~concurrent_skiplist_map();
+
+  concurrent_skiplist_map &operator=(const concurrent_skiplist_map &other) =
+      delete;
+
+  mapped_type at(const key_type &key) const;
+
+  iterator begin() const;
+  iterator end() const;
+
+  bool empty() const noexcept;
+  size_type size() const noexcept;
+  size_type max_size() const noexcept;
+
+  void clear();
+  std::pair<iterator, bool> insert(const value_type &value);
+  std::pair<iterator, bool> insert(const key_type &key, const mapped_type &obj);
+  void erase(iterator pos);
+  size_type erase(const key_type &key);
+
+  iterator find(const key_type &key) const;
+  bool contains(const key_type &key) const;
+
+  key_compare key_comp() const;
+
+ private:
+  list_type *list;
+};
+
+}  // namespace RBtreeMapSet
+
+#include "concurrent_skiplist_map.tpp"
+#endif  // CONTAINERS_CONCURRENT_SKIPLIST_MAP_H_
@@ -0,0 +1,124 @@
+#include "concurrent_skiplist_map.h"
+
+namespace RBtreeMapSet {
+
+template <typename Key, typename T, typename Compare>
+concurrent_skiplist_map<Key, T, Compare>::concurrent_skiplist_map()
+    : list(new list_type{}) {}
+
+template <typename Key, typename T, typename Compare>
+concurrent_skiplist_map<Key, T, Compare>::concurrent_skiplist_map(
+    const key_compare &comp)
+    : list(new list_type(MapCompare{comp})) {}
+
+template <typename Key, typename T, typename Compare>
+concurrent_skiplist_map<Key, T, Compare>::concurrent_skiplist_map(
+    std::initializer_list<value_type> const &items)
+    : concurrent_skiplist_map() {
+  for (const value_type &item : items) {
+    insert(item);
+  }
+}
+
+template <typename Key, typename T, typename Compare>
+concurrent_skiplist_map<Key, T, Compare>::concurrent_skiplist_map(
+    const concurrent_skiplist_map &other)
+    : list(new list_type(*other.list)) {}
+
+template <typename Key, typename T, typename Compare>
+concurrent_skiplist_map<Key, T, Compare>::~concurrent_skiplist_map() {
+  delete list;
+  list = nullptr;
+}
+
+template <typename Key, typename T, typename Compare>
+typename concurrent_skiplist_map<Key, T, Compare>::mapped_type
+concurrent_skiplist_map<Key, T, Compare>::at(const key_type &key) const {
+  iterator it = find(key);
+
+  if (it == end()) {
+    throw std::out_of_range("Element with the specified key not found");
+  }
+
+  return it->second;
+}
+
+template <typename Key, typename T, typename Compare>
+typename concurrent_skiplist_map<Key, T, Compare>::iterator
+concurrent_skiplist_map<Key, T, Compare>::begin() const {
+  return list->Begin();
+}
+
+template <typename Key, typename T, typename Compare>
+typename concurrent_skiplist_map<Key, T, Compare>::iterator
+concurrent_skiplist_map<Key, T, Compare>::end() const {
+  return list->End();
+}
+
+template <typename Key, typename T, typename Compare>
+bool concurrent_skiplist_map<Key, T, Compare>::empty() const noexcept {
+  return list->isEmpty();
+}
+
+template <typename Key, typename T, typename Compare>
+typename concurrent_skiplist_map<Key, T, Compare>::size_type
+concurrent_skiplist_map<Key, T, Compare>::size() const noexcept {
+  return list->GetSize();
+}
+
+template <typename Key, typename T, typename Compare>
+typename concurrent_skiplist_map<Key, T, Compare>::size_type
+concurrent_skiplist_map<Key, T, Compare>::max_size() const noexcept {
+  return list->GetMaxSize();
+}
+
+template <typename Key, typename T, typename Compare>
+void concurrent_skiplist_map<Key, T, Compare>::clear() {
+  for (iterator it = begin(); it != end(); ++it) {
+    list->Erase(*it);
+  }
+}
+
+template <typename Key, typename T, typename Compare>
+std::pair<typename concurrent_skiplist_map<Key, T, Compare>::iterator, bool>
+concurrent_skiplist_map<Key, T, Compare>::insert(const value_type &value) {
+  return list->Insert(value);
+}
+
+template <typename Key, typename T, typename Compare>
+std::pair<typename concurrent_skiplist_map<Key, T, Compare>::iterator, bool>
+concurrent_skiplist_map<Key, T, Compare>::insert(const key_type &key,
+                                                 const mapped_type &obj) {
+  return list->Insert({key, obj});
+}
+
+template <typename Key, typename T, typename Compare>
+void concurrent_skiplist_map<Key, T, Compare>::erase(iterator pos) {
+  list->Erase(*pos);
+}
+
+template <typename Key, typename T, typename Compare>
+typename concurrent_skiplist_map<Key, T, Compare>::size_type
+concurrent_skiplist_map<Key, T, Compare>::erase(const key_type &key) {
+  return list->Erase({key, mapped_type{}}) ? 1 : 0;
+}
+
+template <typename Key, typename T, typename Compare>
+typename concurrent_skiplist_map<Key, T, Compare>::iterator
+concurrent_skiplist_map<Key, T, Compare>::find(const key_type &key) const {
+  return list->Find({key, mapped_type{}});
+}
+
+template <typename Key, typename T, typename Compare>
+bool concurrent_skiplist_map<Key, T, Compare>::contains(
+    const key_type &key) const {
+  return list->Contains({key, mapped_type{}});
+}
+
+template <typename Key, typename T, typename Compare>
+typename concurrent_skiplist_map<Key, T, Compare>::key_compare
+concurrent_skiplist_map<Key, T, Compare>::key_comp() const {
+  return list->GetComparator().comp;
+}
+
+}  // namespace RBtreeMapSet
@@ -0,0 +1,63 @@
+#ifndef CONTAINERS_CONCURRENT_SKIPLIST_SET_H_
+#define CONTAINERS_CONCURRENT_SKIPLIST_SET_H_
+
+#include <initializer_list>
+
+#include "concurrent_skiplist/concurrent_skiplist.h"
+
+namespace RBtreeMapSet {
+
+// set that many threads may modify at once without locks, see
+// ConcurrentSkipList. All members except construction, destruction and
+// key_comp may run concurrently. Iterators are forward only and must stay on
+// the thread that obtained them; size() is exact only when no modification
+// is in flight.
+template <typename Key, typename Compare = std::less<Key>>
+class concurrent_skiplist_set {
+ public:
+  using key_type = Key;
+  using value_type = Key;
+  using reference = value_type &;
+  using const_reference = const value_type &;
+  using key_compare = Compare;
+  using value_compare = Compare;
+
+  using list_type = ConcurrentSkipList<value_type, key_compare>;
+  using iterator = typename list_type::iterator;
+  using const_iterator = typename list_type::const_iterator;
+  using size_type = std::size_t;
+
+  concurrent_skiplist_set();
+  explicit concurrent_skiplist_set(const key_compare &comp);
+  concurrent_skiplist_set(std::initializer_list<value_type> const &items);
+  concurrent_skiplist_set(const concurrent_skiplist_set &other);
+  ~concurrent_skiplist_set();
+
+  concurrent_skiplist_set &operator=(const concurrent_skiplist_set &other) =
+      delete;
+
+  iterator begin() const;
+  iterator end() const;
+
+  bool empty() const noexcept;
+  size_type size() const noexcept;
+  size_type max_size() const noexcept;
+
+  void clear();
+  std::pair<iterator, bool> insert(const value_type &value);
+  void erase(iterator pos);
+  size_type erase(const key_type &key);
+
+  iterator find(const key_type &key) const;
+  bool contains(const key_type &key) const;
+
+  key_compare key_comp() const;
+
+ private:
+  list_type *list;
+};
+
+}  // namespace RBtreeMapSet
+
+#include "concurrent_skiplist_set.tpp"
+#endif  // CONTAINERS_CONCURRENT_SKIPLIST_SET_H_
@@ -0,0 +1,105 @@
+#include "concurrent_skiplist_set.h"
+
+namespace RBtreeMapSet {
+
+template <typename Key, typename Compare>
+concurrent_skiplist_set<Key, Compare>::concurrent_skiplist_set()
+    : list(new list_type{}) {}
+
+template <typename Key, typename Compare>
+concurrent_skiplist_set<Key, Compare>::concurrent_skiplist_set(
+    const key_compare &comp)
+    : list(new list_type(comp)) {}
+
+template <typename Key, typename Compare>
+concurrent_skiplist_set<Key, Compare>::concurrent_skiplist_set(
+    std::initializer_list<value_type> const &items)
+    : concurrent_skiplist_set() {
+  for (const value_type &item : items) {
+    insert(item);
+  }
+}
+
+template <typename Key, typename Compare>
+concurrent_skiplist_set<Key, Compare>::concurrent_skiplist_set(
+    const concurrent_skiplist_set &other)
+    : list(new list_type(*other.list)) {}
+
+template <typename Key, typename Compare>
+concurrent_skiplist_set<Key, Compare>::~concurrent_skiplist_set() {
+  delete list;
+  list = nullptr;
+}
+
+template <typename Key, typename Compare>
+typename concurrent_skiplist_set<Key, Compare>::iterator
+concurrent_skiplist_set<Key, Compare>::begin() const {
+  return list->Begin();
+}
+
+template <typename Key, typename Compare>
+typename concurrent_skiplist_set<Key, Compare>::iterator
+concurrent_skiplist_set<Key, Compare>::end() const {
+  return list->End();
+}
+
+template <typename Key, typename Compare>
+bool concurrent_skiplist_set<Key, Compare>::empty() const noexcept {
+  return list->isEmpty();
+}
+
+template <typename Key, typename Compare>
+typename concurrent_skiplist_set<Key, Compare>::size_type
+concurrent_skiplist_set<Key, Compare>::size() const noexcept {
+  return list->GetSize();
+}
+
+template <typename Key, typename Compare>
+typename concurrent_skiplist_set<Key, Compare>::size_type
+concurrent_skiplist_set<Key, Compare>::max_size() const noexcept {
+  return list->GetMaxSize();
+}
+
+template <typename Key, typename Compare>
+void concurrent_skiplist_set<Key, Compare>::clear() {
+  for (iterator it = begin(); it != end(); ++it) {
+    list->Erase(*it);
+  }
+}
+
+template <typename Key, typename Compare>
+std::pair<typename concurrent_skiplist_set<Key, Compare>::iterator, bool>
+concurrent_skiplist_set<Key, Compare>::insert(const value_type &value) {
+  return list->Insert(value);
+}
+
+template <typename Key, typename Compare>
+void concurrent_skiplist_set<Key, Compare>::erase(iterator pos) {
+  list->Erase(*pos);
+}
+
+template <typename Key, typename Compare>
+typename concurrent_skiplist_set<Key, Compare>::size_type
+concurrent_skiplist_set<Key, Compare>::erase(const key_type &key) {
+  return list->Erase(key) ? 1 : 0;
+}
+
+template <typename Key, typename Compare>
+typename concurrent_skiplist_set<Key, Compare>::iterator
+concurrent_skiplist_set<Key, Compare>::find(const key_type &key) const {
+  return list->Find(key);
+}
+
+template <typename Key, typename Compare>
+bool concurrent_skiplist_set<Key, Compare>::contains(
+    const key_type &key) const {
+  return list->Contains(key);
+}
+
+template <typename Key, typename Compare>
+typename concurrent_skiplist_set<Key, Compare>::key_compare
+concurrent_skiplist_set<Key, Compare>::key_comp() const {
+  return list->GetComparator();
+}
+
+}  // namespace RBtreeMapSet
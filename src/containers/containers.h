@@ -1,7 +1,27 @@
 #ifndef CONTAINERS_CONTAINERS_H_
 #define CONTAINERS_CONTAINERS_H_
 
+#include "cached_map.h"
+#include "cached_set.h"
+#include "concurrent_skiplist_map.h"
+#include "concurrent_skiplist_set.h"
+#include "diff.h"
+#include "hashed_map.h"
+#include "hashed_set.h"
+#include "int_set.h"
+#include "interval_map.h"
+#include "interval_set.h"
 #include "map.h"
+#include "mapped_map.h"
+#include "mapped_set.h"
+#include "parallel.h"
 #include "set.h"
+#include "small_map.h"
+#include "small_set.h"
+#include "static_map.h"
+#include "static_set.h"
+#include "string_map.h"
+#include "string_set.h"
+#include "ttl_map.h"
 
-#endif  // CONTAINERS_CONTAINERS_H_
\ No newline at end of file
+#endif  // CONTAINERS_CONTAINERS_H_
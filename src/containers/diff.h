@@ -0,0 +1,21 @@
+#ifndef CONTAINERS_DIFF_H_
+#define CONTAINERS_DIFF_H_
+
+namespace RBtreeMapSet {
+
+// Reports how to get from a to b, two maps or sets ordered by the same
+// comparator. Both are walked once, side by side in key order, in
+// O(a.size() + b.size()) and without allocating. For every key the visitor
+// gets one call, in key order:
+//   visitor.added(value_b)             key only in b,
+//   visitor.removed(value_a)           key only in a,
+//   visitor.changed(value_a, value_b)  map only: key in both, mapped values
+//                                      differ (compared with ==).
+// Keys with equal values in both containers are skipped.
+template <typename Container, typename Visitor>
+void diff(const Container &a, const Container &b, Visitor &&visitor);
+
+}  // namespace RBtreeMapSet
+
+#include "diff.tpp"
+#endif  // CONTAINERS_DIFF_H_
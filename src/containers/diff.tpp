@@ -0,0 +1,64 @@
+#include <type_traits>
+
+#include "diff.h"
+#include "red_black_tree/compare_traits.h"
+
+namespace RBtreeMapSet {
+
+template <typename Container>
+inline constexpr bool kIsSetLike = std::is_same_v<
+    typename Container::key_type, typename Container::value_type>;
+
+template <typename Container>
+const typename Container::key_type &DiffKey(
+    const typename Container::value_type &value) {
+  if constexpr (kIsSetLike<Container>) {
+    return value;
+  } else {
+    return value.first;
+  }
+}
+
+template <typename Container, typename Visitor>
+void diff(const Container &a, const Container &b, Visitor &&visitor) {
+  if (&a == &b) {
+    return;
+  }
+
+  using compare_traits = CompareTraits<typename Container::key_compare,
+                                        typename Container::key_type>;
+  typename Container::key_compare cmp = a.key_comp();
+  auto it_a = a.begin();
+  auto it_b = b.begin();
+
+  while (it_a != a.end() && it_b != b.end()) {
+    const auto &key_a = DiffKey<Container>(*it_a);
+    const auto &key_b = DiffKey<Container>(*it_b);
+
+    int order = compare_traits::ThreeWay(cmp, key_a, key_b);
+    if (order < 0) {
+      visitor.removed(*it_a);
+      ++it_a;
+    } else if (order > 0) {
+      visitor.added(*it_b);
+      ++it_b;
+    } else {
+      if constexpr (!kIsSetLike<Container>) {
+        if (!((*it_a).second == (*it_b).second)) {
+          visitor.changed(*it_a, *it_b);
+        }
+      }
+      ++it_a;
+      ++it_b;
+    }
+  }
+
+  for (; it_a != a.end(); ++it_a) {
+    visitor.removed(*it_a);
+  }
+  for (; it_b != b.end(); ++it_b) {
+    visitor.added(*it_b);
+  }
+}
+
+}  // namespace RBtreeMapSet
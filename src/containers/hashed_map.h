@@ -0,0 +1,19 @@
+#ifndef CONTAINERS_HASHED_MAP_H_
+#define CONTAINERS_HASHED_MAP_H_
+
+#include "map.h"
+#include "red_black_tree/hash_lookup.h"
+
+namespace RBtreeMapSet {
+
+// map with a hash index over its keys: find, contains, at and operator[] of
+// an existing key take O(1) expected time, while iteration, lower_bound and
+// the other ordered operations still use the tree. The index adds 32 to 64
+// bytes per element, see HashLookup.
+template <typename Key, typename T, typename Hash = std::hash<Key>,
+          typename Compare = std::less<Key>>
+using hashed_map = map<Key, T, Compare, HashLookup<Hash>>;
+
+}  // namespace RBtreeMapSet
+
+#endif  // CONTAINERS_HASHED_MAP_H_
@@ -0,0 +1,16 @@
+#ifndef CONTAINERS_HASHED_SET_H_
+#define CONTAINERS_HASHED_SET_H_
+
+#include "red_black_tree/hash_lookup.h"
+#include "set.h"
+
+namespace RBtreeMapSet {
+
+// set with a hash index over its keys, see hashed_map.
+template <typename Key, typename Hash = std::hash<Key>,
+          typename Compare = std::less<Key>>
+using hashed_set = set<Key, Compare, HashLookup<Hash>>;
+
+}  // namespace RBtreeMapSet
+
+#endif  // CONTAINERS_HASHED_SET_H_
@@ -0,0 +1,184 @@
+#ifndef CONTAINERS_INT_SET_H_
+#define CONTAINERS_INT_SET_H_
+
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "map.h"
+#include "roaring/roaring_container.h"
+
+namespace RBtreeMapSet {
+
+// set of unsigned integers compressed as in Roaring bitmaps. Keys are split
+// into their high bits, which select a chunk, and their low 16 bits, which
+// the chunk stores in a RoaringContainer: a sorted array while it is sparse,
+// a 8 KiB bitmap once it holds more than 4096 keys, or a list of runs after
+// optimize() if the keys are clustered. Dense sets of IDs take a few bits
+// per key instead of a tree node each, size() is kept up to date, and the
+// set operators combine whole chunks, 64 keys per word when a bitmap is
+// involved.
+//
+// The chunks are kept in a map keyed by the high bits, as Roaring64 does for
+// 64-bit keys, so a key that opens or empties a chunk costs O(log c) for c
+// chunks rather than shifting every chunk after it. Inserting n keys spread
+// over n distinct high parts is O(n log n); the set operators walk both
+// chunk lists in order and cost O(c log c) on top of the container work.
+//
+// Keys are values, not nodes: *it refers into the iterator, and insert and
+// erase invalidate all iterators, and so does swap.
+template <typename T>
+class int_set {
+  static_assert(std::is_integral_v<T> && std::is_unsigned_v<T> &&
+                    sizeof(T) >= sizeof(std::uint32_t),
+                "int_set keys must be unsigned integers of 32 or 64 bits");
+
+ private:
+  struct Iterator;
+
+ public:
+  using key_type = T;
+  using value_type = T;
+  using reference = const value_type &;
+  using const_reference = const value_type &;
+
+  using iterator = Iterator;
+  using const_iterator = Iterator;
+  using size_type = std::size_t;
+
+  int_set() = default;
+  int_set(std::initializer_list<value_type> const &items);
+
+  iterator begin() const noexcept;
+  iterator end() const noexcept;
+
+  bool empty() const noexcept;
+  size_type size() const noexcept;
+  size_type max_size() const noexcept;
+
+  void clear() noexcept;
+  std::pair<iterator, bool> insert(value_type key);
+  void erase(iterator pos);
+  size_type erase(value_type key);
+  void swap(int_set &other) noexcept;
+  // Moves the keys of other that are not in this set here, like
+  // std::set::merge; other keeps the keys both sets had.
+  void merge(int_set &other);
+
+  iterator find(value_type key) const;
+  iterator lower_bound(value_type key) const;
+  bool contains(value_type key) const;
+
+  int_set &operator|=(const int_set &other);
+  int_set &operator&=(const int_set &other);
+  int_set &operator-=(const int_set &other);
+
+  // Stores the chunks whose keys form long runs as runs, and releases spare
+  // capacity of the chunks. Worth calling once a set is built.
+  void optimize();
+  // Bytes allocated for the keys, not counting the set object itself.
+  size_type memory_usage() const noexcept;
+
+  bool operator==(const int_set &other) const;
+
+ private:
+  using chunk_map = map<T, RoaringContainer>;
+  using chunk_iterator = typename chunk_map::const_iterator;
+
+  static constexpr T High(value_type key) noexcept { return key >> 16; }
+
+  static constexpr std::uint16_t Low(value_type key) noexcept {
+    return static_cast<std::uint16_t>(key);
+  }
+
+  chunk_iterator LowerChunk(T high) const;
+
+  struct Iterator {
+    using iterator_category = std::bidirectional_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = T;
+    using reference = const T &;
+    using pointer = const T *;
+
+    Iterator() = delete;
+
+    Iterator(const chunk_map *chunks, chunk_iterator chunk,
+             RoaringContainer::Position position) noexcept
+        : chunks_(chunks), chunk_(chunk), position_(position) {
+      Load();
+    }
+
+    reference operator*() const noexcept { return value_; }
+
+    pointer operator->() const noexcept { return &value_; }
+
+    iterator &operator++() noexcept {
+      if (!(*chunk_).second.Next(position_)) {
+        ++chunk_;
+        position_ = chunk_ == chunks_->end() ? RoaringContainer::Position{0, 0}
+                                             : (*chunk_).second.Front();
+      }
+      Load();
+      return *this;
+    }
+
+    iterator operator++(int) noexcept {
+      iterator tmp{*this};
+      ++(*this);
+      return tmp;
+    }
+
+    iterator &operator--() noexcept {
+      if (chunk_ == chunks_->end() || !(*chunk_).second.Previous(position_)) {
+        --chunk_;
+        position_ = (*chunk_).second.Back();
+      }
+      Load();
+      return *this;
+    }
+
+    iterator operator--(int) noexcept {
+      iterator tmp{*this};
+      --(*this);
+      return tmp;
+    }
+
+    bool operator==(const iterator &other) const noexcept {
+      return chunk_ == other.chunk_ && position_.low == other.position_.low;
+    }
+
+    bool operator!=(const iterator &other) const noexcept {
+      return !(*this == other);
+    }
+
+    void Load() noexcept {
+      if (chunk_ != chunks_->end()) {
+        value_ = static_cast<T>((*chunk_).first << 16 | position_.low);
+      }
+    }
+
+    const chunk_map *chunks_;
+    chunk_iterator chunk_;
+    RoaringContainer::Position position_;
+    T value_ = 0;
+  };
+
+  chunk_map chunks;
+  size_type set_size = 0;
+};
+
+template <typename T>
+int_set<T> operator|(int_set<T> a, const int_set<T> &b);
+template <typename T>
+int_set<T> operator&(int_set<T> a, const int_set<T> &b);
+template <typename T>
+int_set<T> operator-(int_set<T> a, const int_set<T> &b);
+
+}  // namespace RBtreeMapSet
+
+#include "int_set.tpp"
+#endif  // CONTAINERS_INT_SET_H_
@@ -0,0 +1,316 @@
+#include <algorithm>
+
+#include "int_set.h"
+
+namespace RBtreeMapSet {
+
+template <typename T>
+int_set<T>::int_set(std::initializer_list<value_type> const &items) {
+  for (auto i : items) {
+    insert(i);
+  }
+}
+
+template <typename T>
+typename int_set<T>::iterator int_set<T>::begin() const noexcept {
+  if (chunks.empty()) {
+    return end();
+  }
+  return iterator(&chunks, chunks.begin(), chunks.front().second.Front());
+}
+
+template <typename T>
+typename int_set<T>::iterator int_set<T>::end() const noexcept {
+  return iterator(&chunks, chunks.end(), {0, 0});
+}
+
+template <typename T>
+bool int_set<T>::empty() const noexcept {
+  return set_size == 0;
+}
+
+template <typename T>
+typename int_set<T>::size_type int_set<T>::size() const noexcept {
+  return set_size;
+}
+
+template <typename T>
+typename int_set<T>::size_type int_set<T>::max_size() const noexcept {
+  if constexpr (sizeof(T) < sizeof(size_type)) {
+    return size_type{std::numeric_limits<T>::max()} + 1;
+  } else {
+    return std::numeric_limits<size_type>::max();
+  }
+}
+
+template <typename T>
+void int_set<T>::clear() noexcept {
+  chunks.clear();
+  set_size = 0;
+}
+
+template <typename T>
+std::pair<typename int_set<T>::iterator, bool> int_set<T>::insert(
+    value_type key) {
+  auto [chunk, new_chunk] = chunks.insert(High(key), RoaringContainer{});
+
+  bool inserted;
+  try {
+    inserted = (*chunk).second.Insert(Low(key));
+  } catch (...) {
+    if (new_chunk) {
+      chunks.erase(chunk);
+    }
+    throw;
+  }
+  set_size += inserted;
+
+  RoaringContainer::Position position;
+  (*chunk).second.LowerBound(Low(key), position);
+  return {iterator(&chunks, chunk, position), inserted};
+}
+
+template <typename T>
+void int_set<T>::erase(iterator pos) {
+  erase(*pos);
+}
+
+template <typename T>
+typename int_set<T>::size_type int_set<T>::erase(value_type key) {
+  auto chunk = chunks.find(High(key));
+  if (chunk == chunks.end() || !(*chunk).second.Erase(Low(key))) {
+    return 0;
+  }
+
+  if ((*chunk).second.IsEmpty()) {
+    chunks.erase(chunk);
+  }
+  --set_size;
+  return 1;
+}
+
+template <typename T>
+void int_set<T>::swap(int_set &other) noexcept {
+  chunks.swap(other.chunks);
+  std::swap(set_size, other.set_size);
+}
+
+template <typename T>
+void int_set<T>::merge(int_set &other) {
+  if (this == &other) {
+    return;
+  }
+
+  int_set common = *this & other;
+  *this |= other;
+  other = std::move(common);
+}
+
+template <typename T>
+typename int_set<T>::iterator int_set<T>::find(value_type key) const {
+  chunk_iterator chunk = chunks.find(High(key));
+  RoaringContainer::Position position;
+  if (chunk != chunks.end() &&
+      (*chunk).second.LowerBound(Low(key), position) &&
+      position.low == Low(key)) {
+    return iterator(&chunks, chunk, position);
+  }
+  return end();
+}
+
+template <typename T>
+typename int_set<T>::iterator int_set<T>::lower_bound(value_type key) const {
+  chunk_iterator chunk = LowerChunk(High(key));
+  if (chunk != chunks.end() && (*chunk).first == High(key)) {
+    RoaringContainer::Position position;
+    if ((*chunk).second.LowerBound(Low(key), position)) {
+      return iterator(&chunks, chunk, position);
+    }
+    ++chunk;
+  }
+
+  if (chunk == chunks.end()) {
+    return end();
+  }
+  return iterator(&chunks, chunk, (*chunk).second.Front());
+}
+
+template <typename T>
+bool int_set<T>::contains(value_type key) const {
+  chunk_iterator chunk = chunks.find(High(key));
+  return chunk != chunks.end() && (*chunk).second.Contains(Low(key));
+}
+
+// Builds every chunk the result gets from other and adds an empty chunk for
+// each new high part first, so that this set is left as it was if that
+// throws, then moves the results into place.
+template <typename T>
+int_set<T> &int_set<T>::operator|=(const int_set &other) {
+  if (this == &other) {
+    return *this;
+  }
+
+  std::vector<RoaringContainer> incoming;
+  incoming.reserve(other.chunks.size());
+  chunk_iterator it = chunks.begin();
+  for (const auto &[high, container] : other.chunks) {
+    while (it != chunks.end() && (*it).first < high) {
+      ++it;
+    }
+    if (it != chunks.end() && (*it).first == high) {
+      incoming.push_back(RoaringContainer::Union((*it).second, container));
+    } else {
+      incoming.push_back(container);
+    }
+  }
+
+  std::vector<typename chunk_map::iterator> slots;
+  slots.reserve(incoming.size());
+  try {
+    for (const auto &item : other.chunks) {
+      slots.push_back(chunks.insert(item.first, RoaringContainer{}).first);
+    }
+  } catch (...) {
+    for (auto slot : slots) {
+      if ((*slot).second.IsEmpty()) {
+        chunks.erase(slot);
+      }
+    }
+    throw;
+  }
+
+  for (size_type i = 0; i < slots.size(); ++i) {
+    set_size += incoming[i].GetCardinality();
+    set_size -= (*slots[i]).second.GetCardinality();
+    (*slots[i]).second = std::move(incoming[i]);
+  }
+  return *this;
+}
+
+template <typename T>
+int_set<T> &int_set<T>::operator&=(const int_set &other) {
+  if (this == &other) {
+    return *this;
+  }
+
+  chunk_map common;
+  size_type size = 0;
+  chunk_iterator it = other.chunks.begin();
+  for (const auto &[high, container] : chunks) {
+    while (it != other.chunks.end() && (*it).first < high) {
+      ++it;
+    }
+    if (it == other.chunks.end()) {
+      break;
+    }
+    if ((*it).first == high) {
+      RoaringContainer result =
+          RoaringContainer::Intersection(container, (*it).second);
+      if (!result.IsEmpty()) {
+        size += result.GetCardinality();
+        (*common.insert(common.end(), {high, RoaringContainer{}})).second =
+            std::move(result);
+      }
+    }
+  }
+
+  chunks = std::move(common);
+  set_size = size;
+  return *this;
+}
+
+template <typename T>
+int_set<T> &int_set<T>::operator-=(const int_set &other) {
+  if (this == &other) {
+    clear();
+    return *this;
+  }
+
+  std::vector<std::pair<typename chunk_map::iterator, RoaringContainer>> rest;
+  chunk_iterator it = other.chunks.begin();
+  for (auto chunk = chunks.begin(); chunk != chunks.end(); ++chunk) {
+    while (it != other.chunks.end() && (*it).first < (*chunk).first) {
+      ++it;
+    }
+    if (it == other.chunks.end()) {
+      break;
+    }
+    if ((*it).first == (*chunk).first) {
+      rest.emplace_back(chunk, RoaringContainer::Difference((*chunk).second,
+                                                            (*it).second));
+    }
+  }
+
+  for (auto &[chunk, container] : rest) {
+    set_size -= (*chunk).second.GetCardinality() - container.GetCardinality();
+    if (container.IsEmpty()) {
+      chunks.erase(chunk);
+    } else {
+      (*chunk).second = std::move(container);
+    }
+  }
+  return *this;
+}
+
+template <typename T>
+void int_set<T>::optimize() {
+  for (auto &chunk : chunks) {
+    chunk.second.Optimize();
+  }
+}
+
+// A chunk costs a tree node: the key and container plus three links and
+// the color, rounded up here to four pointers.
+template <typename T>
+typename int_set<T>::size_type int_set<T>::memory_usage() const noexcept {
+  size_type bytes = chunks.size() * (sizeof(typename chunk_map::value_type) +
+                                     4 * sizeof(void *));
+  for (const auto &chunk : chunks) {
+    bytes += chunk.second.GetMemoryUsage();
+  }
+  return bytes;
+}
+
+template <typename T>
+bool int_set<T>::operator==(const int_set &other) const {
+  if (this == &other) return true;
+
+  if (size() != other.size() || chunks.size() != other.chunks.size()) {
+    return false;
+  }
+
+  for (chunk_iterator a = chunks.begin(), b = other.chunks.begin();
+       a != chunks.end(); ++a, ++b) {
+    if ((*a).first != (*b).first || !((*a).second == (*b).second)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// map has no const lower_bound; looking up does not modify the tree.
+template <typename T>
+typename int_set<T>::chunk_iterator int_set<T>::LowerChunk(T high) const {
+  return const_cast<chunk_map &>(chunks).lower_bound(high);
+}
+
+template <typename T>
+int_set<T> operator|(int_set<T> a, const int_set<T> &b) {
+  a |= b;
+  return a;
+}
+
+template <typename T>
+int_set<T> operator&(int_set<T> a, const int_set<T> &b) {
+  a &= b;
+  return a;
+}
+
+template <typename T>
+int_set<T> operator-(int_set<T> a, const int_set<T> &b) {
+  a -= b;
+  return a;
+}
+
+}  // namespace RBtreeMapSet
@@ -0,0 +1,91 @@
+#ifndef CONTAINERS_INTERVAL_MAP_H_
+#define CONTAINERS_INTERVAL_MAP_H_
+
+#include <initializer_list>
+#include <stdexcept>
+#include <vector>
+
+#include "interval_tree/interval.h"
+#include "red_black_tree/red_black_tree.h"
+
+namespace RBtreeMapSet {
+
+// map from half-open intervals to values that also answers which intervals
+// overlap a point or a range, see interval_set.
+template <typename T, typename V>
+class interval_map {
+ public:
+  using interval_type = Interval<T>;
+  using key_type = interval_type;
+  using mapped_type = V;
+  using value_type = std::pair<const key_type, mapped_type>;
+  using reference = value_type &;
+  using const_reference = const value_type &;
+  using key_compare = std::less<key_type>;
+
+  struct ValueLess {
+    bool operator()(const_reference value_1, const_reference value_2) const {
+      return value_1.first < value_2.first;
+    }
+  };
+
+  using tree_type =
+      RedBlackTree<value_type, ValueLess, TreeLookup, IntervalAugment<T>>;
+  using iterator = typename tree_type::iterator;
+  using const_iterator = typename tree_type::const_iterator;
+  using size_type = std::size_t;
+
+  interval_map();
+  interval_map(std::initializer_list<value_type> const &items);
+  interval_map(const interval_map &other);
+  interval_map(interval_map &&other) noexcept;
+  ~interval_map();
+
+  interval_map &operator=(const interval_map &other);
+  interval_map &operator=(interval_map &&other) noexcept;
+
+  mapped_type &at(const key_type &key);
+  const mapped_type &at(const key_type &key) const;
+  mapped_type &operator[](const key_type &key);
+
+  iterator begin() noexcept;
+  const_iterator begin() const noexcept;
+  iterator end() noexcept;
+  const_iterator end() const noexcept;
+
+  bool empty() const noexcept;
+  size_type size() const noexcept;
+  size_type max_size() const noexcept;
+
+  void clear() noexcept;
+  std::pair<iterator, bool> insert(const value_type &value);
+  std::pair<iterator, bool> insert(const key_type &key, const mapped_type &obj);
+  std::pair<iterator, bool> insert_or_assign(const key_type &key,
+                                             const mapped_type &obj);
+  void erase(iterator pos);
+  void swap(interval_map &other) noexcept;
+  void compact(NodeLayout layout = NodeLayout::kVanEmdeBoas);
+
+  iterator find(const key_type &key);
+  const_iterator find(const key_type &key) const;
+  bool contains(const key_type &key) const;
+
+  // Elements whose interval contains point, or shares a point with
+  // [lo, hi), in order. for_each_overlapping passes each of them to fn.
+  std::vector<iterator> overlapping(const T &point);
+  std::vector<iterator> overlapping(const T &lo, const T &hi);
+  template <typename Fn>
+  void for_each_overlapping(const T &point, Fn fn) const;
+  template <typename Fn>
+  void for_each_overlapping(const T &lo, const T &hi, Fn fn) const;
+
+  bool operator==(const interval_map &other) const;
+
+ private:
+  tree_type *tree;
+};
+
+}  // namespace RBtreeMapSet
+
+#include "interval_map.tpp"
+#endif  // CONTAINERS_INTERVAL_MAP_H_
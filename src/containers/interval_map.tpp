@@ -0,0 +1,219 @@
+#include "interval_map.h"
+
+namespace RBtreeMapSet {
+
+template <typename T, typename V>
+interval_map<T, V>::interval_map() : tree(new tree_type{}) {}
+
+template <typename T, typename V>
+interval_map<T, V>::interval_map(
+    std::initializer_list<value_type> const &items)
+    : interval_map() {
+  for (auto i : items) {
+    insert(i);
+  }
+}
+
+template <typename T, typename V>
+interval_map<T, V>::interval_map(const interval_map &other)
+    : tree(new tree_type(*other.tree)) {}
+
+template <typename T, typename V>
+interval_map<T, V>::interval_map(interval_map &&other) noexcept
+    : tree(new tree_type(std::move(*other.tree))) {}
+
+template <typename T, typename V>
+interval_map<T, V>::~interval_map() {
+  delete tree;
+  tree = nullptr;
+}
+
+template <typename T, typename V>
+interval_map<T, V> &interval_map<T, V>::operator=(const interval_map &other) {
+  *tree = *other.tree;
+  return *this;
+}
+
+template <typename T, typename V>
+interval_map<T, V> &interval_map<T, V>::operator=(
+    interval_map &&other) noexcept {
+  *tree = std::move(*other.tree);
+  return *this;
+}
+
+template <typename T, typename V>
+typename interval_map<T, V>::mapped_type &interval_map<T, V>::at(
+    const key_type &key) {
+  iterator it = tree->Find({key, mapped_type{}});
+
+  if (it == end()) {
+    throw std::out_of_range("Element with the specified key not found");
+  }
+
+  return (*it).second;
+}
+
+template <typename T, typename V>
+const typename interval_map<T, V>::mapped_type &interval_map<T, V>::at(
+    const key_type &key) const {
+  return const_cast<interval_map<T, V> *>(this)->at(key);
+}
+
+template <typename T, typename V>
+typename interval_map<T, V>::mapped_type &interval_map<T, V>::operator[](
+    const key_type &key) {
+  return (*tree->Insert({key, mapped_type{}}).first).second;
+}
+
+template <typename T, typename V>
+typename interval_map<T, V>::iterator interval_map<T, V>::begin() noexcept {
+  return tree->Begin();
+}
+
+template <typename T, typename V>
+typename interval_map<T, V>::const_iterator interval_map<T, V>::begin()
+    const noexcept {
+  return tree->Begin();
+}
+
+template <typename T, typename V>
+typename interval_map<T, V>::iterator interval_map<T, V>::end() noexcept {
+  return tree->End();
+}
+
+template <typename T, typename V>
+typename interval_map<T, V>::const_iterator interval_map<T, V>::end()
+    const noexcept {
+  return tree->End();
+}
+
+template <typename T, typename V>
+bool interval_map<T, V>::empty() const noexcept {
+  return tree->isEmpty();
+}
+
+template <typename T, typename V>
+typename interval_map<T, V>::size_type interval_map<T, V>::size()
+    const noexcept {
+  return tree->GetSize();
+}
+
+template <typename T, typename V>
+typename interval_map<T, V>::size_type interval_map<T, V>::max_size()
+    const noexcept {
+  return tree->GetMaxSize();
+}
+
+template <typename T, typename V>
+void interval_map<T, V>::clear() noexcept {
+  tree->RemoveTree();
+}
+
+template <typename T, typename V>
+std::pair<typename interval_map<T, V>::iterator, bool>
+interval_map<T, V>::insert(const value_type &value) {
+  return tree->Insert(value);
+}
+
+template <typename T, typename V>
+std::pair<typename interval_map<T, V>::iterator, bool>
+interval_map<T, V>::insert(const key_type &key, const mapped_type &obj) {
+  return tree->Insert(value_type{key, obj});
+}
+
+template <typename T, typename V>
+std::pair<typename interval_map<T, V>::iterator, bool>
+interval_map<T, V>::insert_or_assign(const key_type &key,
+                                     const mapped_type &obj) {
+  std::pair<iterator, bool> res = tree->Insert(value_type{key, obj});
+
+  if (!res.second) {
+    (*res.first).second = obj;
+  }
+
+  return res;
+}
+
+template <typename T, typename V>
+void interval_map<T, V>::erase(iterator pos) {
+  tree->Erase(pos);
+}
+
+template <typename T, typename V>
+void interval_map<T, V>::swap(interval_map &other) noexcept {
+  tree->SwapTree(*other.tree);
+}
+
+template <typename T, typename V>
+void interval_map<T, V>::compact(NodeLayout layout) {
+  tree->Compact(layout);
+}
+
+template <typename T, typename V>
+typename interval_map<T, V>::iterator interval_map<T, V>::find(
+    const key_type &key) {
+  return tree->Find({key, mapped_type{}});
+}
+
+template <typename T, typename V>
+typename interval_map<T, V>::const_iterator interval_map<T, V>::find(
+    const key_type &key) const {
+  return tree->Find({key, mapped_type{}});
+}
+
+template <typename T, typename V>
+bool interval_map<T, V>::contains(const key_type &key) const {
+  return find(key) != end();
+}
+
+template <typename T, typename V>
+std::vector<typename interval_map<T, V>::iterator>
+interval_map<T, V>::overlapping(const T &point) {
+  std::vector<iterator> res;
+  SearchIntervals(*tree, point, [&res](iterator it) { res.push_back(it); });
+  return res;
+}
+
+template <typename T, typename V>
+std::vector<typename interval_map<T, V>::iterator>
+interval_map<T, V>::overlapping(const T &lo, const T &hi) {
+  std::vector<iterator> res;
+  SearchIntervals(*tree, lo, hi, [&res](iterator it) { res.push_back(it); });
+  return res;
+}
+
+template <typename T, typename V>
+template <typename Fn>
+void interval_map<T, V>::for_each_overlapping(const T &point, Fn fn) const {
+  SearchIntervals(*tree, point,
+                  [&fn](iterator it) { fn(std::as_const(*it)); });
+}
+
+template <typename T, typename V>
+template <typename Fn>
+void interval_map<T, V>::for_each_overlapping(const T &lo, const T &hi,
+                                              Fn fn) const {
+  SearchIntervals(*tree, lo, hi,
+                  [&fn](iterator it) { fn(std::as_const(*it)); });
+}
+
+template <typename T, typename V>
+bool interval_map<T, V>::operator==(const interval_map &other) const {
+  if (this == &other) return true;
+
+  if (size() != other.size()) return false;
+
+  auto it_1 = begin();
+  auto it_2 = other.begin();
+
+  while (it_1 != end()) {
+    if (*it_1 != *it_2) return false;
+
+    ++it_1;
+    ++it_2;
+  }
+
+  return true;
+}
+
+}  // namespace RBtreeMapSet
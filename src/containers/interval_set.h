@@ -0,0 +1,79 @@
+#ifndef CONTAINERS_INTERVAL_SET_H_
+#define CONTAINERS_INTERVAL_SET_H_
+
+#include <initializer_list>
+#include <vector>
+
+#include "interval_tree/interval.h"
+#include "red_black_tree/red_black_tree.h"
+
+namespace RBtreeMapSet {
+
+// set of half-open intervals that also answers which intervals overlap a
+// point or a range. The tree keeps the largest hi of every subtree (see
+// IntervalAugment), so a query skips the subtrees that end before the point
+// and stops at the first interval that starts after it: O(log n) to find the
+// first match and O(log n) at most for each further one.
+template <typename T>
+class interval_set {
+ public:
+  using interval_type = Interval<T>;
+  using key_type = interval_type;
+  using value_type = interval_type;
+  using reference = value_type &;
+  using const_reference = const value_type &;
+  using key_compare = std::less<key_type>;
+
+  using tree_type =
+      RedBlackTree<value_type, key_compare, TreeLookup, IntervalAugment<T>>;
+  using iterator = typename tree_type::iterator;
+  using const_iterator = typename tree_type::const_iterator;
+  using size_type = std::size_t;
+
+  interval_set();
+  interval_set(std::initializer_list<value_type> const &items);
+  interval_set(const interval_set &other);
+  interval_set(interval_set &&other) noexcept;
+  ~interval_set();
+
+  interval_set &operator=(const interval_set &other);
+  interval_set &operator=(interval_set &&other) noexcept;
+
+  iterator begin() noexcept;
+  const_iterator begin() const noexcept;
+  iterator end() noexcept;
+  const_iterator end() const noexcept;
+
+  bool empty() const noexcept;
+  size_type size() const noexcept;
+  size_type max_size() const noexcept;
+
+  void clear() noexcept;
+  std::pair<iterator, bool> insert(const value_type &value);
+  std::pair<iterator, bool> insert(const T &lo, const T &hi);
+  void erase(iterator pos);
+  void swap(interval_set &other) noexcept;
+  void compact(NodeLayout layout = NodeLayout::kVanEmdeBoas);
+
+  iterator find(const key_type &key) const;
+  bool contains(const key_type &key) const;
+
+  // Intervals that contain point, or that share a point with [lo, hi), in
+  // order. for_each_overlapping passes each of them to fn.
+  std::vector<iterator> overlapping(const T &point) const;
+  std::vector<iterator> overlapping(const T &lo, const T &hi) const;
+  template <typename Fn>
+  void for_each_overlapping(const T &point, Fn fn) const;
+  template <typename Fn>
+  void for_each_overlapping(const T &lo, const T &hi, Fn fn) const;
+
+  bool operator==(const interval_set &other) const;
+
+ private:
+  tree_type *tree;
+};
+
+}  // namespace RBtreeMapSet
+
+#include "interval_set.tpp"
+#endif  // CONTAINERS_INTERVAL_SET_H_
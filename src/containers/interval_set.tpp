@@ -0,0 +1,173 @@
+#include "interval_set.h"
+
+namespace RBtreeMapSet {
+
+template <typename T>
+interval_set<T>::interval_set() : tree(new tree_type{}) {}
+
+template <typename T>
+interval_set<T>::interval_set(std::initializer_list<value_type> const &items)
+    : interval_set() {
+  for (auto i : items) {
+    insert(i);
+  }
+}
+
+template <typename T>
+interval_set<T>::interval_set(const interval_set &other)
+    : tree(new tree_type(*other.tree)) {}
+
+template <typename T>
+interval_set<T>::interval_set(interval_set &&other) noexcept
+    : tree(new tree_type(std::move(*other.tree))) {}
+
+template <typename T>
+interval_set<T>::~interval_set() {
+  delete tree;
+  tree = nullptr;
+}
+
+template <typename T>
+interval_set<T> &interval_set<T>::operator=(const interval_set &other) {
+  *tree = *other.tree;
+  return *this;
+}
+
+template <typename T>
+interval_set<T> &interval_set<T>::operator=(interval_set &&other) noexcept {
+  *tree = std::move(*other.tree);
+  return *this;
+}
+
+template <typename T>
+typename interval_set<T>::iterator interval_set<T>::begin() noexcept {
+  return tree->Begin();
+}
+
+template <typename T>
+typename interval_set<T>::const_iterator interval_set<T>::begin()
+    const noexcept {
+  return tree->Begin();
+}
+
+template <typename T>
+typename interval_set<T>::iterator interval_set<T>::end() noexcept {
+  return tree->End();
+}
+
+template <typename T>
+typename interval_set<T>::const_iterator interval_set<T>::end()
+    const noexcept {
+  return tree->End();
+}
+
+template <typename T>
+bool interval_set<T>::empty() const noexcept {
+  return tree->isEmpty();
+}
+
+template <typename T>
+typename interval_set<T>::size_type interval_set<T>::size() const noexcept {
+  return tree->GetSize();
+}
+
+template <typename T>
+typename interval_set<T>::size_type interval_set<T>::max_size()
+    const noexcept {
+  return tree->GetMaxSize();
+}
+
+template <typename T>
+void interval_set<T>::clear() noexcept {
+  tree->RemoveTree();
+}
+
+template <typename T>
+std::pair<typename interval_set<T>::iterator, bool> interval_set<T>::insert(
+    const value_type &value) {
+  return tree->Insert(value);
+}
+
+template <typename T>
+std::pair<typename interval_set<T>::iterator, bool> interval_set<T>::insert(
+    const T &lo, const T &hi) {
+  return tree->Insert(value_type{lo, hi});
+}
+
+template <typename T>
+void interval_set<T>::erase(iterator pos) {
+  tree->Erase(pos);
+}
+
+template <typename T>
+void interval_set<T>::swap(interval_set &other) noexcept {
+  tree->SwapTree(*other.tree);
+}
+
+template <typename T>
+void interval_set<T>::compact(NodeLayout layout) {
+  tree->Compact(layout);
+}
+
+template <typename T>
+typename interval_set<T>::iterator interval_set<T>::find(
+    const key_type &key) const {
+  return tree->Find(key);
+}
+
+template <typename T>
+bool interval_set<T>::contains(const key_type &key) const {
+  return tree->Find(key) != end();
+}
+
+template <typename T>
+std::vector<typename interval_set<T>::iterator> interval_set<T>::overlapping(
+    const T &point) const {
+  std::vector<iterator> res;
+  SearchIntervals(*tree, point, [&res](iterator it) { res.push_back(it); });
+  return res;
+}
+
+template <typename T>
+std::vector<typename interval_set<T>::iterator> interval_set<T>::overlapping(
+    const T &lo, const T &hi) const {
+  std::vector<iterator> res;
+  SearchIntervals(*tree, lo, hi, [&res](iterator it) { res.push_back(it); });
+  return res;
+}
+
+template <typename T>
+template <typename Fn>
+void interval_set<T>::for_each_overlapping(const T &point, Fn fn) const {
+  SearchIntervals(*tree, point,
+                  [&fn](iterator it) { fn(std::as_const(*it)); });
+}
+
+template <typename T>
+template <typename Fn>
+void interval_set<T>::for_each_overlapping(const T &lo, const T &hi,
+                                           Fn fn) const {
+  SearchIntervals(*tree, lo, hi,
+                  [&fn](iterator it) { fn(std::as_const(*it)); });
+}
+
+template <typename T>
+bool interval_set<T>::operator==(const interval_set &other) const {
+  if (this == &other) return true;
+
+  if (size() != other.size()) return false;
+
+  auto it_1 = begin();
+  auto it_2 = other.begin();
+
+  while (it_1 != end()) {
+    if (*it_1 != *it_2) return false;
+
+    ++it_1;
+    ++it_2;
+  }
+
+  return true;
+}
+
+}  // namespace RBtreeMapSet
@@ -0,0 +1,106 @@
+#ifndef CONTAINERS_INTERVAL_TREE_INTERVAL_H_
+#define CONTAINERS_INTERVAL_TREE_INTERVAL_H_
+
+#include <utility>
+
+namespace RBtreeMapSet {
+
+// Half-open interval [lo, hi) of a type ordered by operator<. Intervals are
+// ordered by lo, then by hi. An interval with !(lo < hi) is empty and
+// overlaps nothing.
+template <typename T>
+struct Interval {
+  T lo;
+  T hi;
+
+  bool Contains(const T &point) const { return !(point < lo) && point < hi; }
+
+  bool Overlaps(const T &other_lo, const T &other_hi) const {
+    return lo < hi && other_lo < other_hi && lo < other_hi && other_lo < hi;
+  }
+
+  friend bool operator<(const Interval &a, const Interval &b) {
+    return a.lo < b.lo || (!(b.lo < a.lo) && a.hi < b.hi);
+  }
+
+  friend bool operator==(const Interval &a, const Interval &b) {
+    return !(a < b) && !(b < a);
+  }
+
+  friend bool operator!=(const Interval &a, const Interval &b) {
+    return !(a == b);
+  }
+};
+
+// Interval of a tree key: the key itself for interval_set, the first member
+// of the (interval, value) pair for interval_map.
+template <typename T>
+const Interval<T> &IntervalOf(const Interval<T> &key) noexcept {
+  return key;
+}
+
+template <typename T, typename V>
+const Interval<T> &IntervalOf(
+    const std::pair<const Interval<T>, V> &key) noexcept {
+  return key.first;
+}
+
+// Augment policy of the interval containers, see
+// red_black_tree/augment.h. Every node keeps the largest hi in its subtree,
+// so a subtree whose max_hi is not above a point holds no interval that
+// reaches it. Copies of T must not throw.
+template <typename T>
+struct IntervalAugment {
+  static constexpr bool kEnabled = true;
+
+  template <typename Key>
+  struct Data {
+    T max_hi{};
+  };
+
+  template <typename Node>
+  static void Update(Node *node) noexcept {
+    node->max_hi = IntervalOf(node->key).hi;
+    if (node->left && node->max_hi < node->left->max_hi) {
+      node->max_hi = node->left->max_hi;
+    }
+    if (node->right && node->max_hi < node->right->max_hi) {
+      node->max_hi = node->right->max_hi;
+    }
+  }
+};
+
+// Passes to visit the iterators of the intervals in tree that contain point,
+// in order.
+template <typename Tree, typename T, typename Visit>
+void SearchIntervals(Tree &tree, const T &point, Visit visit) {
+  tree.SearchAugmented(
+      [&point](const auto &node) { return point < node.max_hi; },
+      [&point](const auto &key) { return point < IntervalOf(key).lo; },
+      [&point, &visit](auto it) {
+        if (IntervalOf(*it).Contains(point)) {
+          visit(it);
+        }
+      });
+}
+
+// Same for the intervals that share a point with [lo, hi).
+template <typename Tree, typename T, typename Visit>
+void SearchIntervals(Tree &tree, const T &lo, const T &hi, Visit visit) {
+  if (!(lo < hi)) {
+    return;
+  }
+
+  tree.SearchAugmented(
+      [&lo](const auto &node) { return lo < node.max_hi; },
+      [&hi](const auto &key) { return !(IntervalOf(key).lo < hi); },
+      [&lo, &hi, &visit](auto it) {
+        if (IntervalOf(*it).Overlaps(lo, hi)) {
+          visit(it);
+        }
+      });
+}
+
+}  // namespace RBtreeMapSet
+
+#endif  // CONTAINERS_INTERVAL_TREE_INTERVAL_H_
@@ -1,13 +1,20 @@
 #ifndef CONTAINERS_MAP_MAP_H_
 #define CONTAINERS_MAP_MAP_H_
 
+#include <istream>
+#include <ostream>
 #include <stdexcept>
 
+#include "red_black_tree/map_compare.h"
 #include "red_black_tree/red_black_tree.h"
+#include "serialization.h"
 
 namespace RBtreeMapSet {
 
-template <typename Key, typename T>
+// Lookup selects a side index for exact lookups, see
+// red_black_tree/tree_lookup.h.
+template <typename Key, typename T, typename Compare = std::less<Key>,
+          typename Lookup = TreeLookup>
 class map {
  public:
   using key_type = Key;
@@ -15,20 +22,18 @@ class map {
   using value_type = std::pair<const key_type, mapped_type>;
   using reference = value_type &;
   using const_reference = const value_type &;
+  using key_compare = Compare;
 
-  struct MapCompare {
-    bool operator()(const_reference value_1,
-                    const_reference value_2) const noexcept {
-      return value_1.first < value_2.first;
-    }
-  };
+  using MapCompare = MapKeyCompare<key_type, mapped_type, key_compare>;
 
-  using tree_type = RedBlackTree<value_type, MapCompare>;
+  using tree_type = RedBlackTree<value_type, MapCompare, Lookup>;
   using iterator = typename tree_type::iterator;
   using const_iterator = typename tree_type::const_iterator;
   using size_type = std::size_t;
+  using batch_op = BatchOp<value_type>;
 
   map();
+  explicit map(const key_compare &comp);
   map(std::initializer_list<value_type> const &items);
   map(const map &other);
   map(map &&other) noexcept;
@@ -50,9 +55,23 @@ class map {
   size_type size() const noexcept;
   size_type max_size() const noexcept;
 
+  // Elements with the smallest and largest keys in O(1), and their removal
+  // in amortized O(1): the new extreme is the neighbour of the removed one,
+  // so no search from the root is needed. All of them throw
+  // std::out_of_range if the container is empty.
+  reference front();
+  const_reference front() const;
+  reference back();
+  const_reference back() const;
+  void pop_front();
+  void pop_back();
+  value_type extract_min();
+  value_type extract_max();
+
   void clear() noexcept;
   std::pair<iterator, bool> insert(const value_type &value);
   std::pair<iterator, bool> insert(const key_type &key, const mapped_type &obj);
+  iterator insert(const_iterator hint, const value_type &value);
   std::pair<iterator, bool> insert_or_assign(const key_type &key,
                                              const mapped_type &obj);
   template <typename... Args>
@@ -60,13 +79,49 @@ class map {
   void erase(iterator pos);
   void swap(map &other) noexcept;
   void merge(map &other);
-
+  // Applies the batch_op range in order. Sort it by key: only a sorted batch
+  // is walked in one pass or merged with the tree; an unsorted one still
+  // gives the right result but searches once per operation.
+  template <typename ForwardIt>
+  std::vector<bool> apply_batch(ForwardIt first, ForwardIt last);
+  void compact(NodeLayout layout = NodeLayout::kVanEmdeBoas);
+
+  iterator find(const key_type &key);
+  const_iterator find(const key_type &key) const;
+  iterator find(const key_type &key, const_iterator hint);
+  iterator lower_bound(const key_type &key);
+  iterator lower_bound(const key_type &key, const_iterator hint);
   bool contains(const key_type &key) const;
 
+  // Lookups and insertions that take a hint search outward from it, in
+  // O(log d) for a key d positions away. In finger mode the container
+  // remembers the last node reached and uses it as the hint for find,
+  // contains, lower_bound and insert; lookups then modify that state, so
+  // const lookups on the same container must not run concurrently.
+  void set_finger_mode(bool enabled) noexcept;
+
+  // Bytes held by the lookup index in addition to the tree nodes.
+  size_type index_memory_usage() const noexcept;
+
+  key_compare key_comp() const;
+
+  // Boundaries that cut the elements (or those in [lo, hi)) into at most
+  // parts consecutive ranges of similar size, taken from the subtrees near
+  // the root. Range i is [res[i], res[i + 1]).
+  std::vector<iterator> split(size_type parts);
+  std::vector<const_iterator> split(size_type parts) const;
+  std::vector<iterator> split(size_type parts, const key_type &lo,
+                              const key_type &hi);
+  std::vector<const_iterator> split(size_type parts, const key_type &lo,
+                                    const key_type &hi) const;
+
+  void save(std::ostream &os) const;
+  void load(std::istream &is);
+
   bool operator==(const map &other) const;
 
  private:
-  RedBlackTree<value_type, MapCompare> *tree;
+  tree_type *tree;
 };
 
 }  // namespace RBtreeMapSet
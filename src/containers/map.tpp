@@ -2,43 +2,53 @@
 
 namespace RBtreeMapSet {
 
-template <typename Key, typename T>
-map<Key, T>::map() : tree(new tree_type{}) {}
+template <typename Key, typename T, typename Compare, typename Lookup>
+map<Key, T, Compare, Lookup>::map() : tree(new tree_type{}) {}
 
-template <typename Key, typename T>
-map<Key, T>::map(std::initializer_list<value_type> const &items) : map() {
+template <typename Key, typename T, typename Compare, typename Lookup>
+map<Key, T, Compare, Lookup>::map(const key_compare &comp)
+    : tree(new tree_type(MapCompare{comp})) {}
+
+template <typename Key, typename T, typename Compare, typename Lookup>
+map<Key, T, Compare, Lookup>::map(
+    std::initializer_list<value_type> const &items)
+    : map() {
   for (auto i : items) {
     insert(i);
   }
 }
 
-template <typename Key, typename T>
-map<Key, T>::map(const map &other) : tree(new tree_type(*other.tree)) {}
+template <typename Key, typename T, typename Compare, typename Lookup>
+map<Key, T, Compare, Lookup>::map(const map &other)
+    : tree(new tree_type(*other.tree)) {}
 
-template <typename Key, typename T>
-map<Key, T>::map(map &&other) noexcept
+template <typename Key, typename T, typename Compare, typename Lookup>
+map<Key, T, Compare, Lookup>::map(map &&other) noexcept
     : tree(new tree_type(std::move(*other.tree))) {}
 
-template <typename Key, typename T>
-map<Key, T>::~map() {
+template <typename Key, typename T, typename Compare, typename Lookup>
+map<Key, T, Compare, Lookup>::~map() {
   delete tree;
   tree = nullptr;
 }
 
-template <typename Key, typename T>
-map<Key, T> &map<Key, T>::operator=(const map &other) {
+template <typename Key, typename T, typename Compare, typename Lookup>
+map<Key, T, Compare, Lookup> &map<Key, T, Compare, Lookup>::operator=(
+    const map &other) {
   *tree = *other.tree;
   return *this;
 }
 
-template <typename Key, typename T>
-map<Key, T> &map<Key, T>::operator=(map &&other) noexcept {
+template <typename Key, typename T, typename Compare, typename Lookup>
+map<Key, T, Compare, Lookup> &map<Key, T, Compare, Lookup>::operator=(
+    map &&other) noexcept {
   *tree = std::move(*other.tree);
   return *this;
 }
 
-template <typename Key, typename T>
-typename map<Key, T>::mapped_type &map<Key, T>::at(const key_type &key) {
+template <typename Key, typename T, typename Compare, typename Lookup>
+typename map<Key, T, Compare, Lookup>::mapped_type &
+map<Key, T, Compare, Lookup>::at(const key_type &key) {
   iterator it = tree->Find({key, mapped_type{}});
 
   if (it == end()) {
@@ -48,15 +58,15 @@ typename map<Key, T>::mapped_type &map<Key, T>::at(const key_type &key) {
   return (*it).second;
 }
 
-template <typename Key, typename T>
-const typename map<Key, T>::mapped_type &map<Key, T>::at(
-    const key_type &key) const {
-  return const_cast<map<Key, T> *>(this)->at(key);
+template <typename Key, typename T, typename Compare, typename Lookup>
+const typename map<Key, T, Compare, Lookup>::mapped_type &
+map<Key, T, Compare, Lookup>::at(const key_type &key) const {
+  return const_cast<map<Key, T, Compare, Lookup> *>(this)->at(key);
 }
 
-template <typename Key, typename T>
-typename map<Key, T>::mapped_type &map<Key, T>::operator[](
-    const key_type &key) {
+template <typename Key, typename T, typename Compare, typename Lookup>
+typename map<Key, T, Compare, Lookup>::mapped_type &
+map<Key, T, Compare, Lookup>::operator[](const key_type &key) {
   iterator it_search = tree->Find({key, mapped_type{}});
 
   if (it_search == end()) {
@@ -67,61 +77,146 @@ typename map<Key, T>::mapped_type &map<Key, T>::operator[](
   }
 }
 
-template <typename Key, typename T>
-typename map<Key, T>::iterator map<Key, T>::begin() noexcept {
+template <typename Key, typename T, typename Compare, typename Lookup>
+typename map<Key, T, Compare, Lookup>::iterator
+map<Key, T, Compare, Lookup>::begin() noexcept {
   return tree->Begin();
 }
 
-template <typename Key, typename T>
-typename map<Key, T>::const_iterator map<Key, T>::begin() const noexcept {
+template <typename Key, typename T, typename Compare, typename Lookup>
+typename map<Key, T, Compare, Lookup>::const_iterator
+map<Key, T, Compare, Lookup>::begin() const noexcept {
   return tree->Begin();
 }
 
-template <typename Key, typename T>
-typename map<Key, T>::iterator map<Key, T>::end() noexcept {
+template <typename Key, typename T, typename Compare, typename Lookup>
+typename map<Key, T, Compare, Lookup>::iterator
+map<Key, T, Compare, Lookup>::end() noexcept {
   return tree->End();
 }
 
-template <typename Key, typename T>
-typename map<Key, T>::const_iterator map<Key, T>::end() const noexcept {
+template <typename Key, typename T, typename Compare, typename Lookup>
+typename map<Key, T, Compare, Lookup>::const_iterator
+map<Key, T, Compare, Lookup>::end() const noexcept {
   return tree->End();
 }
 
-template <typename Key, typename T>
-bool map<Key, T>::empty() const noexcept {
+template <typename Key, typename T, typename Compare, typename Lookup>
+bool map<Key, T, Compare, Lookup>::empty() const noexcept {
   return tree->isEmpty();
 }
 
-template <typename Key, typename T>
-typename map<Key, T>::size_type map<Key, T>::size() const noexcept {
+template <typename Key, typename T, typename Compare, typename Lookup>
+typename map<Key, T, Compare, Lookup>::size_type
+map<Key, T, Compare, Lookup>::size() const noexcept {
   return tree->GetSize();
 }
 
-template <typename Key, typename T>
-typename map<Key, T>::size_type map<Key, T>::max_size() const noexcept {
+template <typename Key, typename T, typename Compare, typename Lookup>
+typename map<Key, T, Compare, Lookup>::size_type
+map<Key, T, Compare, Lookup>::max_size() const noexcept {
   return tree->GetMaxSize();
 }
 
-template <typename Key, typename T>
-void map<Key, T>::clear() noexcept {
+template <typename Key, typename T, typename Compare, typename Lookup>
+typename map<Key, T, Compare, Lookup>::reference
+map<Key, T, Compare, Lookup>::front() {
+  if (empty()) {
+    throw std::out_of_range("front() called on an empty map");
+  }
+
+  return *begin();
+}
+
+template <typename Key, typename T, typename Compare, typename Lookup>
+typename map<Key, T, Compare, Lookup>::const_reference
+map<Key, T, Compare, Lookup>::front() const {
+  return const_cast<map<Key, T, Compare, Lookup> *>(this)->front();
+}
+
+template <typename Key, typename T, typename Compare, typename Lookup>
+typename map<Key, T, Compare, Lookup>::reference
+map<Key, T, Compare, Lookup>::back() {
+  if (empty()) {
+    throw std::out_of_range("back() called on an empty map");
+  }
+
+  return *--end();
+}
+
+template <typename Key, typename T, typename Compare, typename Lookup>
+typename map<Key, T, Compare, Lookup>::const_reference
+map<Key, T, Compare, Lookup>::back() const {
+  return const_cast<map<Key, T, Compare, Lookup> *>(this)->back();
+}
+
+template <typename Key, typename T, typename Compare, typename Lookup>
+void map<Key, T, Compare, Lookup>::pop_front() {
+  if (empty()) {
+    throw std::out_of_range("pop_front() called on an empty map");
+  }
+
+  tree->Erase(tree->Begin());
+}
+
+template <typename Key, typename T, typename Compare, typename Lookup>
+void map<Key, T, Compare, Lookup>::pop_back() {
+  if (empty()) {
+    throw std::out_of_range("pop_back() called on an empty map");
+  }
+
+  tree->Erase(--tree->End());
+}
+
+template <typename Key, typename T, typename Compare, typename Lookup>
+typename map<Key, T, Compare, Lookup>::value_type
+map<Key, T, Compare, Lookup>::extract_min() {
+  if (empty()) {
+    throw std::out_of_range("extract_min() called on an empty map");
+  }
+
+  return tree->ExtractKey(tree->Begin());
+}
+
+template <typename Key, typename T, typename Compare, typename Lookup>
+typename map<Key, T, Compare, Lookup>::value_type
+map<Key, T, Compare, Lookup>::extract_max() {
+  if (empty()) {
+    throw std::out_of_range("extract_max() called on an empty map");
+  }
+
+  return tree->ExtractKey(--tree->End());
+}
+
+template <typename Key, typename T, typename Compare, typename Lookup>
+void map<Key, T, Compare, Lookup>::clear() noexcept {
   tree->RemoveTree();
 }
 
-template <typename Key, typename T>
-std::pair<typename map<Key, T>::iterator, bool> map<Key, T>::insert(
-    const value_type &value) {
+template <typename Key, typename T, typename Compare, typename Lookup>
+std::pair<typename map<Key, T, Compare, Lookup>::iterator, bool>
+map<Key, T, Compare, Lookup>::insert(const value_type &value) {
   return tree->Insert(value);
 }
 
-template <typename Key, typename T>
-std::pair<typename map<Key, T>::iterator, bool> map<Key, T>::insert(
-    const key_type &key, const mapped_type &obj) {
+template <typename Key, typename T, typename Compare, typename Lookup>
+std::pair<typename map<Key, T, Compare, Lookup>::iterator, bool>
+map<Key, T, Compare, Lookup>::insert(const key_type &key,
+                                     const mapped_type &obj) {
   return tree->Insert(value_type{key, obj});
 }
 
-template <typename Key, typename T>
-std::pair<typename map<Key, T>::iterator, bool> map<Key, T>::insert_or_assign(
-    const key_type &key, const mapped_type &obj) {
+template <typename Key, typename T, typename Compare, typename Lookup>
+typename map<Key, T, Compare, Lookup>::iterator
+map<Key, T, Compare, Lookup>::insert(const_iterator hint,
+                                     const value_type &value) {
+  return tree->Insert(value, hint).first;
+}
+
+template <typename Key, typename T, typename Compare, typename Lookup>
+std::pair<typename map<Key, T, Compare, Lookup>::iterator, bool>
+map<Key, T, Compare, Lookup>::insert_or_assign(const key_type &key,
+                                               const mapped_type &obj) {
   iterator it = tree->Find({key, mapped_type{}});
 
   if (it == end()) {
@@ -133,37 +228,151 @@ std::pair<typename map<Key, T>::iterator, bool> map<Key, T>::insert_or_assign(
   return {it, false};
 }
 
-template <typename Key, typename T>
+template <typename Key, typename T, typename Compare, typename Lookup>
 template <typename... Args>
-std::vector<std::pair<typename map<Key, T>::iterator, bool>>
-map<Key, T>::insert_many(Args &&...args) {
+std::vector<std::pair<typename map<Key, T, Compare, Lookup>::iterator, bool>>
+map<Key, T, Compare, Lookup>::insert_many(Args &&...args) {
   return tree->Insert_many((args)...);
 }
 
-template <typename Key, typename T>
-void map<Key, T>::erase(iterator pos) {
+template <typename Key, typename T, typename Compare, typename Lookup>
+void map<Key, T, Compare, Lookup>::erase(iterator pos) {
   tree->Erase(pos);
 }
 
-template <typename Key, typename T>
-void map<Key, T>::swap(map &other) noexcept {
+template <typename Key, typename T, typename Compare, typename Lookup>
+void map<Key, T, Compare, Lookup>::swap(map &other) noexcept {
   tree->SwapTree(*other.tree);
 }
 
-template <typename Key, typename T>
-void map<Key, T>::merge(map &other) {
+template <typename Key, typename T, typename Compare, typename Lookup>
+void map<Key, T, Compare, Lookup>::merge(map &other) {
   tree->Merge(*other.tree);
 }
 
-template <typename Key, typename T>
-bool map<Key, T>::contains(const key_type &key) const {
+template <typename Key, typename T, typename Compare, typename Lookup>
+template <typename ForwardIt>
+std::vector<bool> map<Key, T, Compare, Lookup>::apply_batch(ForwardIt first,
+                                                            ForwardIt last) {
+  return tree->ApplyBatch(first, last);
+}
+
+template <typename Key, typename T, typename Compare, typename Lookup>
+void map<Key, T, Compare, Lookup>::compact(NodeLayout layout) {
+  tree->Compact(layout);
+}
+
+template <typename Key, typename T, typename Compare, typename Lookup>
+typename map<Key, T, Compare, Lookup>::iterator
+map<Key, T, Compare, Lookup>::find(const key_type &key) {
+  return tree->Find({key, mapped_type{}});
+}
+
+template <typename Key, typename T, typename Compare, typename Lookup>
+typename map<Key, T, Compare, Lookup>::const_iterator
+map<Key, T, Compare, Lookup>::find(const key_type &key) const {
+  return tree->Find({key, mapped_type{}});
+}
+
+template <typename Key, typename T, typename Compare, typename Lookup>
+typename map<Key, T, Compare, Lookup>::iterator
+map<Key, T, Compare, Lookup>::find(const key_type &key, const_iterator hint) {
+  return tree->Find({key, mapped_type{}}, hint);
+}
+
+template <typename Key, typename T, typename Compare, typename Lookup>
+typename map<Key, T, Compare, Lookup>::iterator
+map<Key, T, Compare, Lookup>::lower_bound(const key_type &key) {
+  return tree->LowerBound({key, mapped_type{}});
+}
+
+template <typename Key, typename T, typename Compare, typename Lookup>
+typename map<Key, T, Compare, Lookup>::iterator
+map<Key, T, Compare, Lookup>::lower_bound(const key_type &key,
+                                          const_iterator hint) {
+  return tree->LowerBound({key, mapped_type{}}, hint);
+}
+
+template <typename Key, typename T, typename Compare, typename Lookup>
+bool map<Key, T, Compare, Lookup>::contains(const key_type &key) const {
   iterator it = tree->Find({key, mapped_type{}});
 
   return it != end();
 }
 
-template <typename Key, typename T>
-bool map<Key, T>::operator==(const map &other) const {
+template <typename Key, typename T, typename Compare, typename Lookup>
+typename map<Key, T, Compare, Lookup>::key_compare
+map<Key, T, Compare, Lookup>::key_comp() const {
+  return tree->GetComparator().comp;
+}
+
+template <typename Key, typename T, typename Compare, typename Lookup>
+std::vector<typename map<Key, T, Compare, Lookup>::iterator>
+map<Key, T, Compare, Lookup>::split(size_type parts) {
+  return tree->Split(parts);
+}
+
+template <typename Key, typename T, typename Compare, typename Lookup>
+std::vector<typename map<Key, T, Compare, Lookup>::const_iterator>
+map<Key, T, Compare, Lookup>::split(size_type parts) const {
+  std::vector<iterator> res = tree->Split(parts);
+  return std::vector<const_iterator>(res.begin(), res.end());
+}
+
+template <typename Key, typename T, typename Compare, typename Lookup>
+std::vector<typename map<Key, T, Compare, Lookup>::iterator>
+map<Key, T, Compare, Lookup>::split(size_type parts, const key_type &lo,
+                                    const key_type &hi) {
+  return tree->Split(parts, {lo, mapped_type{}}, {hi, mapped_type{}});
+}
+
+template <typename Key, typename T, typename Compare, typename Lookup>
+std::vector<typename map<Key, T, Compare, Lookup>::const_iterator>
+map<Key, T, Compare, Lookup>::split(size_type parts, const key_type &lo,
+                                    const key_type &hi) const {
+  std::vector<iterator> res =
+      tree->Split(parts, {lo, mapped_type{}}, {hi, mapped_type{}});
+  return std::vector<const_iterator>(res.begin(), res.end());
+}
+
+template <typename Key, typename T, typename Compare, typename Lookup>
+void map<Key, T, Compare, Lookup>::set_finger_mode(bool enabled) noexcept {
+  tree->SetFingerMode(enabled);
+}
+
+template <typename Key, typename T, typename Compare, typename Lookup>
+typename map<Key, T, Compare, Lookup>::size_type
+map<Key, T, Compare, Lookup>::index_memory_usage() const noexcept {
+  return tree->GetIndexMemoryUsage();
+}
+
+template <typename Key, typename T, typename Compare, typename Lookup>
+void map<Key, T, Compare, Lookup>::save(std::ostream &os) const {
+  SerializationHeader::Write<value_type>(os, size());
+
+  for (const_iterator it = begin(); it != end(); ++it) {
+    Serializer<value_type>::Write(os, *it);
+  }
+
+  SerializationHeader::CheckStream(os);
+}
+
+template <typename Key, typename T, typename Compare, typename Lookup>
+void map<Key, T, Compare, Lookup>::load(std::istream &is) {
+  std::uint64_t count = SerializationHeader::Read<value_type>(is);
+  tree_type loaded(tree->GetComparator());
+
+  loaded.BuildFromSorted(count, [&is]() {
+    value_type value = Serializer<value_type>::Read(is);
+    SerializationHeader::CheckStream(is);
+    return value;
+  });
+
+  tree->SwapTree(loaded);
+}
+
+template <typename Key, typename T, typename Compare, typename Lookup>
+bool map<Key, T, Compare, Lookup>::operator==(const map &other) const {
   if (this == &other) return true;
 
   if (size() != other.size()) return false;
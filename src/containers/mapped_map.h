@@ -0,0 +1,84 @@
+#ifndef CONTAINERS_MAPPED_MAP_H_
+#define CONTAINERS_MAPPED_MAP_H_
+
+#include <stdexcept>
+#include <string>
+
+#include "mapped_red_black_tree/mapped_red_black_tree.h"
+#include "red_black_tree/map_compare.h"
+
+namespace RBtreeMapSet {
+
+// map whose elements live in a memory-mapped file, see MappedRedBlackTree.
+// Key and T must be trivially copyable. References returned by the container
+// stay valid until the next insertion that grows the file; iterators stay
+// valid until their element is erased. A map opened with MappedMode::kReadOnly
+// is read through a const reference: the non-const at, operator[], begin and
+// find throw std::logic_error there, as insert and erase do.
+template <typename Key, typename T, typename Compare = std::less<Key>>
+class mapped_map {
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<const key_type, mapped_type>;
+  using reference = value_type &;
+  using const_reference = const value_type &;
+  using key_compare = Compare;
+
+  using MapCompare = MapKeyCompare<key_type, mapped_type, key_compare>;
+
+  using tree_type = MappedRedBlackTree<value_type, MapCompare>;
+  using iterator = typename tree_type::iterator;
+  using const_iterator = typename tree_type::const_iterator;
+  using size_type = std::size_t;
+
+  static_assert(std::is_trivially_copyable_v<key_type> &&
+                    std::is_trivially_copyable_v<mapped_type>,
+                "mapped_map stores elements as raw bytes");
+
+  explicit mapped_map(const std::string &path,
+                      MappedMode mode = MappedMode::kReadWrite,
+                      const key_compare &comp = key_compare{});
+  mapped_map(const mapped_map &other) = delete;
+  mapped_map(mapped_map &&other) noexcept;
+  ~mapped_map();
+
+  mapped_map &operator=(const mapped_map &other) = delete;
+  mapped_map &operator=(mapped_map &&other) noexcept;
+
+  mapped_type &at(const key_type &key);
+  const mapped_type &at(const key_type &key) const;
+  mapped_type &operator[](const key_type &key);
+
+  iterator begin();
+  const_iterator begin() const noexcept;
+  iterator end() noexcept;
+  const_iterator end() const noexcept;
+
+  bool empty() const noexcept;
+  size_type size() const noexcept;
+  size_type max_size() const noexcept;
+
+  void clear();
+  std::pair<iterator, bool> insert(const value_type &value);
+  std::pair<iterator, bool> insert(const key_type &key, const mapped_type &obj);
+  std::pair<iterator, bool> insert_or_assign(const key_type &key,
+                                             const mapped_type &obj);
+  void erase(iterator pos);
+  void swap(mapped_map &other) noexcept;
+
+  iterator find(const key_type &key);
+  const_iterator find(const key_type &key) const;
+  bool contains(const key_type &key) const;
+
+  void reserve(size_type count);
+  void flush();
+
+ private:
+  tree_type *tree;
+};
+
+}  // namespace RBtreeMapSet
+
+#include "mapped_map.tpp"
+#endif  // CONTAINERS_MAPPED_MAP_H_
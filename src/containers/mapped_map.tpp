@@ -0,0 +1,173 @@
+#include "mapped_map.h"
+
+namespace RBtreeMapSet {
+
+template <typename Key, typename T, typename Compare>
+mapped_map<Key, T, Compare>::mapped_map(const std::string &path,
+                                        MappedMode mode,
+                                        const key_compare &comp)
+    : tree(new tree_type(path, mode, MapCompare{comp})) {}
+
+template <typename Key, typename T, typename Compare>
+mapped_map<Key, T, Compare>::mapped_map(mapped_map &&other) noexcept
+    : tree(new tree_type(std::move(*other.tree))) {}
+
+template <typename Key, typename T, typename Compare>
+mapped_map<Key, T, Compare>::~mapped_map() {
+  delete tree;
+  tree = nullptr;
+}
+
+template <typename Key, typename T, typename Compare>
+mapped_map<Key, T, Compare> &mapped_map<Key, T, Compare>::operator=(
+    mapped_map &&other) noexcept {
+  *tree = std::move(*other.tree);
+  return *this;
+}
+
+template <typename Key, typename T, typename Compare>
+typename mapped_map<Key, T, Compare>::mapped_type &
+mapped_map<Key, T, Compare>::at(const key_type &key) {
+  iterator it = tree->Find({key, mapped_type{}});
+
+  if (it == end()) {
+    throw std::out_of_range("Element with the specified key not found");
+  }
+
+  return (*it).second;
+}
+
+template <typename Key, typename T, typename Compare>
+const typename mapped_map<Key, T, Compare>::mapped_type &
+mapped_map<Key, T, Compare>::at(const key_type &key) const {
+  const_iterator it = find(key);
+
+  if (it == end()) {
+    throw std::out_of_range("Element with the specified key not found");
+  }
+
+  return (*it).second;
+}
+
+template <typename Key, typename T, typename Compare>
+typename mapped_map<Key, T, Compare>::mapped_type &
+mapped_map<Key, T, Compare>::operator[](const key_type &key) {
+  iterator it = tree->Find({key, mapped_type{}});
+
+  if (it == end()) {
+    it = tree->Insert(value_type{key, mapped_type{}}).first;
+  }
+
+  return (*it).second;
+}
+
+template <typename Key, typename T, typename Compare>
+typename mapped_map<Key, T, Compare>::iterator
+mapped_map<Key, T, Compare>::begin() {
+  return tree->Begin();
+}
+
+template <typename Key, typename T, typename Compare>
+typename mapped_map<Key, T, Compare>::const_iterator
+mapped_map<Key, T, Compare>::begin() const noexcept {
+  return static_cast<const tree_type *>(tree)->Begin();
+}
+
+template <typename Key, typename T, typename Compare>
+typename mapped_map<Key, T, Compare>::iterator
+mapped_map<Key, T, Compare>::end() noexcept {
+  return tree->End();
+}
+
+template <typename Key, typename T, typename Compare>
+typename mapped_map<Key, T, Compare>::const_iterator
+mapped_map<Key, T, Compare>::end() const noexcept {
+  return static_cast<const tree_type *>(tree)->End();
+}
+
+template <typename Key, typename T, typename Compare>
+bool mapped_map<Key, T, Compare>::empty() const noexcept {
+  return tree->isEmpty();
+}
+
+template <typename Key, typename T, typename Compare>
+typename mapped_map<Key, T, Compare>::size_type
+mapped_map<Key, T, Compare>::size() const noexcept {
+  return tree->GetSize();
+}
+
+template <typename Key, typename T, typename Compare>
+typename mapped_map<Key, T, Compare>::size_type
+mapped_map<Key, T, Compare>::max_size() const noexcept {
+  return tree->GetMaxSize();
+}
+
+template <typename Key, typename T, typename Compare>
+void mapped_map<Key, T, Compare>::clear() {
+  tree->RemoveTree();
+}
+
+template <typename Key, typename T, typename Compare>
+std::pair<typename mapped_map<Key, T, Compare>::iterator, bool>
+mapped_map<Key, T, Compare>::insert(const value_type &value) {
+  return tree->Insert(value);
+}
+
+template <typename Key, typename T, typename Compare>
+std::pair<typename mapped_map<Key, T, Compare>::iterator, bool>
+mapped_map<Key, T, Compare>::insert(const key_type &key,
+                                    const mapped_type &obj) {
+  return tree->Insert(value_type{key, obj});
+}
+
+template <typename Key, typename T, typename Compare>
+std::pair<typename mapped_map<Key, T, Compare>::iterator, bool>
+mapped_map<Key, T, Compare>::insert_or_assign(const key_type &key,
+                                              const mapped_type &obj) {
+  std::pair<iterator, bool> res = tree->Insert(value_type{key, obj});
+
+  if (!res.second) {
+    (*res.first).second = obj;
+  }
+
+  return res;
+}
+
+template <typename Key, typename T, typename Compare>
+void mapped_map<Key, T, Compare>::erase(iterator pos) {
+  tree->Erase(pos);
+}
+
+template <typename Key, typename T, typename Compare>
+void mapped_map<Key, T, Compare>::swap(mapped_map &other) noexcept {
+  tree->SwapTree(*other.tree);
+}
+
+template <typename Key, typename T, typename Compare>
+typename mapped_map<Key, T, Compare>::iterator
+mapped_map<Key, T, Compare>::find(const key_type &key) {
+  return tree->Find({key, mapped_type{}});
+}
+
+template <typename Key, typename T, typename Compare>
+typename mapped_map<Key, T, Compare>::const_iterator
+mapped_map<Key, T, Compare>::find(const key_type &key) const {
+  return static_cast<const tree_type *>(tree)->Find({key, mapped_type{}});
+}
+
+template <typename Key, typename T, typename Compare>
+bool mapped_map<Key, T, Compare>::contains(const key_type &key) const {
+  return find(key) != end();
+}
+
+template <typename Key, typename T, typename Compare>
+void mapped_map<Key, T, Compare>::reserve(size_type count) {
+  tree->Reserve(count);
+}
+
+template <typename Key, typename T, typename Compare>
+void mapped_map<Key, T, Compare>::flush() {
+  tree->Flush();
+}
+
+}  // namespace RBtreeMapSet
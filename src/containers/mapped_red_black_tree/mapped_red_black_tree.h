@@ -0,0 +1,261 @@
+#ifndef CONTAINERS_MAPPED_RED_BLACK_TREE_MAPPED_RED_BLACK_TREE_H_
+#define CONTAINERS_MAPPED_RED_BLACK_TREE_MAPPED_RED_BLACK_TREE_H_
+
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <type_traits>
+
+#include "../red_black_tree/compare_traits.h"
+#include "../red_black_tree/red_black_tree.h"
+
+namespace RBtreeMapSet {
+
+enum class MappedMode { kReadWrite, kReadOnly };
+
+// Red-black tree whose nodes live in a memory-mapped file. Nodes are linked
+// by their offset from the start of the file, so the image stays valid when
+// it is mapped at another address: reopening it is an mmap, pages are read
+// lazily and several processes may share one read-only image. Keys are stored
+// as raw bytes and must be trivially copyable and destructible. A read-only
+// image is mapped without PROT_WRITE, so everything that could write through
+// it, including the non-const Begin and Find, throws std::logic_error there.
+//
+// The balancing follows RedBlackTree step for step but is not shared with it.
+// RedBlackTree links nodes by pointer, allocates them one by one and keeps a
+// head node. Here every link is a file offset that must be turned into an
+// address through the current mapping, and the mapping moves whenever the
+// file grows, so a pointer held across an allocation would dangle.
+template <typename Key, typename Compare = std::less<Key>>
+class MappedRedBlackTree {
+ private:
+  struct Node;
+  struct Header;
+  struct Iterator;
+  struct IteratorConst;
+
+ public:
+  using key_type = Key;
+  using reference = key_type &;
+  using const_reference = const key_type &;
+  using iterator = Iterator;
+  using const_iterator = IteratorConst;
+  using size_type = std::size_t;
+  using offset_type = std::uint64_t;
+  using key_compare = Compare;
+
+  static_assert(std::is_trivially_copy_constructible_v<Key> &&
+                    std::is_trivially_destructible_v<Key>,
+                "MappedRedBlackTree stores keys as raw bytes");
+
+  MappedRedBlackTree(const std::string &path, MappedMode mode,
+                     const key_compare &comp = key_compare{});
+  MappedRedBlackTree(const MappedRedBlackTree &other) = delete;
+  MappedRedBlackTree(MappedRedBlackTree &&other) noexcept;
+  MappedRedBlackTree &operator=(const MappedRedBlackTree &other) = delete;
+  MappedRedBlackTree &operator=(MappedRedBlackTree &&other) noexcept;
+  ~MappedRedBlackTree();
+
+  void RemoveTree();
+
+  iterator Begin();
+  const_iterator Begin() const noexcept;
+  iterator End() noexcept;
+  const_iterator End() const noexcept;
+
+  bool isEmpty() const noexcept;
+  size_type GetSize() const noexcept;
+  size_type GetMaxSize() const noexcept;
+  bool IsReadOnly() const noexcept;
+  void CheckWritable() const;
+
+  std::pair<iterator, bool> Insert(const key_type &key);
+  void Erase(iterator position);
+  void SwapTree(MappedRedBlackTree &other) noexcept;
+  iterator Find(const_reference key);
+  const_iterator Find(const_reference key) const noexcept;
+  key_compare GetComparator() const;
+
+  void Reserve(size_type count);
+  void Flush();
+
+  bool CheckTree() const;
+
+ private:
+  void Open(const std::string &path);
+  char *Map(size_type size) const;
+  void Unmap() noexcept;
+  void Grow(size_type min_file_size);
+  void InitHeader();
+  void CheckHeader() const;
+  bool IsNodeOffset(offset_type offset) const noexcept;
+
+  Header *GetHeader() const noexcept;
+  Node *At(offset_type offset) const noexcept;
+  offset_type FirstNodeOffset() const noexcept;
+  offset_type AllocateNode();
+  void FreeNode(offset_type offset) noexcept;
+
+  offset_type GetRoot() const noexcept;
+  void SetRoot(offset_type offset) noexcept;
+  bool IsRed(offset_type offset) const noexcept;
+  bool IsBlack(offset_type offset) const noexcept;
+
+  void BalanceForInsert(offset_type node);
+  void BalanceForErase(offset_type node, offset_type parent);
+  void RotateLeft(offset_type node);
+  void RotateRight(offset_type node);
+  void ReplaceChild(offset_type parent, offset_type old_child,
+                    offset_type new_child);
+  offset_type SearchMinNode(offset_type node) const noexcept;
+  offset_type SearchMaxNode(offset_type node) const noexcept;
+  offset_type GetNextNode(offset_type node) const noexcept;
+  offset_type GetPreviousNode(offset_type node) const noexcept;
+
+  int CompareKeys(const_reference key_1, const_reference key_2) const;
+  bool CheckRedNodes(offset_type node) const;
+  int CheckBlackHeight(offset_type node) const;
+
+  struct Node {
+    offset_type parent;
+    offset_type left;
+    offset_type right;
+    Color color;
+    key_type key;
+  };
+
+  struct Header {
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint64_t key_size;
+    std::uint64_t node_size;
+    offset_type root;
+    offset_type min;
+    offset_type max;
+    offset_type free_list;
+    offset_type used;
+    std::uint64_t size;
+  };
+
+  struct Iterator {
+    using iterator_category = std::bidirectional_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = typename MappedRedBlackTree<Key, Compare>::key_type;
+    using pointer = value_type *;
+    using reference = value_type &;
+
+    Iterator() = delete;
+
+    Iterator(const MappedRedBlackTree *tree, offset_type offset)
+        : tree_(tree), offset_(offset) {}
+
+    reference operator*() const noexcept { return tree_->At(offset_)->key; }
+
+    pointer operator->() const noexcept { return &tree_->At(offset_)->key; }
+
+    iterator &operator++() noexcept {
+      offset_ = tree_->GetNextNode(offset_);
+      return *this;
+    }
+
+    iterator operator++(int) noexcept {
+      iterator tmp{*this};
+      ++(*this);
+      return tmp;
+    }
+
+    iterator &operator--() noexcept {
+      offset_ = tree_->GetPreviousNode(offset_);
+      return *this;
+    }
+
+    iterator operator--(int) noexcept {
+      iterator tmp{*this};
+      --(*this);
+      return tmp;
+    }
+
+    bool operator==(const iterator &other) const noexcept {
+      return offset_ == other.offset_ && tree_ == other.tree_;
+    }
+
+    bool operator!=(const iterator &other) const noexcept {
+      return !(*this == other);
+    }
+
+    const MappedRedBlackTree *tree_;
+    offset_type offset_;
+  };
+
+  struct IteratorConst {
+    using iterator_category = std::bidirectional_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = typename MappedRedBlackTree<Key, Compare>::key_type;
+    using pointer = const value_type *;
+    using reference = const value_type &;
+
+    IteratorConst() = delete;
+
+    IteratorConst(const MappedRedBlackTree *tree, offset_type offset)
+        : tree_(tree), offset_(offset) {}
+
+    IteratorConst(const iterator &it) : tree_(it.tree_), offset_(it.offset_) {}
+
+    reference operator*() const noexcept { return tree_->At(offset_)->key; }
+
+    pointer operator->() const noexcept { return &tree_->At(offset_)->key; }
+
+    const_iterator &operator++() noexcept {
+      offset_ = tree_->GetNextNode(offset_);
+      return *this;
+    }
+
+    const_iterator operator++(int) noexcept {
+      const_iterator tmp{*this};
+      ++(*this);
+      return tmp;
+    }
+
+    const_iterator &operator--() noexcept {
+      offset_ = tree_->GetPreviousNode(offset_);
+      return *this;
+    }
+
+    const_iterator operator--(int) noexcept {
+      const_iterator tmp{*this};
+      --(*this);
+      return tmp;
+    }
+
+    friend bool operator==(const const_iterator &it1,
+                           const const_iterator &it2) noexcept {
+      return it1.offset_ == it2.offset_ && it1.tree_ == it2.tree_;
+    }
+
+    friend bool operator!=(const const_iterator &it1,
+                           const const_iterator &it2) noexcept {
+      return !(it1 == it2);
+    }
+
+    const MappedRedBlackTree *tree_;
+    offset_type offset_;
+  };
+
+  using compare_traits = CompareTraits<Compare, Key>;
+
+  static constexpr std::uint32_t kMagic = 0x4d544252;  // "RBTM"
+  static constexpr std::uint32_t kVersion = 1;
+  static constexpr size_type kInitialNodes = 64;
+
+  int fd;
+  char *base;
+  size_type file_size;
+  MappedMode mode;
+  Compare cmp;
+};
+
+}  // namespace RBtreeMapSet
+
+#include "mapped_red_black_tree.tpp"
+#endif  // CONTAINERS_MAPPED_RED_BLACK_TREE_MAPPED_RED_BLACK_TREE_H_
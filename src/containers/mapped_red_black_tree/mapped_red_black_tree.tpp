@@ -0,0 +1,753 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#include "mapped_red_black_tree.h"
+
+namespace RBtreeMapSet {
+
+template <typename Key, typename Compare>
+MappedRedBlackTree<Key, Compare>::MappedRedBlackTree(const std::string &path,
+                                                     MappedMode mode,
+                                                     const key_compare &comp)
+    : fd(-1), base(nullptr), file_size(0), mode(mode), cmp(comp) {
+  Open(path);
+}
+
+template <typename Key, typename Compare>
+MappedRedBlackTree<Key, Compare>::MappedRedBlackTree(
+    MappedRedBlackTree &&other) noexcept
+    : fd(-1), base(nullptr), file_size(0), mode(other.mode), cmp(other.cmp) {
+  SwapTree(other);
+}
+
+template <typename Key, typename Compare>
+MappedRedBlackTree<Key, Compare> &MappedRedBlackTree<Key, Compare>::operator=(
+    MappedRedBlackTree &&other) noexcept {
+  if (this != &other) {
+    Unmap();
+    SwapTree(other);
+  }
+  return *this;
+}
+
+template <typename Key, typename Compare>
+MappedRedBlackTree<Key, Compare>::~MappedRedBlackTree() {
+  Unmap();
+}
+
+template <typename Key, typename Compare>
+void MappedRedBlackTree<Key, Compare>::Open(const std::string &path) {
+  bool read_only = mode == MappedMode::kReadOnly;
+  fd = read_only ? ::open(path.c_str(), O_RDONLY)
+                 : ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+  if (fd == -1) {
+    throw std::system_error(errno, std::generic_category(),
+                            "Cannot open " + path);
+  }
+
+  struct stat info;
+  if (::fstat(fd, &info) == -1) {
+    int error = errno;
+    Unmap();
+    throw std::system_error(error, std::generic_category(),
+                            "Cannot stat " + path);
+  }
+
+  try {
+    if (info.st_size == 0) {
+      CheckWritable();
+      size_type initial_size = FirstNodeOffset() + kInitialNodes * sizeof(Node);
+      if (::ftruncate(fd, initial_size) == -1) {
+        throw std::system_error(errno, std::generic_category(),
+                                "Cannot resize " + path);
+      }
+      base = Map(initial_size);
+      file_size = initial_size;
+      InitHeader();
+    } else {
+      if (static_cast<size_type>(info.st_size) < sizeof(Header)) {
+        throw std::runtime_error(path + " is not a mapped tree image");
+      }
+      base = Map(info.st_size);
+      file_size = info.st_size;
+      CheckHeader();
+    }
+  } catch (...) {
+    Unmap();
+    throw;
+  }
+}
+
+template <typename Key, typename Compare>
+char *MappedRedBlackTree<Key, Compare>::Map(size_type size) const {
+  int protection = PROT_READ;
+  if (mode == MappedMode::kReadWrite) {
+    protection |= PROT_WRITE;
+  }
+
+  void *address = ::mmap(nullptr, size, protection, MAP_SHARED, fd, 0);
+  if (address == MAP_FAILED) {
+    throw std::system_error(errno, std::generic_category(), "mmap failed");
+  }
+
+  return static_cast<char *>(address);
+}
+
+template <typename Key, typename Compare>
+void MappedRedBlackTree<Key, Compare>::Unmap() noexcept {
+  if (base) {
+    ::munmap(base, file_size);
+    base = nullptr;
+    file_size = 0;
+  }
+
+  if (fd != -1) {
+    ::close(fd);
+    fd = -1;
+  }
+}
+
+template <typename Key, typename Compare>
+void MappedRedBlackTree<Key, Compare>::Grow(size_type min_file_size) {
+  size_type new_size = file_size;
+  while (new_size < min_file_size) {
+    new_size *= 2;
+  }
+
+  if (::ftruncate(fd, new_size) == -1) {
+    throw std::system_error(errno, std::generic_category(),
+                            "Cannot grow mapped file");
+  }
+
+  // The old mapping stays in place until the new one exists, so a failed
+  // mmap leaves the tree usable at its old size.
+  char *new_base = Map(new_size);
+  ::munmap(base, file_size);
+  base = new_base;
+  file_size = new_size;
+}
+
+template <typename Key, typename Compare>
+void MappedRedBlackTree<Key, Compare>::InitHeader() {
+  Header *header = GetHeader();
+  header->magic = kMagic;
+  header->version = kVersion;
+  header->key_size = sizeof(key_type);
+  header->node_size = sizeof(Node);
+  header->root = 0;
+  header->min = 0;
+  header->max = 0;
+  header->free_list = 0;
+  header->used = FirstNodeOffset();
+  header->size = 0;
+}
+
+// Checks the header and the offsets it holds, so that opening a truncated or
+// foreign file fails here rather than on the first access. Links inside the
+// nodes are not followed: that would read the whole image.
+template <typename Key, typename Compare>
+void MappedRedBlackTree<Key, Compare>::CheckHeader() const {
+  const Header *header = GetHeader();
+  if (header->magic != kMagic || header->version != kVersion ||
+      header->key_size != sizeof(key_type) ||
+      header->node_size != sizeof(Node) || header->used > file_size ||
+      FirstNodeOffset() > header->used ||
+      (header->used - FirstNodeOffset()) % sizeof(Node) ||
+      header->size > (header->used - FirstNodeOffset()) / sizeof(Node) ||
+      !IsNodeOffset(header->root) || !IsNodeOffset(header->min) ||
+      !IsNodeOffset(header->max) || !IsNodeOffset(header->free_list) ||
+      !header->root != !header->min || !header->root != !header->max ||
+      !header->root != !header->size) {
+    throw std::runtime_error("Mapped file does not hold a matching tree");
+  }
+}
+
+// Whether offset is 0 or the start of a node below the used mark.
+template <typename Key, typename Compare>
+bool MappedRedBlackTree<Key, Compare>::IsNodeOffset(
+    offset_type offset) const noexcept {
+  return !offset ||
+         (offset >= FirstNodeOffset() &&
+          offset < GetHeader()->used &&
+          (offset - FirstNodeOffset()) % sizeof(Node) == 0);
+}
+
+template <typename Key, typename Compare>
+void MappedRedBlackTree<Key, Compare>::CheckWritable() const {
+  if (mode == MappedMode::kReadOnly) {
+    throw std::logic_error("Mapped tree is opened read-only");
+  }
+}
+
+template <typename Key, typename Compare>
+typename MappedRedBlackTree<Key, Compare>::Header *
+MappedRedBlackTree<Key, Compare>::GetHeader() const noexcept {
+  return reinterpret_cast<Header *>(base);
+}
+
+template <typename Key, typename Compare>
+typename MappedRedBlackTree<Key, Compare>::Node *
+MappedRedBlackTree<Key, Compare>::At(offset_type offset) const noexcept {
+  return reinterpret_cast<Node *>(base + offset);
+}
+
+template <typename Key, typename Compare>
+typename MappedRedBlackTree<Key, Compare>::offset_type
+MappedRedBlackTree<Key, Compare>::FirstNodeOffset() const noexcept {
+  return (sizeof(Header) + alignof(Node) - 1) / alignof(Node) * alignof(Node);
+}
+
+template <typename Key, typename Compare>
+typename MappedRedBlackTree<Key, Compare>::offset_type
+MappedRedBlackTree<Key, Compare>::AllocateNode() {
+  offset_type offset = GetHeader()->free_list;
+
+  if (offset) {
+    GetHeader()->free_list = At(offset)->left;
+    return offset;
+  }
+
+  if (GetHeader()->used + sizeof(Node) > file_size) {
+    Grow(GetHeader()->used + sizeof(Node));
+  }
+
+  offset = GetHeader()->used;
+  GetHeader()->used += sizeof(Node);
+  return offset;
+}
+
+template <typename Key, typename Compare>
+void MappedRedBlackTree<Key, Compare>::FreeNode(offset_type offset) noexcept {
+  At(offset)->left = GetHeader()->free_list;
+  GetHeader()->free_list = offset;
+}
+
+template <typename Key, typename Compare>
+void MappedRedBlackTree<Key, Compare>::RemoveTree() {
+  CheckWritable();
+  InitHeader();
+}
+
+template <typename Key, typename Compare>
+typename MappedRedBlackTree<Key, Compare>::offset_type
+MappedRedBlackTree<Key, Compare>::GetRoot() const noexcept {
+  return GetHeader()->root;
+}
+
+template <typename Key, typename Compare>
+void MappedRedBlackTree<Key, Compare>::SetRoot(offset_type offset) noexcept {
+  GetHeader()->root = offset;
+}
+
+template <typename Key, typename Compare>
+bool MappedRedBlackTree<Key, Compare>::IsRed(
+    offset_type offset) const noexcept {
+  return offset && At(offset)->color == Color::kRed;
+}
+
+template <typename Key, typename Compare>
+bool MappedRedBlackTree<Key, Compare>::IsBlack(
+    offset_type offset) const noexcept {
+  return !IsRed(offset);
+}
+
+template <typename Key, typename Compare>
+typename MappedRedBlackTree<Key, Compare>::iterator
+MappedRedBlackTree<Key, Compare>::Begin() {
+  CheckWritable();
+  return iterator(this, GetHeader()->min);
+}
+
+template <typename Key, typename Compare>
+typename MappedRedBlackTree<Key, Compare>::const_iterator
+MappedRedBlackTree<Key, Compare>::Begin() const noexcept {
+  return const_iterator(this, GetHeader()->min);
+}
+
+template <typename Key, typename Compare>
+typename MappedRedBlackTree<Key, Compare>::iterator
+MappedRedBlackTree<Key, Compare>::End() noexcept {
+  return iterator(this, 0);
+}
+
+template <typename Key, typename Compare>
+typename MappedRedBlackTree<Key, Compare>::const_iterator
+MappedRedBlackTree<Key, Compare>::End() const noexcept {
+  return const_iterator(this, 0);
+}
+
+template <typename Key, typename Compare>
+bool MappedRedBlackTree<Key, Compare>::isEmpty() const noexcept {
+  return !GetRoot();
+}
+
+template <typename Key, typename Compare>
+typename MappedRedBlackTree<Key, Compare>::size_type
+MappedRedBlackTree<Key, Compare>::GetSize() const noexcept {
+  return GetHeader()->size;
+}
+
+template <typename Key, typename Compare>
+typename MappedRedBlackTree<Key, Compare>::size_type
+MappedRedBlackTree<Key, Compare>::GetMaxSize() const noexcept {
+  return (std::numeric_limits<off_t>::max() - FirstNodeOffset()) /
+         sizeof(Node);
+}
+
+template <typename Key, typename Compare>
+bool MappedRedBlackTree<Key, Compare>::IsReadOnly() const noexcept {
+  return mode == MappedMode::kReadOnly;
+}
+
+template <typename Key, typename Compare>
+int MappedRedBlackTree<Key, Compare>::CompareKeys(
+    const_reference key_1, const_reference key_2) const {
+  return compare_traits::ThreeWay(cmp, key_1, key_2);
+}
+
+template <typename Key, typename Compare>
+std::pair<typename MappedRedBlackTree<Key, Compare>::iterator, bool>
+MappedRedBlackTree<Key, Compare>::Insert(const key_type &key) {
+  CheckWritable();
+
+  offset_type node = GetRoot();
+  offset_type parent = 0;
+  int res = 0;
+
+  while (node) {
+    parent = node;
+    res = CompareKeys(key, At(node)->key);
+    if (res < 0) {
+      node = At(node)->left;
+    } else if (res > 0) {
+      node = At(node)->right;
+    } else {
+      return {iterator(this, node), false};
+    }
+  }
+
+  offset_type new_node = AllocateNode();
+  Node *created = At(new_node);
+  created->parent = parent;
+  created->left = 0;
+  created->right = 0;
+  created->color = Color::kRed;
+  ::new (static_cast<void *>(&created->key)) key_type(key);
+
+  Header *header = GetHeader();
+  if (!parent) {
+    SetRoot(new_node);
+    header->min = new_node;
+    header->max = new_node;
+  } else if (res < 0) {
+    At(parent)->left = new_node;
+    if (header->min == parent) {
+      header->min = new_node;
+    }
+  } else {
+    At(parent)->right = new_node;
+    if (header->max == parent) {
+      header->max = new_node;
+    }
+  }
+
+  ++header->size;
+  BalanceForInsert(new_node);
+
+  return {iterator(this, new_node), true};
+}
+
+template <typename Key, typename Compare>
+void MappedRedBlackTree<Key, Compare>::BalanceForInsert(offset_type node) {
+  while (node != GetRoot() && IsRed(At(node)->parent)) {
+    offset_type parent = At(node)->parent;
+    offset_type grandparent = At(parent)->parent;
+    bool parent_is_left_child = At(grandparent)->left == parent;
+    offset_type uncle = parent_is_left_child ? At(grandparent)->right
+                                             : At(grandparent)->left;
+
+    if (IsRed(uncle)) {
+      At(parent)->color = Color::kBlack;
+      At(uncle)->color = Color::kBlack;
+      At(grandparent)->color = Color::kRed;
+      node = grandparent;
+    } else {
+      if (parent_is_left_child != (At(parent)->left == node)) {
+        if (parent_is_left_child) {
+          RotateLeft(parent);
+        } else {
+          RotateRight(parent);
+        }
+        std::swap(parent, node);
+      }
+
+      if (parent_is_left_child) {
+        RotateRight(grandparent);
+      } else {
+        RotateLeft(grandparent);
+      }
+
+      At(parent)->color = Color::kBlack;
+      At(grandparent)->color = Color::kRed;
+    }
+  }
+
+  At(GetRoot())->color = Color::kBlack;
+}
+
+template <typename Key, typename Compare>
+void MappedRedBlackTree<Key, Compare>::ReplaceChild(offset_type parent,
+                                                    offset_type old_child,
+                                                    offset_type new_child) {
+  if (!parent) {
+    SetRoot(new_child);
+  } else if (At(parent)->left == old_child) {
+    At(parent)->left = new_child;
+  } else {
+    At(parent)->right = new_child;
+  }
+}
+
+template <typename Key, typename Compare>
+void MappedRedBlackTree<Key, Compare>::RotateLeft(offset_type node) {
+  offset_type pivot = At(node)->right;
+
+  At(pivot)->parent = At(node)->parent;
+  ReplaceChild(At(node)->parent, node, pivot);
+
+  At(node)->right = At(pivot)->left;
+  if (At(pivot)->left) {
+    At(At(pivot)->left)->parent = node;
+  }
+
+  At(node)->parent = pivot;
+  At(pivot)->left = node;
+}
+
+template <typename Key, typename Compare>
+void MappedRedBlackTree<Key, Compare>::RotateRight(offset_type node) {
+  offset_type pivot = At(node)->left;
+
+  At(pivot)->parent = At(node)->parent;
+  ReplaceChild(At(node)->parent, node, pivot);
+
+  At(node)->left = At(pivot)->right;
+  if (At(pivot)->right) {
+    At(At(pivot)->right)->parent = node;
+  }
+
+  At(node)->parent = pivot;
+  At(pivot)->right = node;
+}
+
+template <typename Key, typename Compare>
+void MappedRedBlackTree<Key, Compare>::Erase(iterator position) {
+  CheckWritable();
+
+  offset_type erased = position.offset_;
+  if (!erased) {
+    return;
+  }
+
+  Header *header = GetHeader();
+  if (header->min == erased) {
+    header->min = GetNextNode(erased);
+  }
+  if (header->max == erased) {
+    header->max = GetPreviousNode(erased);
+  }
+
+  Node *node = At(erased);
+  offset_type child = 0;
+  offset_type child_parent = 0;
+  Color removed_color = node->color;
+
+  if (!node->left || !node->right) {
+    child = node->left ? node->left : node->right;
+    child_parent = node->parent;
+    if (child) {
+      At(child)->parent = node->parent;
+    }
+    ReplaceChild(node->parent, erased, child);
+  } else {
+    offset_type next = SearchMinNode(node->right);
+    Node *replace = At(next);
+    removed_color = replace->color;
+    child = replace->right;
+
+    if (replace->parent == erased) {
+      child_parent = next;
+    } else {
+      child_parent = replace->parent;
+      if (child) {
+        At(child)->parent = replace->parent;
+      }
+      At(replace->parent)->left = child;
+      replace->right = node->right;
+      At(node->right)->parent = next;
+    }
+
+    ReplaceChild(node->parent, erased, next);
+    replace->parent = node->parent;
+    replace->left = node->left;
+    At(node->left)->parent = next;
+    replace->color = node->color;
+  }
+
+  if (removed_color == Color::kBlack) {
+    BalanceForErase(child, child_parent);
+  }
+
+  FreeNode(erased);
+  --header->size;
+}
+
+template <typename Key, typename Compare>
+void MappedRedBlackTree<Key, Compare>::BalanceForErase(offset_type node,
+                                                       offset_type parent) {
+  while (node != GetRoot() && IsBlack(node)) {
+    if (node == At(parent)->left) {
+      offset_type sibling = At(parent)->right;
+
+      if (IsRed(sibling)) {
+        At(sibling)->color = Color::kBlack;
+        At(parent)->color = Color::kRed;
+        RotateLeft(parent);
+        sibling = At(parent)->right;
+      }
+
+      if (IsBlack(At(sibling)->left) && IsBlack(At(sibling)->right)) {
+        At(sibling)->color = Color::kRed;
+        node = parent;
+        parent = At(node)->parent;
+      } else {
+        if (IsBlack(At(sibling)->right)) {
+          At(At(sibling)->left)->color = Color::kBlack;
+          At(sibling)->color = Color::kRed;
+          RotateRight(sibling);
+          sibling = At(parent)->right;
+        }
+
+        At(sibling)->color = At(parent)->color;
+        At(parent)->color = Color::kBlack;
+        At(At(sibling)->right)->color = Color::kBlack;
+        RotateLeft(parent);
+        node = GetRoot();
+      }
+    } else {
+      offset_type sibling = At(parent)->left;
+
+      if (IsRed(sibling)) {
+        At(sibling)->color = Color::kBlack;
+        At(parent)->color = Color::kRed;
+        RotateRight(parent);
+        sibling = At(parent)->left;
+      }
+
+      if (IsBlack(At(sibling)->left) && IsBlack(At(sibling)->right)) {
+        At(sibling)->color = Color::kRed;
+        node = parent;
+        parent = At(node)->parent;
+      } else {
+        if (IsBlack(At(sibling)->left)) {
+          At(At(sibling)->right)->color = Color::kBlack;
+          At(sibling)->color = Color::kRed;
+          RotateLeft(sibling);
+          sibling = At(parent)->left;
+        }
+
+        At(sibling)->color = At(parent)->color;
+        At(parent)->color = Color::kBlack;
+        At(At(sibling)->left)->color = Color::kBlack;
+        RotateRight(parent);
+        node = GetRoot();
+      }
+    }
+  }
+
+  if (node) {
+    At(node)->color = Color::kBlack;
+  }
+}
+
+template <typename Key, typename Compare>
+typename MappedRedBlackTree<Key, Compare>::offset_type
+MappedRedBlackTree<Key, Compare>::SearchMinNode(
+    offset_type node) const noexcept {
+  while (At(node)->left) {
+    node = At(node)->left;
+  }
+  return node;
+}
+
+template <typename Key, typename Compare>
+typename MappedRedBlackTree<Key, Compare>::offset_type
+MappedRedBlackTree<Key, Compare>::SearchMaxNode(
+    offset_type node) const noexcept {
+  while (At(node)->right) {
+    node = At(node)->right;
+  }
+  return node;
+}
+
+template <typename Key, typename Compare>
+typename MappedRedBlackTree<Key, Compare>::offset_type
+MappedRedBlackTree<Key, Compare>::GetNextNode(
+    offset_type node) const noexcept {
+  if (!node) {
+    return GetHeader()->min;
+  }
+
+  if (At(node)->right) {
+    return SearchMinNode(At(node)->right);
+  }
+
+  offset_type parent = At(node)->parent;
+  while (parent && node == At(parent)->right) {
+    node = parent;
+    parent = At(parent)->parent;
+  }
+
+  return parent;
+}
+
+template <typename Key, typename Compare>
+typename MappedRedBlackTree<Key, Compare>::offset_type
+MappedRedBlackTree<Key, Compare>::GetPreviousNode(
+    offset_type node) const noexcept {
+  if (!node) {
+    return GetHeader()->max;
+  }
+
+  if (At(node)->left) {
+    return SearchMaxNode(At(node)->left);
+  }
+
+  offset_type parent = At(node)->parent;
+  while (parent && node == At(parent)->left) {
+    node = parent;
+    parent = At(parent)->parent;
+  }
+
+  return parent;
+}
+
+template <typename Key, typename Compare>
+typename MappedRedBlackTree<Key, Compare>::iterator
+MappedRedBlackTree<Key, Compare>::Find(const_reference key) {
+  CheckWritable();
+  return iterator(this, static_cast<const MappedRedBlackTree *>(this)
+                            ->Find(key)
+                            .offset_);
+}
+
+template <typename Key, typename Compare>
+typename MappedRedBlackTree<Key, Compare>::const_iterator
+MappedRedBlackTree<Key, Compare>::Find(const_reference key) const noexcept {
+  offset_type current = GetRoot();
+
+  while (current) {
+    int res = CompareKeys(key, At(current)->key);
+    if (res < 0) {
+      current = At(current)->left;
+    } else if (res > 0) {
+      current = At(current)->right;
+    } else {
+      return const_iterator(this, current);
+    }
+  }
+
+  return End();
+}
+
+template <typename Key, typename Compare>
+typename MappedRedBlackTree<Key, Compare>::key_compare
+MappedRedBlackTree<Key, Compare>::GetComparator() const {
+  return cmp;
+}
+
+template <typename Key, typename Compare>
+void MappedRedBlackTree<Key, Compare>::SwapTree(
+    MappedRedBlackTree &other) noexcept {
+  std::swap(fd, other.fd);
+  std::swap(base, other.base);
+  std::swap(file_size, other.file_size);
+  std::swap(mode, other.mode);
+  std::swap(cmp, other.cmp);
+}
+
+template <typename Key, typename Compare>
+void MappedRedBlackTree<Key, Compare>::Reserve(size_type count) {
+  CheckWritable();
+
+  size_type needed = GetHeader()->used + count * sizeof(Node);
+  if (needed > file_size) {
+    Grow(needed);
+  }
+}
+
+template <typename Key, typename Compare>
+void MappedRedBlackTree<Key, Compare>::Flush() {
+  if (mode == MappedMode::kReadWrite && ::msync(base, file_size, MS_SYNC)) {
+    throw std::system_error(errno, std::generic_category(), "msync failed");
+  }
+}
+
+template <typename Key, typename Compare>
+bool MappedRedBlackTree<Key, Compare>::CheckTree() const {
+  if (!GetRoot()) {
+    return GetSize() == 0;
+  }
+
+  if (IsRed(GetRoot()) || At(GetRoot())->parent) {
+    return false;
+  }
+
+  if (GetHeader()->min != SearchMinNode(GetRoot()) ||
+      GetHeader()->max != SearchMaxNode(GetRoot())) {
+    return false;
+  }
+
+  return CheckRedNodes(GetRoot()) && CheckBlackHeight(GetRoot()) != -1;
+}
+
+template <typename Key, typename Compare>
+bool MappedRedBlackTree<Key, Compare>::CheckRedNodes(offset_type node) const {
+  if (!node) {
+    return true;
+  }
+
+  const Node *current = At(node);
+  if (IsRed(node) && (IsRed(current->left) || IsRed(current->right))) {
+    return false;
+  }
+
+  return CheckRedNodes(current->left) && CheckRedNodes(current->right);
+}
+
+template <typename Key, typename Compare>
+int MappedRedBlackTree<Key, Compare>::CheckBlackHeight(
+    offset_type node) const {
+  if (!node) {
+    return 0;
+  }
+
+  int left_height = CheckBlackHeight(At(node)->left);
+  int right_height = CheckBlackHeight(At(node)->right);
+  if (left_height == -1 || right_height == -1 || left_height != right_height) {
+    return -1;
+  }
+
+  return left_height + (IsRed(node) ? 0 : 1);
+}
+
+}  // namespace RBtreeMapSet
@@ -0,0 +1,64 @@
+#ifndef CONTAINERS_MAPPED_SET_H_
+#define CONTAINERS_MAPPED_SET_H_
+
+#include <string>
+
+#include "mapped_red_black_tree/mapped_red_black_tree.h"
+
+namespace RBtreeMapSet {
+
+// set whose elements live in a memory-mapped file, see MappedRedBlackTree.
+// Key must be trivially copyable.
+template <typename Key, typename Compare = std::less<Key>>
+class mapped_set {
+ public:
+  using key_type = Key;
+  using value_type = Key;
+  using reference = value_type &;
+  using const_reference = const value_type &;
+  using key_compare = Compare;
+
+  using tree_type = MappedRedBlackTree<value_type, key_compare>;
+  using iterator = typename tree_type::const_iterator;
+  using const_iterator = typename tree_type::const_iterator;
+  using size_type = std::size_t;
+
+  static_assert(std::is_trivially_copyable_v<key_type>,
+                "mapped_set stores elements as raw bytes");
+
+  explicit mapped_set(const std::string &path,
+                      MappedMode mode = MappedMode::kReadWrite,
+                      const key_compare &comp = key_compare{});
+  mapped_set(const mapped_set &other) = delete;
+  mapped_set(mapped_set &&other) noexcept;
+  ~mapped_set();
+
+  mapped_set &operator=(const mapped_set &other) = delete;
+  mapped_set &operator=(mapped_set &&other) noexcept;
+
+  iterator begin() const noexcept;
+  iterator end() const noexcept;
+
+  bool empty() const noexcept;
+  size_type size() const noexcept;
+  size_type max_size() const noexcept;
+
+  void clear();
+  std::pair<iterator, bool> insert(const value_type &value);
+  void erase(iterator pos);
+  void swap(mapped_set &other) noexcept;
+
+  iterator find(const key_type &key) const;
+  bool contains(const key_type &key) const;
+
+  void reserve(size_type count);
+  void flush();
+
+ private:
+  tree_type *tree;
+};
+
+}  // namespace RBtreeMapSet
+
+#include "mapped_set.tpp"
+#endif  // CONTAINERS_MAPPED_SET_H_
@@ -0,0 +1,98 @@
+#include "mapped_set.h"
+
+namespace RBtreeMapSet {
+
+template <typename Key, typename Compare>
+mapped_set<Key, Compare>::mapped_set(const std::string &path, MappedMode mode,
+                                     const key_compare &comp)
+    : tree(new tree_type(path, mode, comp)) {}
+
+template <typename Key, typename Compare>
+mapped_set<Key, Compare>::mapped_set(mapped_set &&other) noexcept
+    : tree(new tree_type(std::move(*other.tree))) {}
+
+template <typename Key, typename Compare>
+mapped_set<Key, Compare>::~mapped_set() {
+  delete tree;
+  tree = nullptr;
+}
+
+template <typename Key, typename Compare>
+mapped_set<Key, Compare> &mapped_set<Key, Compare>::operator=(
+    mapped_set &&other) noexcept {
+  *tree = std::move(*other.tree);
+  return *this;
+}
+
+template <typename Key, typename Compare>
+typename mapped_set<Key, Compare>::iterator mapped_set<Key, Compare>::begin()
+    const noexcept {
+  return static_cast<const tree_type *>(tree)->Begin();
+}
+
+template <typename Key, typename Compare>
+typename mapped_set<Key, Compare>::iterator mapped_set<Key, Compare>::end()
+    const noexcept {
+  return static_cast<const tree_type *>(tree)->End();
+}
+
+template <typename Key, typename Compare>
+bool mapped_set<Key, Compare>::empty() const noexcept {
+  return tree->isEmpty();
+}
+
+template <typename Key, typename Compare>
+typename mapped_set<Key, Compare>::size_type mapped_set<Key, Compare>::size()
+    const noexcept {
+  return tree->GetSize();
+}
+
+template <typename Key, typename Compare>
+typename mapped_set<Key, Compare>::size_type
+mapped_set<Key, Compare>::max_size() const noexcept {
+  return tree->GetMaxSize();
+}
+
+template <typename Key, typename Compare>
+void mapped_set<Key, Compare>::clear() {
+  tree->RemoveTree();
+}
+
+template <typename Key, typename Compare>
+std::pair<typename mapped_set<Key, Compare>::iterator, bool>
+mapped_set<Key, Compare>::insert(const value_type &value) {
+  return tree->Insert(value);
+}
+
+template <typename Key, typename Compare>
+void mapped_set<Key, Compare>::erase(iterator pos) {
+  tree->Erase(typename tree_type::iterator(tree, pos.offset_));
+}
+
+template <typename Key, typename Compare>
+void mapped_set<Key, Compare>::swap(mapped_set &other) noexcept {
+  tree->SwapTree(*other.tree);
+}
+
+template <typename Key, typename Compare>
+typename mapped_set<Key, Compare>::iterator mapped_set<Key, Compare>::find(
+    const key_type &key) const {
+  return static_cast<const tree_type *>(tree)->Find(key);
+}
+
+template <typename Key, typename Compare>
+bool mapped_set<Key, Compare>::contains(const key_type &key) const {
+  return find(key) != end();
+}
+
+template <typename Key, typename Compare>
+void mapped_set<Key, Compare>::reserve(size_type count) {
+  tree->Reserve(count);
+}
+
+template <typename Key, typename Compare>
+void mapped_set<Key, Compare>::flush() {
+  tree->Flush();
+}
+
+}  // namespace RBtreeMapSet
@@ -0,0 +1,44 @@
+#ifndef CONTAINERS_PARALLEL_H_
+#define CONTAINERS_PARALLEL_H_
+
+#include <cstddef>
+
+namespace RBtreeMapSet {
+
+// Parallel algorithms over map and set. The elements are cut with split()
+// into ranges taken from the subtrees near the root and the ranges are
+// handed out to worker threads. The container must not be modified while an
+// algorithm runs, except for the mapped values touched by parallel_for_each.
+
+// Calls fn on every element (or every element with a key in [lo, hi)). Ranges
+// run concurrently, so fn must be safe to call from several threads.
+template <typename Container, typename Function>
+void parallel_for_each(Container &container, Function fn);
+template <typename Container, typename Function>
+void parallel_for_each(Container &container,
+                       const typename Container::key_type &lo,
+                       const typename Container::key_type &hi, Function fn);
+
+// Folds each range with op(acc, element), starting from init, and folds the
+// per-range results with combine(acc, acc) in key order. init must be an
+// identity of combine: every range starts from a copy of it. When T has
+// operator==, an init with combine(init, init) != init throws
+// std::invalid_argument. The ranges do not depend on the number of threads,
+// so for a given container the result is the same on every run.
+template <typename Container, typename T, typename Op, typename Combine>
+T parallel_reduce(const Container &container, T init, Op op, Combine combine);
+template <typename Container, typename T, typename Op, typename Combine>
+T parallel_reduce(const Container &container,
+                  const typename Container::key_type &lo,
+                  const typename Container::key_type &hi, T init, Op op,
+                  Combine combine);
+
+// Runs task(i) for every i in [0, count) on up to one thread per core and
+// rethrows the first exception once all threads have finished.
+template <typename Task>
+void RunParallel(std::size_t count, Task task);
+
+}  // namespace RBtreeMapSet
+
+#include "parallel.tpp"
+#endif  // CONTAINERS_PARALLEL_H_
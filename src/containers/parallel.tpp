@@ -0,0 +1,168 @@
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "parallel.h"
+
+namespace RBtreeMapSet {
+
+// Number of ranges the elements are cut into. It is fixed rather than taken
+// from the core count so that reductions group elements the same way on
+// every machine; several ranges per core even out uneven subtrees.
+inline constexpr std::size_t kParallelParts = 64;
+
+// Containers smaller than this are processed on the calling thread.
+inline constexpr std::size_t kParallelMinSize = 1 << 14;
+
+template <typename Container>
+std::size_t ParallelParts(const Container &container) {
+  return container.size() < kParallelMinSize ? 1 : kParallelParts;
+}
+
+template <typename Bounds, typename Function>
+void ForEachInRanges(const Bounds &bounds, Function &fn) {
+  if (bounds.size() < 2) {
+    return;
+  }
+
+  RunParallel(bounds.size() - 1, [&bounds, &fn](std::size_t part) {
+    for (auto it = bounds[part]; it != bounds[part + 1]; ++it) {
+      fn(*it);
+    }
+  });
+}
+
+template <typename T, typename = void>
+struct IsEqualityComparable : std::false_type {};
+
+template <typename T>
+struct IsEqualityComparable<T, std::void_t<decltype(std::declval<const T &>() ==
+                                                    std::declval<const T &>())>>
+    : std::true_type {};
+
+// Every range starts from its own copy of init, so a reduction only gives
+// the same result for every container size if init is an identity of
+// combine. An init that combine changes when combined with itself, such as
+// a nonzero start for a sum, is not, and is rejected whatever the size.
+template <typename T, typename Combine>
+void CheckIdentity(const T &init, Combine &combine) {
+  if constexpr (IsEqualityComparable<T>::value) {
+    if (!static_cast<bool>(combine(T(init), T(init)) == init)) {
+      throw std::invalid_argument(
+          "parallel_reduce: init must be an identity of combine");
+    }
+  }
+}
+
+template <typename Bounds, typename T, typename Op, typename Combine>
+T ReduceRanges(const Bounds &bounds, T init, Op &op, Combine &combine) {
+  CheckIdentity(init, combine);
+  if (bounds.size() < 2) {
+    return init;
+  }
+
+  std::vector<T> results(bounds.size() - 1, init);
+  RunParallel(results.size(), [&bounds, &op, &results](std::size_t part) {
+    T acc = std::move(results[part]);
+    for (auto it = bounds[part]; it != bounds[part + 1]; ++it) {
+      acc = op(std::move(acc), *it);
+    }
+    results[part] = std::move(acc);
+  });
+
+  T res = std::move(results[0]);
+  for (std::size_t part = 1; part < results.size(); ++part) {
+    res = combine(std::move(res), std::move(results[part]));
+  }
+
+  return res;
+}
+
+template <typename Task>
+void RunParallel(std::size_t count, Task task) {
+  std::size_t thread_count =
+      std::min<std::size_t>(std::thread::hardware_concurrency(), count);
+
+  if (thread_count <= 1) {
+    for (std::size_t i = 0; i < count; ++i) {
+      task(i);
+    }
+    return;
+  }
+
+  std::atomic<std::size_t> next{0};
+  std::exception_ptr error;
+  std::mutex error_mutex;
+
+  auto worker = [&]() {
+    for (std::size_t i = next++; i < count; i = next++) {
+      try {
+        task(i);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (!error) {
+          error = std::current_exception();
+        }
+        next = count;
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(thread_count - 1);
+  try {
+    for (std::size_t i = 1; i < thread_count; ++i) {
+      threads.emplace_back(worker);
+    }
+  } catch (...) {
+    next = count;
+    for (std::thread &thread : threads) {
+      thread.join();
+    }
+    throw;
+  }
+
+  worker();
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+template <typename Container, typename Function>
+void parallel_for_each(Container &container, Function fn) {
+  ForEachInRanges(container.split(ParallelParts(container)), fn);
+}
+
+template <typename Container, typename Function>
+void parallel_for_each(Container &container,
+                       const typename Container::key_type &lo,
+                       const typename Container::key_type &hi, Function fn) {
+  ForEachInRanges(container.split(ParallelParts(container), lo, hi), fn);
+}
+
+template <typename Container, typename T, typename Op, typename Combine>
+T parallel_reduce(const Container &container, T init, Op op, Combine combine) {
+  return ReduceRanges(container.split(ParallelParts(container)),
+                      std::move(init), op, combine);
+}
+
+template <typename Container, typename T, typename Op, typename Combine>
+T parallel_reduce(const Container &container,
+                  const typename Container::key_type &lo,
+                  const typename Container::key_type &hi, T init, Op op,
+                  Combine combine) {
+  return ReduceRanges(container.split(ParallelParts(container), lo, hi),
+                      std::move(init), op, combine);
+}
+
+}  // namespace RBtreeMapSet
@@ -0,0 +1,283 @@
+#ifndef CONTAINERS_RADIX_TREE_RADIX_TREE_H_
+#define CONTAINERS_RADIX_TREE_RADIX_TREE_H_
+
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace RBtreeMapSet {
+
+// Value of a RadixTree that only stores keys.
+struct RadixNoValue {};
+
+// Iterators of a RadixTree map yield a pair of references built on the fly;
+// operator-> hands out a pointer to such a pair that lives in this proxy.
+template <typename Reference>
+struct ArrowProxy {
+  Reference *operator->() noexcept { return &ref; }
+
+  Reference ref;
+};
+
+// [begin(), end()) of the elements whose key starts with a prefix.
+template <typename It>
+struct PrefixRange {
+  It begin() const { return first; }
+  It end() const { return last; }
+  bool empty() const { return first == last; }
+
+  It first;
+  It last;
+};
+
+// Ordered storage for string keys as a compressed radix tree. Every edge is
+// labelled with the bytes it adds to the key, stored inline at the end of its
+// node, so a prefix shared by many keys is stored once. Lookups read each
+// byte of the key once and pick a child by its first byte, instead of
+// comparing whole strings O(log n) times. Keys are ordered like std::string,
+// byte by byte as unsigned char.
+//
+// Nodes do not hold their key: an iterator rebuilds it while it moves and
+// keeps it, so *it refers into the iterator. Set iterators (Value is
+// RadixNoValue) yield the key, map iterators yield a pair of references to
+// the key and the value. Inserts and erases leave the other elements in
+// place, so their iterators and references stay valid; for that reason an
+// erase does not merge a node with its only child, and the copies of a tree
+// are not tighter than the tree itself.
+template <typename Value = RadixNoValue>
+class RadixTree {
+ private:
+  struct Node;
+  struct Iterator;
+  struct IteratorConst;
+
+ public:
+  static constexpr bool kIsSet = std::is_same_v<Value, RadixNoValue>;
+
+  using key_type = std::string;
+  using mapped_type = Value;
+  using iterator = Iterator;
+  using const_iterator = IteratorConst;
+  using size_type = std::size_t;
+
+  RadixTree();
+  RadixTree(const RadixTree &other);
+  RadixTree(RadixTree &&other) noexcept;
+  RadixTree &operator=(const RadixTree &other);
+  RadixTree &operator=(RadixTree &&other) noexcept;
+  ~RadixTree();
+
+  void RemoveTree() noexcept;
+
+  iterator Begin() noexcept;
+  const_iterator Begin() const noexcept;
+  iterator End() noexcept;
+  const_iterator End() const noexcept;
+
+  bool isEmpty() const noexcept;
+  size_type GetSize() const noexcept;
+  size_type GetMaxSize() const noexcept;
+
+  // Constructs the value from args only if key is not stored yet.
+  template <typename... Args>
+  std::pair<iterator, bool> Insert(std::string_view key, Args &&...args);
+  void Erase(iterator position) noexcept;
+  void SwapTree(RadixTree &other) noexcept;
+  void Merge(RadixTree &other);
+  iterator Find(std::string_view key);
+  bool Contains(std::string_view key) const noexcept;
+  iterator LowerBound(std::string_view key);
+  PrefixRange<iterator> WithPrefix(std::string_view prefix);
+
+ private:
+  struct Node {
+    explicit Node(std::uint32_t size) noexcept : label_size(size) {}
+    ~Node() { ::operator delete(edges); }
+
+    Node **Children() const noexcept { return static_cast<Node **>(edges); }
+
+    unsigned char *Bytes() const noexcept {
+      return reinterpret_cast<unsigned char *>(Children() + edge_capacity);
+    }
+
+    char *Label() noexcept { return reinterpret_cast<char *>(this + 1); }
+
+    std::string_view GetLabel() const noexcept {
+      return {reinterpret_cast<const char *>(this + 1), label_size};
+    }
+
+    Node *parent = nullptr;
+    // edge_capacity child pointers followed by the first byte of the label
+    // of each child, both sorted by that byte.
+    void *edges = nullptr;
+    std::uint32_t label_size;
+    std::uint16_t edge_count = 0;
+    std::uint16_t edge_capacity = 0;
+    std::optional<Value> value;
+  };
+
+  static Node *NewNode(std::string_view label);
+  static void DeleteNode(Node *node) noexcept;
+  static void RemoveNode(Node *node) noexcept;
+  static Node *CopyNode(const Node *node, Node *parent);
+  template <typename... Args>
+  static Node *NewLeaf(std::string_view label, Args &&...args);
+  static void InsertEdge(Node *node, size_type index, Node *child);
+  static void RemoveEdge(Node *node, size_type index) noexcept;
+  static size_type FindEdge(const Node *node, unsigned char byte) noexcept;
+  static size_type IndexOf(const Node *child) noexcept;
+  static Node *FindNode(Node *root, std::string_view key) noexcept;
+  static size_type CommonPrefix(std::string_view label,
+                                std::string_view key) noexcept;
+  template <typename... Args>
+  Node *Split(Node *node, size_type index, size_type common,
+              std::string_view rest, Args &&...args);
+
+  static Node *First(Node *node, std::string &key);
+  static Node *Last(Node *node, std::string &key);
+  static Node *Next(Node *node, const Node *root, std::string &key);
+  static Node *After(Node *node, const Node *root, std::string &key);
+  static Node *Previous(Node *node, Node *root, std::string &key);
+  static std::string MakeKey(const Node *node);
+  iterator FirstIn(Node *node);
+  iterator AfterSubtree(Node *node);
+
+  struct Iterator {
+    using iterator_category = std::bidirectional_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type =
+        std::conditional_t<kIsSet, std::string,
+                           std::pair<const std::string, Value>>;
+    using reference =
+        std::conditional_t<kIsSet, const std::string &,
+                           std::pair<const std::string &, Value &>>;
+    using pointer = std::conditional_t<kIsSet, const std::string *,
+                                       ArrowProxy<reference>>;
+
+    Iterator() = delete;
+
+    Iterator(Node *node, Node *root, std::string key = {})
+        : node_(node), root_(root), key_(std::move(key)) {}
+
+    reference operator*() const noexcept {
+      if constexpr (kIsSet) {
+        return key_;
+      } else {
+        return {key_, *node_->value};
+      }
+    }
+
+    pointer operator->() const noexcept {
+      if constexpr (kIsSet) {
+        return &key_;
+      } else {
+        return {**this};
+      }
+    }
+
+    iterator &operator++() {
+      node_ = Next(node_, root_, key_);
+      return *this;
+    }
+
+    iterator operator++(int) {
+      iterator tmp{*this};
+      ++(*this);
+      return tmp;
+    }
+
+    iterator &operator--() {
+      node_ = Previous(node_, root_, key_);
+      return *this;
+    }
+
+    iterator operator--(int) {
+      iterator tmp{*this};
+      --(*this);
+      return tmp;
+    }
+
+    bool operator==(const iterator &other) const noexcept {
+      return node_ == other.node_;
+    }
+
+    bool operator!=(const iterator &other) const noexcept {
+      return node_ != other.node_;
+    }
+
+    Node *node_;
+    Node *root_;
+    std::string key_;
+  };
+
+  struct IteratorConst {
+    using iterator_category = std::bidirectional_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = typename Iterator::value_type;
+    using reference =
+        std::conditional_t<kIsSet, const std::string &,
+                           std::pair<const std::string &, const Value &>>;
+    using pointer = std::conditional_t<kIsSet, const std::string *,
+                                       ArrowProxy<reference>>;
+
+    IteratorConst() = delete;
+
+    IteratorConst(const iterator &it) : it_(it) {}
+
+    reference operator*() const noexcept { return *it_; }
+
+    pointer operator->() const noexcept {
+      if constexpr (kIsSet) {
+        return &*it_;
+      } else {
+        return {**this};
+      }
+    }
+
+    const_iterator &operator++() {
+      ++it_;
+      return *this;
+    }
+
+    const_iterator operator++(int) {
+      const_iterator tmp{*this};
+      ++it_;
+      return tmp;
+    }
+
+    const_iterator &operator--() {
+      --it_;
+      return *this;
+    }
+
+    const_iterator operator--(int) {
+      const_iterator tmp{*this};
+      --it_;
+      return tmp;
+    }
+
+    friend bool operator==(const const_iterator &it1,
+                           const const_iterator &it2) noexcept {
+      return it1.it_ == it2.it_;
+    }
+
+    friend bool operator!=(const const_iterator &it1,
+                           const const_iterator &it2) noexcept {
+      return it1.it_ != it2.it_;
+    }
+
+    iterator it_;
+  };
+
+  Node *root;
+  size_type tree_size;
+};
+
+}  // namespace RBtreeMapSet
+
+#include "radix_tree.tpp"
+#endif  // CONTAINERS_RADIX_TREE_RADIX_TREE_H_
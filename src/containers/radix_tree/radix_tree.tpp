@@ -0,0 +1,618 @@
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <new>
+
+#include "radix_tree.h"
+
+namespace RBtreeMapSet {
+
+template <typename Value>
+RadixTree<Value>::RadixTree() : root(NewNode({})), tree_size(0) {}
+
+template <typename Value>
+RadixTree<Value>::RadixTree(const RadixTree &other)
+    : root(CopyNode(other.root, nullptr)), tree_size(other.tree_size) {}
+
+template <typename Value>
+RadixTree<Value>::RadixTree(RadixTree &&other) noexcept : RadixTree() {
+  SwapTree(other);
+}
+
+template <typename Value>
+RadixTree<Value> &RadixTree<Value>::operator=(const RadixTree &other) {
+  if (this != &other) {
+    RadixTree copy(other);
+    SwapTree(copy);
+  }
+  return *this;
+}
+
+template <typename Value>
+RadixTree<Value> &RadixTree<Value>::operator=(RadixTree &&other) noexcept {
+  RemoveTree();
+  SwapTree(other);
+  return *this;
+}
+
+template <typename Value>
+RadixTree<Value>::~RadixTree() {
+  RemoveNode(root);
+  root = nullptr;
+}
+
+template <typename Value>
+typename RadixTree<Value>::Node *RadixTree<Value>::NewNode(
+    std::string_view label) {
+  void *memory = ::operator new(sizeof(Node) + label.size());
+  Node *node = ::new (memory) Node(static_cast<std::uint32_t>(label.size()));
+  if (!label.empty()) {
+    std::memcpy(node->Label(), label.data(), label.size());
+  }
+  return node;
+}
+
+template <typename Value>
+void RadixTree<Value>::DeleteNode(Node *node) noexcept {
+  node->~Node();
+  ::operator delete(node);
+}
+
+template <typename Value>
+void RadixTree<Value>::RemoveNode(Node *node) noexcept {
+  if (!node) {
+    return;
+  }
+
+  for (size_type i = 0; i < node->edge_count; ++i) {
+    RemoveNode(node->Children()[i]);
+  }
+  DeleteNode(node);
+}
+
+template <typename Value>
+typename RadixTree<Value>::Node *RadixTree<Value>::CopyNode(const Node *node,
+                                                            Node *parent) {
+  Node *copy = NewNode(node->GetLabel());
+  copy->parent = parent;
+
+  try {
+    if (node->value) {
+      copy->value.emplace(*node->value);
+    }
+
+    if (node->edge_count) {
+      copy->edges = ::operator new(node->edge_count * (sizeof(Node *) + 1));
+      copy->edge_capacity = node->edge_count;
+    }
+
+    for (size_type i = 0; i < node->edge_count; ++i) {
+      copy->Bytes()[i] = node->Bytes()[i];
+      copy->Children()[i] = CopyNode(node->Children()[i], copy);
+      ++copy->edge_count;
+    }
+  } catch (...) {
+    RemoveNode(copy);
+    throw;
+  }
+
+  return copy;
+}
+
+template <typename Value>
+void RadixTree<Value>::RemoveTree() noexcept {
+  for (size_type i = 0; i < root->edge_count; ++i) {
+    RemoveNode(root->Children()[i]);
+  }
+  ::operator delete(root->edges);
+  root->edges = nullptr;
+  root->edge_count = 0;
+  root->edge_capacity = 0;
+  root->value.reset();
+  tree_size = 0;
+}
+
+template <typename Value>
+typename RadixTree<Value>::iterator RadixTree<Value>::Begin() noexcept {
+  if (tree_size == 0) {
+    return End();
+  }
+
+  return FirstIn(root);
+}
+
+template <typename Value>
+typename RadixTree<Value>::const_iterator RadixTree<Value>::Begin()
+    const noexcept {
+  return const_cast<RadixTree *>(this)->Begin();
+}
+
+template <typename Value>
+typename RadixTree<Value>::iterator RadixTree<Value>::End() noexcept {
+  return iterator(nullptr, root);
+}
+
+template <typename Value>
+typename RadixTree<Value>::const_iterator RadixTree<Value>::End()
+    const noexcept {
+  return const_cast<RadixTree *>(this)->End();
+}
+
+template <typename Value>
+bool RadixTree<Value>::isEmpty() const noexcept {
+  return tree_size == 0;
+}
+
+template <typename Value>
+typename RadixTree<Value>::size_type RadixTree<Value>::GetSize()
+    const noexcept {
+  return tree_size;
+}
+
+template <typename Value>
+typename RadixTree<Value>::size_type RadixTree<Value>::GetMaxSize()
+    const noexcept {
+  return (std::numeric_limits<size_type>::max() / 2) / sizeof(Node);
+}
+
+template <typename Value>
+template <typename... Args>
+std::pair<typename RadixTree<Value>::iterator, bool> RadixTree<Value>::Insert(
+    std::string_view key, Args &&...args) {
+  Node *node = root;
+  size_type pos = 0;
+
+  while (pos < key.size()) {
+    unsigned char byte = key[pos];
+    size_type index = FindEdge(node, byte);
+
+    if (index == node->edge_count || node->Bytes()[index] != byte) {
+      Node *leaf = NewLeaf(key.substr(pos), std::forward<Args>(args)...);
+      try {
+        InsertEdge(node, index, leaf);
+      } catch (...) {
+        DeleteNode(leaf);
+        throw;
+      }
+      ++tree_size;
+      return {iterator(leaf, root, std::string(key)), true};
+    }
+
+    Node *child = node->Children()[index];
+    size_type common = CommonPrefix(child->GetLabel(), key.substr(pos));
+    if (common < child->label_size) {
+      Node *res = Split(node, index, common, key.substr(pos + common),
+                        std::forward<Args>(args)...);
+      ++tree_size;
+      return {iterator(res, root, std::string(key)), true};
+    }
+
+    node = child;
+    pos += common;
+  }
+
+  if (node->value) {
+    return {iterator(node, root, std::string(key)), false};
+  }
+
+  node->value.emplace(std::forward<Args>(args)...);
+  ++tree_size;
+  return {iterator(node, root, std::string(key)), true};
+}
+
+template <typename Value>
+template <typename... Args>
+typename RadixTree<Value>::Node *RadixTree<Value>::NewLeaf(
+    std::string_view label, Args &&...args) {
+  Node *leaf = NewNode(label);
+
+  try {
+    leaf->value.emplace(std::forward<Args>(args)...);
+  } catch (...) {
+    DeleteNode(leaf);
+    throw;
+  }
+
+  return leaf;
+}
+
+// Puts a node for the first common bytes of the label of the child at index
+// between node and that child, and hangs the key there or below it. Every
+// allocation happens before the tree is touched.
+template <typename Value>
+template <typename... Args>
+typename RadixTree<Value>::Node *RadixTree<Value>::Split(
+    Node *node, size_type index, size_type common, std::string_view rest,
+    Args &&...args) {
+  Node *child = node->Children()[index];
+  Node *middle = NewNode(child->GetLabel().substr(0, common));
+  Node *leaf = nullptr;
+
+  try {
+    std::uint16_t edge_count = rest.empty() ? 1 : 2;
+    middle->edges = ::operator new(edge_count * (sizeof(Node *) + 1));
+    middle->edge_capacity = edge_count;
+
+    if (rest.empty()) {
+      middle->value.emplace(std::forward<Args>(args)...);
+    } else {
+      leaf = NewLeaf(rest, std::forward<Args>(args)...);
+    }
+  } catch (...) {
+    DeleteNode(middle);
+    throw;
+  }
+
+  // The child keeps the rest of its label in its own node, so it does not
+  // move.
+  child->label_size -= common;
+  std::memmove(child->Label(), child->Label() + common, child->label_size);
+  child->parent = middle;
+  middle->parent = node;
+  node->Children()[index] = middle;
+
+  middle->Children()[0] = child;
+  middle->Bytes()[0] = child->Label()[0];
+  middle->edge_count = 1;
+
+  if (leaf) {
+    InsertEdge(middle, FindEdge(middle, leaf->Label()[0]), leaf);
+    return leaf;
+  }
+
+  return middle;
+}
+
+template <typename Value>
+void RadixTree<Value>::InsertEdge(Node *node, size_type index, Node *child) {
+  if (node->edge_count == node->edge_capacity) {
+    size_type capacity = std::min<size_type>(
+        node->edge_count + 1 + node->edge_count / 4, 256);
+    void *edges = ::operator new(capacity * (sizeof(Node *) + 1));
+    Node **children = static_cast<Node **>(edges);
+    unsigned char *bytes =
+        reinterpret_cast<unsigned char *>(children + capacity);
+
+    std::copy_n(node->Children(), node->edge_count, children);
+    std::copy_n(node->Bytes(), node->edge_count, bytes);
+    ::operator delete(node->edges);
+    node->edges = edges;
+    node->edge_capacity = static_cast<std::uint16_t>(capacity);
+  }
+
+  Node **children = node->Children();
+  unsigned char *bytes = node->Bytes();
+  std::copy_backward(children + index, children + node->edge_count,
+                     children + node->edge_count + 1);
+  std::copy_backward(bytes + index, bytes + node->edge_count,
+                     bytes + node->edge_count + 1);
+  children[index] = child;
+  bytes[index] = child->Label()[0];
+  child->parent = node;
+  ++node->edge_count;
+}
+
+template <typename Value>
+void RadixTree<Value>::RemoveEdge(Node *node, size_type index) noexcept {
+  Node **children = node->Children();
+  unsigned char *bytes = node->Bytes();
+  std::copy(children + index + 1, children + node->edge_count,
+            children + index);
+  std::copy(bytes + index + 1, bytes + node->edge_count, bytes + index);
+
+  if (--node->edge_count == 0) {
+    ::operator delete(node->edges);
+    node->edges = nullptr;
+    node->edge_capacity = 0;
+  }
+}
+
+template <typename Value>
+typename RadixTree<Value>::size_type RadixTree<Value>::FindEdge(
+    const Node *node, unsigned char byte) noexcept {
+  const unsigned char *bytes = node->Bytes();
+  return std::lower_bound(bytes, bytes + node->edge_count, byte) - bytes;
+}
+
+template <typename Value>
+typename RadixTree<Value>::size_type RadixTree<Value>::IndexOf(
+    const Node *child) noexcept {
+  return FindEdge(child->parent,
+                  static_cast<unsigned char>(child->GetLabel()[0]));
+}
+
+template <typename Value>
+typename RadixTree<Value>::size_type RadixTree<Value>::CommonPrefix(
+    std::string_view label, std::string_view key) noexcept {
+  size_type length = std::min(label.size(), key.size());
+  size_type common = 0;
+
+  while (common < length && label[common] == key[common]) {
+    ++common;
+  }
+
+  return common;
+}
+
+template <typename Value>
+void RadixTree<Value>::Erase(iterator position) noexcept {
+  Node *node = position.node_;
+
+  if (!node) {
+    return;
+  }
+
+  node->value.reset();
+  --tree_size;
+
+  // Nodes without a value that no longer lead to one go away; a node left
+  // with a single child stays, since merging would move that child.
+  while (node != root && !node->value && node->edge_count == 0) {
+    Node *parent = node->parent;
+    RemoveEdge(parent, IndexOf(node));
+    DeleteNode(node);
+    node = parent;
+  }
+}
+
+template <typename Value>
+void RadixTree<Value>::SwapTree(RadixTree &other) noexcept {
+  std::swap(root, other.root);
+  std::swap(tree_size, other.tree_size);
+}
+
+template <typename Value>
+void RadixTree<Value>::Merge(RadixTree &other) {
+  if (this == &other) {
+    return;
+  }
+
+  iterator it = other.Begin();
+  while (it != other.End()) {
+    iterator next = it;
+    ++next;
+    if (Insert(it.key_, std::move(*it.node_->value)).second) {
+      other.Erase(it);
+    }
+    it = next;
+  }
+}
+
+template <typename Value>
+typename RadixTree<Value>::iterator RadixTree<Value>::Find(
+    std::string_view key) {
+  Node *node = FindNode(root, key);
+
+  if (!node) {
+    return End();
+  }
+
+  return iterator(node, root, std::string(key));
+}
+
+template <typename Value>
+bool RadixTree<Value>::Contains(std::string_view key) const noexcept {
+  return FindNode(root, key) != nullptr;
+}
+
+template <typename Value>
+typename RadixTree<Value>::Node *RadixTree<Value>::FindNode(
+    Node *root, std::string_view key) noexcept {
+  Node *node = root;
+  size_type pos = 0;
+
+  while (pos < key.size()) {
+    unsigned char byte = key[pos];
+    size_type index = FindEdge(node, byte);
+
+    if (index == node->edge_count || node->Bytes()[index] != byte) {
+      return nullptr;
+    }
+
+    node = node->Children()[index];
+    if (key.substr(pos, node->label_size) != node->GetLabel()) {
+      return nullptr;
+    }
+    pos += node->label_size;
+  }
+
+  return node->value ? node : nullptr;
+}
+
+template <typename Value>
+typename RadixTree<Value>::iterator RadixTree<Value>::LowerBound(
+    std::string_view key) {
+  if (tree_size == 0) {
+    return End();
+  }
+
+  Node *node = root;
+  size_type pos = 0;
+
+  while (pos < key.size()) {
+    unsigned char byte = key[pos];
+    size_type index = FindEdge(node, byte);
+
+    if (index == node->edge_count) {
+      return AfterSubtree(node);
+    }
+
+    Node *child = node->Children()[index];
+    if (node->Bytes()[index] != byte) {
+      return FirstIn(child);
+    }
+
+    std::string_view rest = key.substr(pos);
+    size_type common = CommonPrefix(child->GetLabel(), rest);
+    if (common == child->label_size) {
+      node = child;
+      pos += common;
+      continue;
+    }
+
+    // The key ends inside the label or is smaller at the first difference:
+    // the whole subtree comes after it. Otherwise it comes before.
+    if (common == rest.size() ||
+        static_cast<unsigned char>(child->GetLabel()[common]) >
+            static_cast<unsigned char>(rest[common])) {
+      return FirstIn(child);
+    }
+    return AfterSubtree(child);
+  }
+
+  return FirstIn(node);
+}
+
+template <typename Value>
+PrefixRange<typename RadixTree<Value>::iterator> RadixTree<Value>::WithPrefix(
+    std::string_view prefix) {
+  if (tree_size == 0) {
+    return {End(), End()};
+  }
+
+  Node *node = root;
+  size_type pos = 0;
+
+  while (pos < prefix.size()) {
+    unsigned char byte = prefix[pos];
+    size_type index = FindEdge(node, byte);
+
+    if (index == node->edge_count || node->Bytes()[index] != byte) {
+      return {End(), End()};
+    }
+
+    node = node->Children()[index];
+    std::string_view rest = prefix.substr(pos);
+    size_type common = CommonPrefix(node->GetLabel(), rest);
+    if (common == rest.size()) {
+      break;
+    }
+    if (common < node->label_size) {
+      return {End(), End()};
+    }
+    pos += common;
+  }
+
+  return {FirstIn(node), AfterSubtree(node)};
+}
+
+// Every node below the root either has a value or leads to one, so the
+// smallest key of a subtree is reached by always taking the first child.
+template <typename Value>
+typename RadixTree<Value>::Node *RadixTree<Value>::First(Node *node,
+                                                         std::string &key) {
+  while (!node->value) {
+    node = node->Children()[0];
+    key.append(node->GetLabel());
+  }
+
+  return node;
+}
+
+template <typename Value>
+typename RadixTree<Value>::Node *RadixTree<Value>::Last(Node *node,
+                                                        std::string &key) {
+  while (node->edge_count) {
+    node = node->Children()[node->edge_count - 1];
+    key.append(node->GetLabel());
+  }
+
+  return node;
+}
+
+template <typename Value>
+typename RadixTree<Value>::Node *RadixTree<Value>::Next(Node *node,
+                                                        const Node *root,
+                                                        std::string &key) {
+  if (node->edge_count) {
+    node = node->Children()[0];
+    key.append(node->GetLabel());
+    return First(node, key);
+  }
+
+  return After(node, root, key);
+}
+
+// First key after the subtree of node, or nullptr.
+template <typename Value>
+typename RadixTree<Value>::Node *RadixTree<Value>::After(Node *node,
+                                                         const Node *root,
+                                                         std::string &key) {
+  while (node != root) {
+    Node *parent = node->parent;
+    size_type index = IndexOf(node);
+    key.resize(key.size() - node->label_size);
+
+    if (index + 1 < parent->edge_count) {
+      node = parent->Children()[index + 1];
+      key.append(node->GetLabel());
+      return First(node, key);
+    }
+    node = parent;
+  }
+
+  key.clear();
+  return nullptr;
+}
+
+template <typename Value>
+typename RadixTree<Value>::Node *RadixTree<Value>::Previous(Node *node,
+                                                            Node *root,
+                                                            std::string &key) {
+  if (!node) {
+    key.clear();
+    return Last(root, key);
+  }
+
+  while (node != root) {
+    Node *parent = node->parent;
+    size_type index = IndexOf(node);
+    key.resize(key.size() - node->label_size);
+
+    if (index > 0) {
+      node = parent->Children()[index - 1];
+      key.append(node->GetLabel());
+      return Last(node, key);
+    }
+
+    node = parent;
+    if (node->value) {
+      return node;
+    }
+  }
+
+  return nullptr;
+}
+
+template <typename Value>
+std::string RadixTree<Value>::MakeKey(const Node *node) {
+  size_type size = 0;
+  for (const Node *it = node; it; it = it->parent) {
+    size += it->label_size;
+  }
+
+  std::string key(size, '\0');
+  for (const Node *it = node; it; it = it->parent) {
+    size -= it->label_size;
+    std::memcpy(key.data() + size, it->GetLabel().data(), it->label_size);
+  }
+
+  return key;
+}
+
+template <typename Value>
+typename RadixTree<Value>::iterator RadixTree<Value>::FirstIn(Node *node) {
+  iterator it(nullptr, root, MakeKey(node));
+  it.node_ = First(node, it.key_);
+  return it;
+}
+
+template <typename Value>
+typename RadixTree<Value>::iterator RadixTree<Value>::AfterSubtree(
+    Node *node) {
+  iterator it(nullptr, root, MakeKey(node));
+  it.node_ = After(node, root, it.key_);
+  return it;
+}
+
+}  // namespace RBtreeMapSet
@@ -0,0 +1,29 @@
+#ifndef CONTAINERS_RED_BLACK_TREE_AUGMENT_H_
+#define CONTAINERS_RED_BLACK_TREE_AUGMENT_H_
+
+namespace RBtreeMapSet {
+
+// Augment policies let RedBlackTree keep a summary of every subtree in its
+// nodes. Each node derives from Augment::Data<Key>, and Update(node) must
+// recompute the summary from the node's key, the rest of its data and its
+// children, any of which may be nullptr. The tree calls Update bottom-up
+// whenever the children of a node change: on insert and erase, in rotations
+// and when bulk builds link nodes; copies and Compact take the data of the
+// nodes they copy. Data may also hold per-node fields set by the owner of
+// the tree, which then calls RefreshAugment. SearchAugmented walks the tree
+// using the data to skip subtrees.
+//
+// NoAugment keeps no data and costs nothing.
+struct NoAugment {
+  static constexpr bool kEnabled = false;
+
+  template <typename Key>
+  struct Data {};
+
+  template <typename Node>
+  static void Update(Node *) noexcept {}
+};
+
+}  // namespace RBtreeMapSet
+
+#endif  // CONTAINERS_RED_BLACK_TREE_AUGMENT_H_
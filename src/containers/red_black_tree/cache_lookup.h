@@ -0,0 +1,68 @@
+#ifndef CONTAINERS_RED_BLACK_TREE_CACHE_LOOKUP_H_
+#define CONTAINERS_RED_BLACK_TREE_CACHE_LOOKUP_H_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+
+#include "tree_lookup.h"
+
+namespace RBtreeMapSet {
+
+// Lookup policy that remembers the nodes of recently found keys in a
+// direct-mapped cache of Slots entries, so keys that are looked up often are
+// found in constant time and the others pay one extra probe before the tree
+// descent. A key found in the tree takes over its slot unless the entry there
+// was hit since it last resisted eviction (a second chance), which keeps hot
+// keys cached under a stream of cold lookups. Hash must not throw.
+//
+// Lookups write the cache, so its fields are relaxed atomics: const lookups
+// may run concurrently as with a plain map. A reader may see a slot half
+// rewritten by another, but it only returns the node after comparing that
+// node's key with the one it looks for, and nodes are not freed while only
+// readers run.
+template <typename Hash, std::size_t Slots = 1024>
+struct CacheLookup {
+  static_assert(Slots != 0 && (Slots & (Slots - 1)) == 0,
+                "the number of cache slots must be a power of two");
+
+  template <typename Key, typename Node>
+  class Index {
+   public:
+    static constexpr bool kComplete = false;
+
+    void Reserve(std::size_t) {}
+    void Insert(Node *) noexcept {}
+    void Erase(const Node *node) noexcept;
+    void Clear() noexcept;
+
+    template <typename Equal>
+    Node *Find(const Key &key, Equal equal) noexcept;
+
+    void Touch(Node *node) noexcept;
+    std::size_t GetMemoryUsage() const noexcept;
+
+   private:
+    struct Slot {
+      Slot() = default;
+      Slot(const Slot &other) noexcept;
+      Slot &operator=(const Slot &other) noexcept;
+
+      void Store(std::size_t key_hash, Node *key_node,
+                 bool is_referenced) noexcept;
+
+      std::atomic<std::size_t> hash{0};
+      std::atomic<Node *> node{nullptr};
+      std::atomic<bool> referenced{false};
+    };
+
+    std::array<Slot, Slots> slots{};
+    Hash hash;
+  };
+};
+
+}  // namespace RBtreeMapSet
+
+#include "cache_lookup.tpp"
+#endif  // CONTAINERS_RED_BLACK_TREE_CACHE_LOOKUP_H_
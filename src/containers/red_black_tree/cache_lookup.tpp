@@ -0,0 +1,96 @@
+#include "cache_lookup.h"
+
+namespace RBtreeMapSet {
+
+template <typename Hash, std::size_t Slots>
+template <typename Key, typename Node>
+CacheLookup<Hash, Slots>::Index<Key, Node>::Slot::Slot(
+    const Slot &other) noexcept {
+  *this = other;
+}
+
+template <typename Hash, std::size_t Slots>
+template <typename Key, typename Node>
+typename CacheLookup<Hash, Slots>::template Index<Key, Node>::Slot &
+CacheLookup<Hash, Slots>::Index<Key, Node>::Slot::operator=(
+    const Slot &other) noexcept {
+  Store(other.hash.load(std::memory_order_relaxed),
+        other.node.load(std::memory_order_relaxed),
+        other.referenced.load(std::memory_order_relaxed));
+  return *this;
+}
+
+template <typename Hash, std::size_t Slots>
+template <typename Key, typename Node>
+void CacheLookup<Hash, Slots>::Index<Key, Node>::Slot::Store(
+    std::size_t key_hash, Node *key_node, bool is_referenced) noexcept {
+  hash.store(key_hash, std::memory_order_relaxed);
+  node.store(key_node, std::memory_order_relaxed);
+  referenced.store(is_referenced, std::memory_order_relaxed);
+}
+
+template <typename Hash, std::size_t Slots>
+template <typename Key, typename Node>
+void CacheLookup<Hash, Slots>::Index<Key, Node>::Erase(
+    const Node *node) noexcept {
+  Slot &slot = slots[HashKey(hash, node->key) & (Slots - 1)];
+
+  if (slot.node.load(std::memory_order_relaxed) == node) {
+    slot.Store(0, nullptr, false);
+  }
+}
+
+template <typename Hash, std::size_t Slots>
+template <typename Key, typename Node>
+void CacheLookup<Hash, Slots>::Index<Key, Node>::Clear() noexcept {
+  for (Slot &slot : slots) {
+    slot.Store(0, nullptr, false);
+  }
+}
+
+template <typename Hash, std::size_t Slots>
+template <typename Key, typename Node>
+template <typename Equal>
+Node *CacheLookup<Hash, Slots>::Index<Key, Node>::Find(const Key &key,
+                                                       Equal equal) noexcept {
+  std::size_t key_hash = HashKey(hash, key);
+  Slot &slot = slots[key_hash & (Slots - 1)];
+
+  Node *node = slot.node.load(std::memory_order_relaxed);
+
+  if (node && slot.hash.load(std::memory_order_relaxed) == key_hash &&
+      equal(node->key, key)) {
+    // Hot keys are hit over and over; only write when the flag changes so
+    // that readers on several cores do not keep taking the line from each
+    // other.
+    if (!slot.referenced.load(std::memory_order_relaxed)) {
+      slot.referenced.store(true, std::memory_order_relaxed);
+    }
+    return node;
+  }
+
+  return nullptr;
+}
+
+template <typename Hash, std::size_t Slots>
+template <typename Key, typename Node>
+void CacheLookup<Hash, Slots>::Index<Key, Node>::Touch(Node *node) noexcept {
+  std::size_t key_hash = HashKey(hash, node->key);
+  Slot &slot = slots[key_hash & (Slots - 1)];
+
+  if (slot.referenced.load(std::memory_order_relaxed)) {
+    slot.referenced.store(false, std::memory_order_relaxed);
+    return;
+  }
+
+  slot.Store(key_hash, node, false);
+}
+
+template <typename Hash, std::size_t Slots>
+template <typename Key, typename Node>
+std::size_t CacheLookup<Hash, Slots>::Index<Key, Node>::GetMemoryUsage()
+    const noexcept {
+  return sizeof(slots);
+}
+
+}  // namespace RBtreeMapSet
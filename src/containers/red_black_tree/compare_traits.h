@@ -0,0 +1,113 @@
+#ifndef CONTAINERS_RED_BLACK_TREE_COMPARE_TRAITS_H_
+#define CONTAINERS_RED_BLACK_TREE_COMPARE_TRAITS_H_
+
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+#if defined(__cpp_lib_three_way_comparison)
+#include <compare>
+#endif
+
+namespace RBtreeMapSet {
+
+// A comparator is three-way when it returns int (negative, zero or positive,
+// like std::string::compare) or, in C++20, one of the std orderings.
+// Otherwise it is treated as a strict weak "less" predicate.
+template <typename Compare, typename Key, typename = void>
+struct IsThreeWayCompare : std::false_type {};
+
+template <typename Compare, typename Key>
+struct IsThreeWayCompare<
+    Compare, Key,
+    std::enable_if_t<std::is_same_v<
+        std::decay_t<std::invoke_result_t<const Compare &, const Key &,
+                                          const Key &>>,
+        int>>> : std::true_type {};
+
+#if defined(__cpp_lib_three_way_comparison)
+template <typename Compare, typename Key>
+struct IsThreeWayCompare<
+    Compare, Key,
+    std::enable_if_t<std::is_convertible_v<
+        std::invoke_result_t<const Compare &, const Key &, const Key &>,
+        std::weak_ordering>>> : std::true_type {};
+#endif
+
+template <typename Key, typename = void>
+struct HasCompareMember : std::false_type {};
+
+template <typename Key>
+using CompareMemberResult = decltype(std::declval<const Key &>().compare(
+    std::declval<const Key &>()));
+
+template <typename Key>
+struct HasCompareMember<
+    Key, std::enable_if_t<std::is_same_v<CompareMemberResult<Key>, int>>>
+    : std::true_type {};
+
+template <typename Compare, typename Key>
+struct IsDefaultLess
+    : std::bool_constant<std::is_same_v<Compare, std::less<Key>> ||
+                         std::is_same_v<Compare, std::less<>>> {};
+
+// Chooses how the tree orders two keys. kThreeWay is true when a single call
+// tells apart "less", "equal" and "greater": for three-way comparators, for
+// std::less over keys with a compare() member (std::string) and, in C++20,
+// for std::less over keys with operator<=>.
+template <typename Compare, typename Key>
+struct CompareTraits {
+  static constexpr bool kNative = IsThreeWayCompare<Compare, Key>::value;
+  static constexpr bool kMember =
+      IsDefaultLess<Compare, Key>::value && HasCompareMember<Key>::value;
+#if defined(__cpp_lib_three_way_comparison)
+  static constexpr bool kSpaceship = IsDefaultLess<Compare, Key>::value &&
+                                     std::three_way_comparable<Key>;
+#else
+  static constexpr bool kSpaceship = false;
+#endif
+  static constexpr bool kThreeWay = kNative || kMember || kSpaceship;
+
+  static constexpr int ThreeWay(const Compare &cmp, const Key &key_1,
+                               const Key &key_2) {
+    if constexpr (kNative) {
+      return Sign(cmp(key_1, key_2));
+    } else if constexpr (kMember) {
+      return key_1.compare(key_2);
+    }
+#if defined(__cpp_lib_three_way_comparison)
+    else if constexpr (kSpaceship) {
+      return Sign(key_1 <=> key_2);
+    }
+#endif
+    else {
+      if (cmp(key_1, key_2)) {
+        return -1;
+      }
+      return cmp(key_2, key_1) ? 1 : 0;
+    }
+  }
+
+  static constexpr bool Less(const Compare &cmp, const Key &key_1,
+                             const Key &key_2) {
+    if constexpr (kNative) {
+      return Sign(cmp(key_1, key_2)) < 0;
+    } else {
+      return cmp(key_1, key_2);
+    }
+  }
+
+ private:
+  static constexpr int Sign(int res) noexcept { return res; }
+
+#if defined(__cpp_lib_three_way_comparison)
+  template <typename Ordering>
+  static constexpr int Sign(Ordering res) noexcept {
+    return res < 0 ? -1 : (res > 0 ? 1 : 0);
+  }
+#endif
+};
+
+}  // namespace RBtreeMapSet
+
+#endif  // CONTAINERS_RED_BLACK_TREE_COMPARE_TRAITS_H_
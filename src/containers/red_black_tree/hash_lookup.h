@@ -0,0 +1,55 @@
+#ifndef CONTAINERS_RED_BLACK_TREE_HASH_LOOKUP_H_
+#define CONTAINERS_RED_BLACK_TREE_HASH_LOOKUP_H_
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "tree_lookup.h"
+
+namespace RBtreeMapSet {
+
+// Lookup policy that keeps an open-addressing hash table from keys to tree
+// nodes, so exact lookups take O(1) expected time while ordered operations
+// still use the tree. Hash must not throw and must give equal hashes to keys
+// the tree comparator considers equivalent. For map it is applied to the key
+// of each element. The table holds two words per slot and is kept at most
+// half full.
+template <typename Hash>
+struct HashLookup {
+  template <typename Key, typename Node>
+  class Index {
+   public:
+    static constexpr bool kComplete = true;
+
+    void Reserve(std::size_t count);
+    void Insert(Node *node) noexcept;
+    void Erase(const Node *node) noexcept;
+    void Clear() noexcept;
+
+    template <typename Equal>
+    Node *Find(const Key &key, Equal equal) noexcept;
+
+    void Touch(Node *) noexcept {}
+    std::size_t GetMemoryUsage() const noexcept;
+
+   private:
+    struct Slot {
+      std::size_t hash;
+      Node *node;
+    };
+
+    static constexpr std::size_t kMinCapacity = 16;
+
+    void Place(Slot slot) noexcept;
+
+    std::vector<Slot> slots;
+    std::size_t size = 0;
+    Hash hash;
+  };
+};
+
+}  // namespace RBtreeMapSet
+
+#include "hash_lookup.tpp"
+#endif  // CONTAINERS_RED_BLACK_TREE_HASH_LOOKUP_H_
@@ -0,0 +1,117 @@
+#include "hash_lookup.h"
+
+namespace RBtreeMapSet {
+
+template <typename Hash>
+template <typename Key, typename Node>
+void HashLookup<Hash>::Index<Key, Node>::Reserve(std::size_t count) {
+  if (count * 2 <= slots.size()) {
+    return;
+  }
+
+  std::size_t capacity = kMinCapacity;
+  while (capacity < count * 2) {
+    capacity *= 2;
+  }
+
+  std::vector<Slot> old(capacity, Slot{0, nullptr});
+  old.swap(slots);
+  for (const Slot &slot : old) {
+    if (slot.node) {
+      Place(slot);
+    }
+  }
+}
+
+template <typename Hash>
+template <typename Key, typename Node>
+void HashLookup<Hash>::Index<Key, Node>::Insert(Node *node) noexcept {
+  Place(Slot{HashKey(hash, node->key), node});
+  ++size;
+}
+
+template <typename Hash>
+template <typename Key, typename Node>
+void HashLookup<Hash>::Index<Key, Node>::Place(Slot slot) noexcept {
+  std::size_t mask = slots.size() - 1;
+  std::size_t index = slot.hash & mask;
+
+  while (slots[index].node) {
+    index = (index + 1) & mask;
+  }
+
+  slots[index] = slot;
+}
+
+template <typename Hash>
+template <typename Key, typename Node>
+void HashLookup<Hash>::Index<Key, Node>::Erase(const Node *node) noexcept {
+  if (slots.empty()) {
+    return;
+  }
+
+  std::size_t mask = slots.size() - 1;
+  std::size_t index = HashKey(hash, node->key) & mask;
+
+  while (slots[index].node != node) {
+    if (!slots[index].node) {
+      return;
+    }
+    index = (index + 1) & mask;
+  }
+
+  // Backward-shift deletion: move later entries of the probe run into the
+  // hole when their home slot is not between the hole and their position.
+  std::size_t hole = index;
+  for (std::size_t next = (hole + 1) & mask; slots[next].node;
+       next = (next + 1) & mask) {
+    std::size_t home = slots[next].hash & mask;
+    if (((next - home) & mask) >= ((next - hole) & mask)) {
+      slots[hole] = slots[next];
+      hole = next;
+    }
+  }
+
+  slots[hole] = Slot{0, nullptr};
+  --size;
+}
+
+template <typename Hash>
+template <typename Key, typename Node>
+void HashLookup<Hash>::Index<Key, Node>::Clear() noexcept {
+  for (Slot &slot : slots) {
+    slot = Slot{0, nullptr};
+  }
+  size = 0;
+}
+
+template <typename Hash>
+template <typename Key, typename Node>
+template <typename Equal>
+Node *HashLookup<Hash>::Index<Key, Node>::Find(const Key &key,
+                                               Equal equal) noexcept {
+  if (slots.empty()) {
+    return nullptr;
+  }
+
+  std::size_t key_hash = HashKey(hash, key);
+  std::size_t mask = slots.size() - 1;
+
+  for (std::size_t index = key_hash & mask; slots[index].node;
+       index = (index + 1) & mask) {
+    if (slots[index].hash == key_hash && equal(slots[index].node->key, key)) {
+      return slots[index].node;
+    }
+  }
+
+  return nullptr;
+}
+
+template <typename Hash>
+template <typename Key, typename Node>
+std::size_t HashLookup<Hash>::Index<Key, Node>::GetMemoryUsage()
+    const noexcept {
+  return slots.capacity() * sizeof(Slot);
+}
+
+}  // namespace RBtreeMapSet
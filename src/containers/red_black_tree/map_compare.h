@@ -0,0 +1,47 @@
+#ifndef CONTAINERS_RED_BLACK_TREE_MAP_COMPARE_H_
+#define CONTAINERS_RED_BLACK_TREE_MAP_COMPARE_H_
+
+#include <type_traits>
+#include <utility>
+
+#include "compare_traits.h"
+
+namespace RBtreeMapSet {
+
+// Orders the pairs of a map by key. Keeps the shape of Compare: a "less"
+// comparator stays a "less" one, so lookups still make one call per level,
+// and a three-way one stays three-way. Shared by every map over a tree or
+// list of pairs.
+template <typename Key, typename T, typename Compare>
+struct MapKeyLess {
+  using value_type = std::pair<const Key, T>;
+
+  bool operator()(const value_type &value_1,
+                  const value_type &value_2) const {
+    return comp(value_1.first, value_2.first);
+  }
+
+  Compare comp;
+};
+
+template <typename Key, typename T, typename Compare>
+struct MapKeyThreeWay {
+  using value_type = std::pair<const Key, T>;
+
+  int operator()(const value_type &value_1, const value_type &value_2) const {
+    return CompareTraits<Compare, Key>::ThreeWay(comp, value_1.first,
+                                                 value_2.first);
+  }
+
+  Compare comp;
+};
+
+template <typename Key, typename T, typename Compare>
+using MapKeyCompare =
+    std::conditional_t<CompareTraits<Compare, Key>::kThreeWay,
+                       MapKeyThreeWay<Key, T, Compare>,
+                       MapKeyLess<Key, T, Compare>>;
+
+}  // namespace RBtreeMapSet
+
+#endif  // CONTAINERS_RED_BLACK_TREE_MAP_COMPARE_H_
@@ -1,14 +1,44 @@
 #ifndef CONTAINERS_RED_BLACK_TREE_RED_BLACK_TREE_H_
 #define CONTAINERS_RED_BLACK_TREE_RED_BLACK_TREE_H_
 
+#include <algorithm>
 #include <functional>
+#include <iterator>
 #include <limits>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#include "augment.h"
+#include "compare_traits.h"
+#include "tree_lookup.h"
 
 namespace RBtreeMapSet {
 
 enum class Color { kRed, kBlack };
 
-template <typename Key, typename Compare = std::less<Key>>
+enum class BatchAction { kInsert, kAssign, kErase };
+
+// Order of the nodes in the block allocated by RedBlackTree::Compact.
+// kInOrder suits scans, kVanEmdeBoas stores every subtree of about sqrt(n)
+// nodes contiguously, which suits lookups at any block size.
+enum class NodeLayout { kInOrder, kVanEmdeBoas };
+
+// One operation of a batch for RedBlackTree::ApplyBatch. kInsert adds the key
+// if no equal key is stored, kAssign adds it or replaces the equal one and
+// kErase removes the equal key. A batch sorted by key is applied in one
+// ordered pass; any other order gives the same result, one finger search per
+// operation.
+template <typename Key>
+struct BatchOp {
+  BatchAction action;
+  Key key;
+};
+
+// Lookup selects a side index for exact lookups, see tree_lookup.h. Augment
+// selects per-subtree data kept in the nodes, see augment.h.
+template <typename Key, typename Compare = std::less<Key>,
+          typename Lookup = TreeLookup, typename Augment = NoAugment>
 class RedBlackTree {
  private:
   struct Node;
@@ -22,8 +52,10 @@ class RedBlackTree {
   using iterator = Iterator;
   using const_iterator = IteratorConst;
   using size_type = std::size_t;
+  using key_compare = Compare;
 
   RedBlackTree();
+  explicit RedBlackTree(const key_compare &comp);
   RedBlackTree(const RedBlackTree &other);
   RedBlackTree(RedBlackTree &&other) noexcept;
   RedBlackTree &operator=(const RedBlackTree &other);
@@ -42,19 +74,77 @@ class RedBlackTree {
   size_type GetMaxSize() const noexcept;
 
   std::pair<iterator, bool> Insert(const key_type key);
+  std::pair<iterator, bool> Insert(const key_type key, const_iterator hint);
   template <typename... Args>
   std::vector<std::pair<iterator, bool>> Insert_many(Args &&...args);
   void Erase(iterator position);
+  key_type ExtractKey(iterator position);
   void SwapTree(RedBlackTree &other) noexcept;
   void Merge(RedBlackTree &other);
+  template <typename Generator>
+  void BuildFromSorted(size_type count, Generator next_key);
+  template <typename ForwardIt>
+  std::vector<bool> ApplyBatch(ForwardIt first, ForwardIt last);
   iterator Find(const_reference key) noexcept;
+  iterator Find(const_reference key, const_iterator hint) noexcept;
+  iterator LowerBound(const_reference key);
+  iterator LowerBound(const_reference key, const_iterator hint);
+  void SetFingerMode(bool enabled) noexcept;
+  key_compare GetComparator() const;
+  void Compact(NodeLayout layout = NodeLayout::kVanEmdeBoas);
+  std::vector<iterator> Split(size_type parts);
+  std::vector<iterator> Split(size_type parts, const_reference lo,
+                              const_reference hi);
+  size_type GetIndexMemoryUsage() const noexcept;
+  template <typename Descend, typename Stop, typename Visit>
+  void SearchAugmented(Descend descend, Stop stop, Visit visit);
+  void RefreshAugment(iterator position) noexcept;
 
   bool CheckTree() const;
 
  private:
   void CopyTree(const RedBlackTree &other);
-  Node *CopyNode(const Node *node, Node *parent);
+  Node *CopyNode(const Node *node, Node *parent, Node *&spare);
+  Node *TakeNode(const Node *node, Node *&spare);
+  Node *DetachNodes() noexcept;
+  void ReleaseNodes(Node *spare) noexcept;
   void RemoveNode(Node *node);
+  void DestroyNode(Node *node) noexcept;
+  void FreeNode(Node *node) noexcept;
+  bool IsInBlock(const Node *node) const noexcept;
+  void CollectVanEmdeBoas(Node *node, size_type height,
+                          std::vector<Node *> &nodes) const;
+  void CollectAtDepth(Node *node, size_type depth,
+                      std::vector<Node *> &nodes) const;
+  size_type GetHeight(const Node *node) const;
+  template <typename Generator>
+  Node *BuildSubtree(size_type count, size_type depth, size_type red_depth,
+                     Generator &next_key);
+  static size_type GetRedDepth(size_type count);
+
+  template <typename ForwardIt>
+  std::vector<bool> ApplyBatchInPlace(ForwardIt first, ForwardIt last);
+  template <typename ForwardIt>
+  std::vector<bool> ApplyBatchRebuild(ForwardIt first, ForwardIt last,
+                                      size_type count);
+  Node *FingerLowerBound(Node *finger, const_reference key) const;
+  void InsertBefore(Node *position, Node *new_node);
+  void ReplaceNode(Node *node, Node *new_node);
+  void LinkSorted(const std::vector<Node *> &nodes);
+  Node *LinkSubtree(Node *const *nodes, size_type count, size_type depth,
+                    size_type red_depth);
+  void CollectTopNodes(Node *node, size_type depth,
+                       std::vector<Node *> &nodes) const;
+
+  bool IsLess(const_reference key_1, const_reference key_2) const;
+  int CompareKeys(const_reference key_1, const_reference key_2) const;
+  bool IsEqual(const_reference key_1, const_reference key_2) const;
+  void IndexNodes() noexcept;
+  void UpdateAugment(Node *node) noexcept;
+  void UpdateAugmentUp(Node *node) noexcept;
+  template <typename Descend, typename Stop, typename Visit>
+  bool SearchAugmented(Node *node, Descend &descend, Stop &stop,
+                       Visit &visit);
 
   Node *GetRoot();
   const Node *GetRoot() const;
@@ -71,10 +161,11 @@ class RedBlackTree {
   void RotateLeft(Node *node);
   void RotateRight(Node *node);
   void UpdateSizeAndMinMaxNode(Node *new_node);
-  iterator LowerBound(const_reference key);
+  Node *RootLowerBound(const_reference key);
+  iterator FindInTree(const_reference key) noexcept;
 
   Node *ExtractNode(iterator position);
-  void UpdateParam(Node *node);
+  void UpdateParam(Node *node, Node *new_min, Node *new_max);
   void ExtractFromTree(Node *node);
   void SwapForErase(Node *node, Node *other);
   void SwapNode(Node *node_1, Node *node_2);
@@ -90,7 +181,7 @@ class RedBlackTree {
   bool CheckRedNodes(const Node *node) const;
   int CheckBlackHeight(const Node *node) const;
 
-  struct Node {
+  struct Node : Augment::template Data<Key> {
     Node()
         : parent(nullptr),
           left(this),
@@ -109,7 +200,7 @@ class RedBlackTree {
         : parent(nullptr),
           left(nullptr),
           right(nullptr),
-          key(key),
+          key(std::move(key)),
           color(color) {}
 
     void ToDefault() noexcept {
@@ -179,7 +270,7 @@ class RedBlackTree {
   struct Iterator {
     using iterator_category = std::forward_iterator_tag;
     using difference_type = std::ptrdiff_t;
-    using value_type = typename RedBlackTree<Key, Compare>::key_type;
+    using value_type = typename RedBlackTree::key_type;
     using pointer = value_type *;
     using reference = value_type &;
 
@@ -225,7 +316,7 @@ class RedBlackTree {
   struct IteratorConst {
     using iterator_category = std::forward_iterator_tag;
     using difference_type = std::ptrdiff_t;
-    using value_type = typename RedBlackTree<Key, Compare>::key_type;
+    using value_type = typename RedBlackTree::key_type;
     using pointer = const value_type *;
     using reference = const value_type &;
 
@@ -272,9 +363,24 @@ class RedBlackTree {
     const Node *node_;
   };
 
+  using compare_traits = CompareTraits<Compare, Key>;
+  using lookup_type = typename Lookup::template Index<Key, Node>;
+  using augment_data = typename Augment::template Data<Key>;
+
   Node *head;
   size_type tree_size;
   Compare cmp;
+  // Last node reached by Find, LowerBound or Insert while finger mode is on;
+  // the next search starts from it. Null when unknown.
+  Node *finger;
+  bool finger_mode;
+  // Storage of the nodes placed by Compact. Nodes in it are destroyed in
+  // place and the block is freed once none of them is left.
+  Node *block;
+  size_type block_capacity;
+  size_type block_live;
+  // Side index of the lookup policy, see tree_lookup.h.
+  lookup_type lookup;
 };
 
 }  // namespace RBtreeMapSet
@@ -2,32 +2,55 @@
 
 namespace RBtreeMapSet {
 
-template <typename Key, typename Compare>
-RedBlackTree<Key, Compare>::RedBlackTree() : head(new Node), tree_size(0) {}
-
-template <typename Key, typename Compare>
-RedBlackTree<Key, Compare>::RedBlackTree(const RedBlackTree &other)
-    : RedBlackTree() {
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+RedBlackTree<Key, Compare, Lookup, Augment>::RedBlackTree()
+    : head(new Node),
+      tree_size(0),
+      finger(nullptr),
+      finger_mode(false),
+      block(nullptr),
+      block_capacity(0),
+      block_live(0) {}
+
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+RedBlackTree<Key, Compare, Lookup, Augment>::RedBlackTree(
+    const key_compare &comp)
+    : head(new Node),
+      tree_size(0),
+      cmp(comp),
+      finger(nullptr),
+      finger_mode(false),
+      block(nullptr),
+      block_capacity(0),
+      block_live(0) {}
+
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+RedBlackTree<Key, Compare, Lookup, Augment>::RedBlackTree(
+    const RedBlackTree &other)
+    : RedBlackTree(other.cmp) {
   if (other.GetSize() != 0) {
     CopyTree(other);
   }
 }
 
-template <typename Key, typename Compare>
-RedBlackTree<Key, Compare>::RedBlackTree(RedBlackTree &&other) noexcept
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+RedBlackTree<Key, Compare, Lookup, Augment>::RedBlackTree(
+    RedBlackTree &&other) noexcept
     : RedBlackTree() {
   if (this != &other) {
     SwapTree(other);
   }
 }
 
-template <typename Key, typename Compare>
-typename RedBlackTree<Key, Compare>::RedBlackTree &
-RedBlackTree<Key, Compare>::operator=(const RedBlackTree &other) {
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+typename RedBlackTree<Key, Compare, Lookup, Augment>::RedBlackTree &
+RedBlackTree<Key, Compare, Lookup, Augment>::operator=(
+    const RedBlackTree &other) {
   if (this == &other) {
     return *this;
   }
 
+  cmp = other.cmp;
   if (other.GetSize() != 0) {
     CopyTree(other);
   } else {
@@ -37,46 +60,62 @@ RedBlackTree<Key, Compare>::operator=(const RedBlackTree &other) {
   return *this;
 }
 
-template <typename Key, typename Compare>
-typename RedBlackTree<Key, Compare>::RedBlackTree &
-RedBlackTree<Key, Compare>::operator=(RedBlackTree &&other) noexcept {
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+typename RedBlackTree<Key, Compare, Lookup, Augment>::RedBlackTree &
+RedBlackTree<Key, Compare, Lookup, Augment>::operator=(
+    RedBlackTree &&other) noexcept {
   RemoveTree();
   SwapTree(other);
   return *this;
 }
 
-template <typename Key, typename Compare>
-RedBlackTree<Key, Compare>::~RedBlackTree() {
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+RedBlackTree<Key, Compare, Lookup, Augment>::~RedBlackTree() {
   RemoveTree();
   delete head;
   head = nullptr;
 }
 
-template <typename Key, typename Compare>
-void RedBlackTree<Key, Compare>::CopyTree(const RedBlackTree &other) {
-  Node *copy = CopyNode(other.GetRoot(), other.GetRoot()->parent);
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+void RedBlackTree<Key, Compare, Lookup, Augment>::CopyTree(
+    const RedBlackTree &other) {
+  lookup.Reserve(other.tree_size);
+
+  // The nodes of this tree are recycled for the copy, so only the difference
+  // in size is allocated or freed and the two trees never coexist in full.
+  // If a copy throws, this tree is left empty.
+  Node *spare = DetachNodes();
+  Node *copy = nullptr;
+
+  try {
+    copy = CopyNode(other.GetRoot(), head, spare);
+  } catch (...) {
+    ReleaseNodes(spare);
+    throw;
+  }
+  ReleaseNodes(spare);
 
-  RemoveTree();
   SetRoot(copy);
-  GetRoot()->parent = head;
   SetMinNode(SearchMinNode(GetRoot()));
   SetMaxNode(SearchMaxNode(GetRoot()));
   tree_size = other.tree_size;
-  cmp = other.cmp;
+  IndexNodes();
 }
 
-template <typename Key, typename Compare>
-typename RedBlackTree<Key, Compare>::Node *RedBlackTree<Key, Compare>::CopyNode(
-    const Node *node, Node *parent) {
-  Node *copy = new Node{node->key, node->color};
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+typename RedBlackTree<Key, Compare, Lookup, Augment>::Node *
+RedBlackTree<Key, Compare, Lookup, Augment>::CopyNode(const Node *node,
+                                                      Node *parent,
+                                                      Node *&spare) {
+  Node *copy = TakeNode(node, spare);
 
   try {
     if (node->left) {
-      copy->left = CopyNode(node->left, copy);
+      copy->left = CopyNode(node->left, copy, spare);
     }
 
     if (node->right) {
-      copy->right = CopyNode(node->right, copy);
+      copy->right = CopyNode(node->right, copy, spare);
     }
   } catch (...) {
     RemoveNode(copy);
@@ -84,102 +123,311 @@ typename RedBlackTree<Key, Compare>::Node *RedBlackTree<Key, Compare>::CopyNode(
   }
 
   copy->parent = parent;
+  static_cast<augment_data &>(*copy) = *node;
   return copy;
 }
 
-template <typename Key, typename Compare>
-void RedBlackTree<Key, Compare>::RemoveNode(Node *node) {
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+typename RedBlackTree<Key, Compare, Lookup, Augment>::Node *
+RedBlackTree<Key, Compare, Lookup, Augment>::TakeNode(const Node *node,
+                                                      Node *&spare) {
+  if (!spare) {
+    return new Node{node->key, node->color};
+  }
+
+  Node *reused = spare;
+  spare = spare->right;
+
+  // Assigning keeps the buffers of keys such as strings. The keys of maps
+  // have a const part, so their node is constructed again in place instead.
+  if constexpr (std::is_copy_assignable_v<key_type>) {
+    try {
+      reused->key = node->key;
+    } catch (...) {
+      DestroyNode(reused);
+      throw;
+    }
+    reused->ToDefault();
+    reused->color = node->color;
+  } else {
+    reused->~Node();
+    try {
+      ::new (static_cast<void *>(reused)) Node{node->key, node->color};
+    } catch (...) {
+      FreeNode(reused);
+      throw;
+    }
+  }
+
+  return reused;
+}
+
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+typename RedBlackTree<Key, Compare, Lookup, Augment>::Node *
+RedBlackTree<Key, Compare, Lookup, Augment>::DetachNodes() noexcept {
+  Node *spare = nullptr;
+  Node *node = GetRoot();
+
+  // Rotating left children up flattens the tree without a stack; each node
+  // that has no left child is pushed on the spare list through its right
+  // pointer.
+  while (node) {
+    if (node->left) {
+      Node *left = node->left;
+      node->left = left->right;
+      left->right = node;
+      node = left;
+    } else {
+      Node *next = node->right;
+      node->right = spare;
+      spare = node;
+      node = next;
+    }
+  }
+
+  SetupHead();
+  tree_size = 0;
+  finger = nullptr;
+  lookup.Clear();
+  return spare;
+}
+
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+void RedBlackTree<Key, Compare, Lookup, Augment>::ReleaseNodes(
+    Node *spare) noexcept {
+  while (spare) {
+    Node *next = spare->right;
+    DestroyNode(spare);
+    spare = next;
+  }
+}
+
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+void RedBlackTree<Key, Compare, Lookup, Augment>::RemoveNode(Node *node) {
   if (!node) {
     return;
   }
 
   RemoveNode(node->left);
   RemoveNode(node->right);
-  delete node;
+  DestroyNode(node);
+}
+
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+void RedBlackTree<Key, Compare, Lookup, Augment>::DestroyNode(
+    Node *node) noexcept {
+  node->~Node();
+  FreeNode(node);
 }
 
-template <typename Key, typename Compare>
-void RedBlackTree<Key, Compare>::RemoveTree() {
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+void RedBlackTree<Key, Compare, Lookup, Augment>::FreeNode(
+    Node *node) noexcept {
+  if (!IsInBlock(node)) {
+    ::operator delete(node);
+    return;
+  }
+
+  if (--block_live == 0) {
+    ::operator delete(block);
+    block = nullptr;
+    block_capacity = 0;
+  }
+}
+
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+bool RedBlackTree<Key, Compare, Lookup, Augment>::IsInBlock(
+    const Node *node) const noexcept {
+  std::less<const Node *> less;
+  return block && !less(node, block) && less(node, block + block_capacity);
+}
+
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+void RedBlackTree<Key, Compare, Lookup, Augment>::RemoveTree() {
   RemoveNode(GetRoot());
   SetupHead();
   tree_size = 0;
+  finger = nullptr;
+  lookup.Clear();
+}
+
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+bool RedBlackTree<Key, Compare, Lookup, Augment>::IsLess(
+    const_reference key_1, const_reference key_2) const {
+  return compare_traits::Less(cmp, key_1, key_2);
+}
+
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+int RedBlackTree<Key, Compare, Lookup, Augment>::CompareKeys(
+    const_reference key_1, const_reference key_2) const {
+  return compare_traits::ThreeWay(cmp, key_1, key_2);
+}
+
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+bool RedBlackTree<Key, Compare, Lookup, Augment>::IsEqual(
+    const_reference key_1, const_reference key_2) const {
+  if constexpr (compare_traits::kThreeWay) {
+    return CompareKeys(key_1, key_2) == 0;
+  } else {
+    return !IsLess(key_1, key_2) && !IsLess(key_2, key_1);
+  }
+}
+
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+void RedBlackTree<Key, Compare, Lookup, Augment>::IndexNodes() noexcept {
+  lookup.Clear();
+  for (Node *node = GetMinNode(); node != head; node = node->GetNextNode()) {
+    lookup.Insert(node);
+  }
+}
+
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+typename RedBlackTree<Key, Compare, Lookup, Augment>::size_type
+RedBlackTree<Key, Compare, Lookup, Augment>::GetIndexMemoryUsage()
+    const noexcept {
+  return lookup.GetMemoryUsage();
+}
+
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+void RedBlackTree<Key, Compare, Lookup, Augment>::UpdateAugment(
+    Node *node) noexcept {
+  if constexpr (Augment::kEnabled) {
+    Augment::Update(node);
+  }
+}
+
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+void RedBlackTree<Key, Compare, Lookup, Augment>::UpdateAugmentUp(
+    Node *node) noexcept {
+  if constexpr (Augment::kEnabled) {
+    for (; node != head; node = node->parent) {
+      Augment::Update(node);
+    }
+  }
+}
+
+// Recomputes the augment data from the node at position up to the root, for
+// owners that changed a per-node field of the data in place.
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+void RedBlackTree<Key, Compare, Lookup, Augment>::RefreshAugment(
+    iterator position) noexcept {
+  UpdateAugmentUp(position.node_);
+}
+
+// Passes the nodes to visit(iterator) in key order. descend(node) tells from
+// the augment data of a node whether its subtree may hold wanted keys;
+// subtrees it rejects are skipped, so visit still sees some unwanted keys and
+// must filter them. The walk ends at the first key for which stop(key) holds,
+// so stop must not hold for a key before one it is false for.
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+template <typename Descend, typename Stop, typename Visit>
+void RedBlackTree<Key, Compare, Lookup, Augment>::SearchAugmented(
+    Descend descend, Stop stop, Visit visit) {
+  if (GetRoot()) {
+    SearchAugmented(GetRoot(), descend, stop, visit);
+  }
 }
 
-template <typename Key, typename Compare>
-typename RedBlackTree<Key, Compare>::Node *
-RedBlackTree<Key, Compare>::GetRoot() {
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+template <typename Descend, typename Stop, typename Visit>
+bool RedBlackTree<Key, Compare, Lookup, Augment>::SearchAugmented(
+    Node *node, Descend &descend, Stop &stop, Visit &visit) {
+  if (!node || !descend(static_cast<const Node &>(*node))) {
+    return true;
+  }
+  if (!SearchAugmented(node->left, descend, stop, visit) || stop(node->key)) {
+    return false;
+  }
+  visit(iterator(node));
+  return SearchAugmented(node->right, descend, stop, visit);
+}
+
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+typename RedBlackTree<Key, Compare, Lookup, Augment>::Node *
+RedBlackTree<Key, Compare, Lookup, Augment>::GetRoot() {
   return head->parent;
 }
 
-template <typename Key, typename Compare>
-const typename RedBlackTree<Key, Compare>::Node *
-RedBlackTree<Key, Compare>::GetRoot() const {
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+const typename RedBlackTree<Key, Compare, Lookup, Augment>::Node *
+RedBlackTree<Key, Compare, Lookup, Augment>::GetRoot() const {
   return head->parent;
 }
 
-template <typename Key, typename Compare>
-void RedBlackTree<Key, Compare>::SetRoot(Node *node) {
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+void RedBlackTree<Key, Compare, Lookup, Augment>::SetRoot(Node *node) {
   head->parent = node;
 }
 
-template <typename Key, typename Compare>
-void RedBlackTree<Key, Compare>::SetupHead() {
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+void RedBlackTree<Key, Compare, Lookup, Augment>::SetupHead() {
   SetRoot(nullptr);
   SetMinNode(head);
   SetMaxNode(head);
 }
 
-template <typename Key, typename Compare>
-typename RedBlackTree<Key, Compare>::size_type
-RedBlackTree<Key, Compare>::GetSize() const noexcept {
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+typename RedBlackTree<Key, Compare, Lookup, Augment>::size_type
+RedBlackTree<Key, Compare, Lookup, Augment>::GetSize() const noexcept {
   return tree_size;
 }
 
-template <typename Key, typename Compare>
-void RedBlackTree<Key, Compare>::SwapTree(RedBlackTree &other) noexcept {
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+void RedBlackTree<Key, Compare, Lookup, Augment>::SwapTree(
+    RedBlackTree &other) noexcept {
   std::swap(head, other.head);
   std::swap(tree_size, other.tree_size);
   std::swap(cmp, other.cmp);
+  std::swap(finger, other.finger);
+  std::swap(block, other.block);
+  std::swap(block_capacity, other.block_capacity);
+  std::swap(block_live, other.block_live);
+  std::swap(lookup, other.lookup);
 }
 
-template <typename Key, typename Compare>
-typename RedBlackTree<Key, Compare>::Node *
-RedBlackTree<Key, Compare>::GetMinNode() const {
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+typename RedBlackTree<Key, Compare, Lookup, Augment>::Node *
+RedBlackTree<Key, Compare, Lookup, Augment>::GetMinNode() const {
   return head->left;
 }
 
-template <typename Key, typename Compare>
-typename RedBlackTree<Key, Compare>::Node *
-RedBlackTree<Key, Compare>::GetMaxNode() const {
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+typename RedBlackTree<Key, Compare, Lookup, Augment>::Node *
+RedBlackTree<Key, Compare, Lookup, Augment>::GetMaxNode() const {
   return head->right;
 }
 
-template <typename Key, typename Compare>
-void RedBlackTree<Key, Compare>::SetMinNode(Node *node) {
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+void RedBlackTree<Key, Compare, Lookup, Augment>::SetMinNode(Node *node) {
   head->left = node;
 }
 
-template <typename Key, typename Compare>
-void RedBlackTree<Key, Compare>::SetMaxNode(Node *node) {
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+void RedBlackTree<Key, Compare, Lookup, Augment>::SetMaxNode(Node *node) {
   head->right = node;
 }
 
-template <typename Key, typename Compare>
-bool RedBlackTree<Key, Compare>::isEmpty() const noexcept {
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+bool RedBlackTree<Key, Compare, Lookup, Augment>::isEmpty() const noexcept {
   return !GetRoot();
 }
 
-template <typename Key, typename Compare>
-typename RedBlackTree<Key, Compare>::size_type
-RedBlackTree<Key, Compare>::GetMaxSize() const noexcept {
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+typename RedBlackTree<Key, Compare, Lookup, Augment>::size_type
+RedBlackTree<Key, Compare, Lookup, Augment>::GetMaxSize() const noexcept {
   return ((std::numeric_limits<size_type>::max() / 2) - sizeof(RedBlackTree) -
           sizeof(Node)) /
          sizeof(Node);
 }
 
-template <typename Key, typename Compare>
-std::pair<typename RedBlackTree<Key, Compare>::iterator, bool>
-RedBlackTree<Key, Compare>::Insert(const key_type key) {
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+std::pair<typename RedBlackTree<Key, Compare, Lookup, Augment>::iterator, bool>
+RedBlackTree<Key, Compare, Lookup, Augment>::Insert(const key_type key) {
+  if (finger_mode) {
+    return Insert(key, const_iterator(finger ? finger : head));
+  }
+
+  lookup.Reserve(tree_size + 1);
   Node *new_node = new Node{key};
 
   auto res = InsertNode(GetRoot(), new_node);
@@ -192,47 +440,75 @@ RedBlackTree<Key, Compare>::Insert(const key_type key) {
   return res;
 }
 
-template <typename Key, typename Compare>
-std::pair<typename RedBlackTree<Key, Compare>::iterator, bool>
-RedBlackTree<Key, Compare>::InsertNode(Node *root, Node *new_node) {
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+std::pair<typename RedBlackTree<Key, Compare, Lookup, Augment>::iterator, bool>
+RedBlackTree<Key, Compare, Lookup, Augment>::Insert(const key_type key,
+                                                    const_iterator hint) {
+  Node *position = FingerLowerBound(const_cast<Node *>(hint.node_), key);
+
+  if (position != head && !IsLess(key, position->key)) {
+    if (finger_mode) {
+      finger = position;
+    }
+    return {iterator(position), false};
+  }
+
+  lookup.Reserve(tree_size + 1);
+  Node *new_node = new Node{key};
+  InsertBefore(position, new_node);
+  if (finger_mode) {
+    finger = new_node;
+  }
+
+  return {iterator(new_node), true};
+}
+
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+std::pair<typename RedBlackTree<Key, Compare, Lookup, Augment>::iterator, bool>
+RedBlackTree<Key, Compare, Lookup, Augment>::InsertNode(Node *root,
+                                                        Node *new_node) {
   if (!GetRoot()) {
     new_node->color = Color::kBlack;
     new_node->parent = head;
     SetRoot(new_node);
     UpdateSizeAndMinMaxNode(new_node);
+    UpdateAugment(new_node);
+    lookup.Insert(new_node);
     return {iterator(new_node), true};
   }
 
   Node *node = root;
   Node *parent = nullptr;
+  int res = 0;
 
   while (node) {
     parent = node;
-    if (cmp(new_node->key, node->key)) {
+    res = CompareKeys(new_node->key, node->key);
+    if (res < 0) {
       node = node->left;
+    } else if (res > 0) {
+      node = node->right;
     } else {
-      if (cmp(node->key, new_node->key)) {
-        node = node->right;
-      } else {
-        return {iterator(node), false};
-      }
+      return {iterator(node), false};
     }
   }
 
   new_node->parent = parent;
-  if (cmp(new_node->key, parent->key)) {
+  if (res < 0) {
     parent->left = new_node;
   } else {
     parent->right = new_node;
   }
   UpdateSizeAndMinMaxNode(new_node);
+  UpdateAugmentUp(new_node);
   BalanceForInsert(new_node);
+  lookup.Insert(new_node);
 
   return {iterator(new_node), true};
 }
 
-template <typename Key, typename Compare>
-void RedBlackTree<Key, Compare>::BalanceForInsert(Node *node) {
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+void RedBlackTree<Key, Compare, Lookup, Augment>::BalanceForInsert(Node *node) {
   while (node != GetRoot() && node->parent->color == Color::kRed) {
     Node *parent = node->parent;
     Node *grandparent = parent->parent;
@@ -270,8 +546,8 @@ void RedBlackTree<Key, Compare>::BalanceForInsert(Node *node) {
   GetRoot()->color = Color::kBlack;
 }
 
-template <typename Key, typename Compare>
-void RedBlackTree<Key, Compare>::RotateLeft(Node *node) {
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+void RedBlackTree<Key, Compare, Lookup, Augment>::RotateLeft(Node *node) {
   Node *pivot = node->right;
 
   pivot->parent = node->parent;
@@ -291,10 +567,12 @@ void RedBlackTree<Key, Compare>::RotateLeft(Node *node) {
 
   node->parent = pivot;
   pivot->left = node;
+  UpdateAugment(node);
+  UpdateAugment(pivot);
 }
 
-template <typename Key, typename Compare>
-void RedBlackTree<Key, Compare>::RotateRight(Node *node) {
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+void RedBlackTree<Key, Compare, Lookup, Augment>::RotateRight(Node *node) {
   Node *pivot = node->left;
 
   pivot->parent = node->parent;
@@ -314,10 +592,13 @@ void RedBlackTree<Key, Compare>::RotateRight(Node *node) {
 
   node->parent = pivot;
   pivot->right = node;
+  UpdateAugment(node);
+  UpdateAugment(pivot);
 }
 
-template <typename Key, typename Compare>
-void RedBlackTree<Key, Compare>::UpdateSizeAndMinMaxNode(Node *new_node) {
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+void RedBlackTree<Key, Compare, Lookup, Augment>::UpdateSizeAndMinMaxNode(
+    Node *new_node) {
   tree_size++;
 
   if (GetMinNode() == head || GetMinNode()->left) {
@@ -329,15 +610,18 @@ void RedBlackTree<Key, Compare>::UpdateSizeAndMinMaxNode(Node *new_node) {
   }
 }
 
-template <typename Key, typename Compare>
+template <typename Key, typename Compare, typename Lookup, typename Augment>
 template <typename... Args>
-std::vector<std::pair<typename RedBlackTree<Key, Compare>::iterator, bool>>
-RedBlackTree<Key, Compare>::Insert_many(Args &&...args) {
+std::vector<
+    std::pair<typename RedBlackTree<Key, Compare, Lookup, Augment>::iterator,
+              bool>>
+RedBlackTree<Key, Compare, Lookup, Augment>::Insert_many(Args &&...args) {
   std::vector<std::pair<iterator, bool>> res;
   res.reserve(sizeof...(args));
   Node *new_node;
 
   for (auto item : {args...}) {
+    lookup.Reserve(tree_size + 1);
     new_node = new Node(item);
     std::pair<iterator, bool> result_insert = InsertNode(GetRoot(), new_node);
     if (result_insert.second == false) {
@@ -348,26 +632,300 @@ RedBlackTree<Key, Compare>::Insert_many(Args &&...args) {
   return res;
 }
 
-template <typename Key, typename Compare>
-typename RedBlackTree<Key, Compare>::iterator RedBlackTree<Key, Compare>::Find(
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+typename RedBlackTree<Key, Compare, Lookup, Augment>::iterator
+RedBlackTree<Key, Compare, Lookup, Augment>::Find(
     const_reference key) noexcept {
-  iterator res = LowerBound(key);
+  Node *indexed = lookup.Find(
+      key, [this](const_reference key_1, const_reference key_2) {
+        return IsEqual(key_1, key_2);
+      });
+  if (indexed || lookup_type::kComplete) {
+    return indexed ? iterator(indexed) : End();
+  }
+
+  iterator res = FindInTree(key);
+  if (res != End()) {
+    lookup.Touch(res.node_);
+  }
 
-  if (res == End() || cmp(key, *res)) {
+  return res;
+}
+
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+typename RedBlackTree<Key, Compare, Lookup, Augment>::iterator
+RedBlackTree<Key, Compare, Lookup, Augment>::FindInTree(
+    const_reference key) noexcept {
+  if (finger_mode) {
+    return Find(key, const_iterator(finger ? finger : head));
+  }
+
+  if constexpr (compare_traits::kThreeWay) {
+    Node *current = GetRoot();
+
+    while (current) {
+      int res = CompareKeys(key, current->key);
+      if (res < 0) {
+        current = current->left;
+      } else if (res > 0) {
+        current = current->right;
+      } else {
+        return iterator(current);
+      }
+    }
+
+    return End();
+  } else {
+    Node *res = RootLowerBound(key);
+
+    if (res == head || IsLess(key, res->key)) {
+      return End();
+    }
+
+    return iterator(res);
+  }
+}
+
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+typename RedBlackTree<Key, Compare, Lookup, Augment>::iterator
+RedBlackTree<Key, Compare, Lookup, Augment>::Find(
+    const_reference key, const_iterator hint) noexcept {
+  Node *res = LowerBound(key, hint).node_;
+
+  if (res == head || IsLess(key, res->key)) {
     return End();
   }
 
+  return iterator(res);
+}
+
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+typename RedBlackTree<Key, Compare, Lookup, Augment>::key_compare
+RedBlackTree<Key, Compare, Lookup, Augment>::GetComparator() const {
+  return cmp;
+}
+
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+void RedBlackTree<Key, Compare, Lookup, Augment>::Compact(NodeLayout layout) {
+  if (!GetRoot()) {
+    return;
+  }
+
+  std::vector<Node *> nodes;
+  nodes.reserve(tree_size);
+  if (layout == NodeLayout::kInOrder) {
+    for (Node *node = GetMinNode(); node != head; node = node->GetNextNode()) {
+      nodes.push_back(node);
+    }
+  } else {
+    CollectVanEmdeBoas(GetRoot(), GetHeight(GetRoot()), nodes);
+  }
+
+  Node *new_block =
+      static_cast<Node *>(::operator new(sizeof(Node) * nodes.size()));
+  size_type constructed = 0;
+  try {
+    for (; constructed < nodes.size(); ++constructed) {
+      Node *node = nodes[constructed];
+      ::new (static_cast<void *>(new_block + constructed))
+          Node{std::move_if_noexcept(node->key), node->color};
+    }
+  } catch (...) {
+    while (constructed > 0) {
+      new_block[--constructed].~Node();
+    }
+    ::operator delete(new_block);
+    throw;
+  }
+
+  // The links of the old nodes are still needed to wire up the copies, so
+  // each old node remembers its copy in its parent field.
+  for (size_type i = 0; i < nodes.size(); ++i) {
+    nodes[i]->parent = new_block + i;
+  }
+
+  for (size_type i = 0; i < nodes.size(); ++i) {
+    Node *node = new_block + i;
+    node->left = nodes[i]->left ? nodes[i]->left->parent : nullptr;
+    node->right = nodes[i]->right ? nodes[i]->right->parent : nullptr;
+    static_cast<augment_data &>(*node) = *nodes[i];
+    UpdateParent(node);
+  }
+
+  Node *root = GetRoot()->parent;
+  root->parent = head;
+  SetMinNode(GetMinNode()->parent);
+  SetMaxNode(GetMaxNode()->parent);
+  if (finger) {
+    finger = finger->parent;
+  }
+
+  for (Node *node : nodes) {
+    DestroyNode(node);
+  }
+
+  SetRoot(root);
+  block = new_block;
+  block_capacity = nodes.size();
+  block_live = nodes.size();
+  IndexNodes();
+}
+
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+void RedBlackTree<Key, Compare, Lookup, Augment>::CollectVanEmdeBoas(
+    Node *node, size_type height, std::vector<Node *> &nodes) const {
+  if (!node) {
+    return;
+  }
+
+  if (height == 1) {
+    nodes.push_back(node);
+    return;
+  }
+
+  size_type top_height = height / 2;
+  CollectVanEmdeBoas(node, top_height, nodes);
+
+  std::vector<Node *> bottom_roots;
+  CollectAtDepth(node, top_height, bottom_roots);
+  for (Node *bottom_root : bottom_roots) {
+    CollectVanEmdeBoas(bottom_root, height - top_height, nodes);
+  }
+}
+
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+void RedBlackTree<Key, Compare, Lookup, Augment>::CollectAtDepth(
+    Node *node, size_type depth, std::vector<Node *> &nodes) const {
+  if (!node) {
+    return;
+  }
+
+  if (depth == 0) {
+    nodes.push_back(node);
+    return;
+  }
+
+  CollectAtDepth(node->left, depth - 1, nodes);
+  CollectAtDepth(node->right, depth - 1, nodes);
+}
+
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+typename RedBlackTree<Key, Compare, Lookup, Augment>::size_type
+RedBlackTree<Key, Compare, Lookup, Augment>::GetHeight(const Node *node) const {
+  if (!node) {
+    return 0;
+  }
+
+  return 1 + std::max(GetHeight(node->left), GetHeight(node->right));
+}
+
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+std::vector<typename RedBlackTree<Key, Compare, Lookup, Augment>::iterator>
+RedBlackTree<Key, Compare, Lookup, Augment>::Split(size_type parts) {
+  std::vector<iterator> res{Begin()};
+  size_type depth = 0;
+  while ((size_type{1} << depth) < parts) {
+    ++depth;
+  }
+
+  std::vector<Node *> nodes;
+  CollectTopNodes(GetRoot(), depth, nodes);
+  for (Node *node : nodes) {
+    if (iterator(node) != res.back()) {
+      res.push_back(iterator(node));
+    }
+  }
+
+  if (res.back() != End()) {
+    res.push_back(End());
+  }
+
+  return res;
+}
+
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+std::vector<typename RedBlackTree<Key, Compare, Lookup, Augment>::iterator>
+RedBlackTree<Key, Compare, Lookup, Augment>::Split(size_type parts,
+                                                   const_reference lo,
+                                                   const_reference hi) {
+  std::vector<iterator> res{iterator(RootLowerBound(lo))};
+  if (!IsLess(lo, hi)) {
+    return res;
+  }
+
+  size_type depth = 0;
+  while ((size_type{1} << depth) < parts) {
+    ++depth;
+  }
+
+  std::vector<Node *> nodes;
+  CollectTopNodes(GetRoot(), depth, nodes);
+  for (Node *node : nodes) {
+    if (!IsLess(node->key, lo) && IsLess(node->key, hi) &&
+        iterator(node) != res.back()) {
+      res.push_back(iterator(node));
+    }
+  }
+
+  iterator last(RootLowerBound(hi));
+  if (res.back() != last) {
+    res.push_back(last);
+  }
+
   return res;
 }
 
-template <typename Key, typename Compare>
-typename RedBlackTree<Key, Compare>::iterator
-RedBlackTree<Key, Compare>::LowerBound(const_reference key) {
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+void RedBlackTree<Key, Compare, Lookup, Augment>::CollectTopNodes(
+    Node *node, size_type depth, std::vector<Node *> &nodes) const {
+  if (!node || depth == 0) {
+    return;
+  }
+
+  CollectTopNodes(node->left, depth - 1, nodes);
+  nodes.push_back(node);
+  CollectTopNodes(node->right, depth - 1, nodes);
+}
+
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+typename RedBlackTree<Key, Compare, Lookup, Augment>::iterator
+RedBlackTree<Key, Compare, Lookup, Augment>::LowerBound(const_reference key) {
+  if (finger_mode) {
+    return LowerBound(key, const_iterator(finger ? finger : head));
+  }
+
+  return iterator(RootLowerBound(key));
+}
+
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+typename RedBlackTree<Key, Compare, Lookup, Augment>::iterator
+RedBlackTree<Key, Compare, Lookup, Augment>::LowerBound(const_reference key,
+                                                        const_iterator hint) {
+  Node *res = FingerLowerBound(const_cast<Node *>(hint.node_), key);
+
+  if (finger_mode && res != head) {
+    finger = res;
+  }
+
+  return iterator(res);
+}
+
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+void RedBlackTree<Key, Compare, Lookup, Augment>::SetFingerMode(
+    bool enabled) noexcept {
+  finger_mode = enabled;
+  finger = nullptr;
+}
+
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+typename RedBlackTree<Key, Compare, Lookup, Augment>::Node *
+RedBlackTree<Key, Compare, Lookup, Augment>::RootLowerBound(
+    const_reference key) {
   Node *current = GetRoot();
-  Node *res = End().node_;
+  Node *res = head;
 
   while (current) {
-    if (!cmp(current->key, key)) {
+    if (!IsLess(current->key, key)) {
       res = current;
       current = current->left;
     } else {
@@ -375,35 +933,35 @@ RedBlackTree<Key, Compare>::LowerBound(const_reference key) {
     }
   }
 
-  return iterator(res);
+  return res;
 }
 
-template <typename Key, typename Compare>
-typename RedBlackTree<Key, Compare>::iterator
-RedBlackTree<Key, Compare>::Begin() noexcept {
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+typename RedBlackTree<Key, Compare, Lookup, Augment>::iterator
+RedBlackTree<Key, Compare, Lookup, Augment>::Begin() noexcept {
   return iterator(head->left);
 }
 
-template <typename Key, typename Compare>
-typename RedBlackTree<Key, Compare>::const_iterator
-RedBlackTree<Key, Compare>::Begin() const noexcept {
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+typename RedBlackTree<Key, Compare, Lookup, Augment>::const_iterator
+RedBlackTree<Key, Compare, Lookup, Augment>::Begin() const noexcept {
   return const_iterator(head->left);
 }
 
-template <typename Key, typename Compare>
-typename RedBlackTree<Key, Compare>::iterator
-RedBlackTree<Key, Compare>::End() noexcept {
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+typename RedBlackTree<Key, Compare, Lookup, Augment>::iterator
+RedBlackTree<Key, Compare, Lookup, Augment>::End() noexcept {
   return iterator(head);
 }
 
-template <typename Key, typename Compare>
-typename RedBlackTree<Key, Compare>::const_iterator
-RedBlackTree<Key, Compare>::End() const noexcept {
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+typename RedBlackTree<Key, Compare, Lookup, Augment>::const_iterator
+RedBlackTree<Key, Compare, Lookup, Augment>::End() const noexcept {
   return const_iterator(head);
 }
 
-template <typename Key, typename Compare>
-void RedBlackTree<Key, Compare>::Merge(RedBlackTree &other) {
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+void RedBlackTree<Key, Compare, Lookup, Augment>::Merge(RedBlackTree &other) {
   if (this != &other) {
     iterator other_begin = other.Begin();
     iterator other_end = other.End();
@@ -413,9 +971,20 @@ void RedBlackTree<Key, Compare>::Merge(RedBlackTree &other) {
       iterator it = Find(current_key);
 
       if (it == End()) {
+        lookup.Reserve(tree_size + 1);
         iterator tmp = other_begin;
         ++other_begin;
+        // Nodes of a compacted tree belong to its block and cannot change
+        // owner, so they are copied out.
+        Node *copy = other.IsInBlock(tmp.node_) ? new Node{*tmp} : nullptr;
+        if (copy) {
+          static_cast<augment_data &>(*copy) = *tmp.node_;
+        }
         Node *moving_node = other.ExtractNode(tmp);
+        if (copy) {
+          other.DestroyNode(moving_node);
+          moving_node = copy;
+        }
         InsertNode(GetRoot(), moving_node);
       } else {
         ++other_begin;
@@ -424,25 +993,430 @@ void RedBlackTree<Key, Compare>::Merge(RedBlackTree &other) {
   }
 }
 
-template <typename Key, typename Compare>
-void RedBlackTree<Key, Compare>::Erase(iterator position) {
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+template <typename Generator>
+void RedBlackTree<Key, Compare, Lookup, Augment>::BuildFromSorted(
+    size_type count, Generator next_key) {
+  RemoveTree();
+
+  if (count == 0) {
+    return;
+  }
+
+  lookup.Reserve(count);
+  Node *root = BuildSubtree(count, 0, GetRedDepth(count), next_key);
+  root->parent = head;
+  SetRoot(root);
+  SetMinNode(SearchMinNode(root));
+  SetMaxNode(SearchMaxNode(root));
+  tree_size = count;
+  IndexNodes();
+}
+
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+template <typename Generator>
+typename RedBlackTree<Key, Compare, Lookup, Augment>::Node *
+RedBlackTree<Key, Compare, Lookup, Augment>::BuildSubtree(size_type count,
+                                                          size_type depth,
+                                                          size_type red_depth,
+                                                          Generator &next_key) {
+  if (count == 0) {
+    return nullptr;
+  }
+
+  size_type left_count = (count - 1) / 2;
+  Node *left = BuildSubtree(left_count, depth + 1, red_depth, next_key);
+  Node *node = nullptr;
+
+  try {
+    node = new Node{next_key(),
+                    depth == red_depth ? Color::kRed : Color::kBlack};
+  } catch (...) {
+    RemoveNode(left);
+    throw;
+  }
+
+  node->left = left;
+  if (left) {
+    left->parent = node;
+  }
+
+  try {
+    node->right =
+        BuildSubtree(count - 1 - left_count, depth + 1, red_depth, next_key);
+  } catch (...) {
+    RemoveNode(node);
+    throw;
+  }
+
+  if (node->right) {
+    node->right->parent = node;
+  }
+  UpdateAugment(node);
+
+  return node;
+}
+
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+typename RedBlackTree<Key, Compare, Lookup, Augment>::size_type
+RedBlackTree<Key, Compare, Lookup, Augment>::GetRedDepth(size_type count) {
+  size_type height = 0;
+  size_type full_size = 0;
+  while (full_size < count) {
+    full_size = full_size * 2 + 1;
+    ++height;
+  }
+
+  return (full_size == count) ? height : height - 1;
+}
+
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+template <typename ForwardIt>
+std::vector<bool> RedBlackTree<Key, Compare, Lookup, Augment>::ApplyBatch(
+    ForwardIt first, ForwardIt last) {
+  size_type count = std::distance(first, last);
+
+  // Walking every node costs about as much as a finger search per operation
+  // once the batch is as large as the tree; past that point relinking the
+  // merged sequence is cheaper and leaves the tree perfectly balanced. The
+  // merge needs the batch in key order; an unsorted batch is applied in
+  // place, where each search may move in either direction.
+  if (count != 0 && count >= tree_size &&
+      std::is_sorted(first, last,
+                     [this](const BatchOp<key_type> &op_1,
+                            const BatchOp<key_type> &op_2) {
+                       return IsLess(op_1.key, op_2.key);
+                     })) {
+    return ApplyBatchRebuild(first, last, count);
+  }
+
+  return ApplyBatchInPlace(first, last);
+}
+
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+template <typename ForwardIt>
+std::vector<bool>
+RedBlackTree<Key, Compare, Lookup, Augment>::ApplyBatchInPlace(ForwardIt first,
+                                                               ForwardIt last) {
+  std::vector<bool> res;
+  res.reserve(std::distance(first, last));
+  Node *previous = GetMinNode();
+
+  for (; first != last; ++first) {
+    const BatchOp<key_type> &op = *first;
+    Node *position = FingerLowerBound(previous, op.key);
+    bool found = position != head && !IsLess(op.key, position->key);
+
+    if (op.action == BatchAction::kErase) {
+      if (found) {
+        Node *next = position->GetNextNode();
+        Erase(iterator(position));
+        position = next;
+      }
+      res.push_back(found);
+    } else {
+      if (!found) {
+        lookup.Reserve(tree_size + 1);
+        Node *new_node = new Node{op.key};
+        InsertBefore(position, new_node);
+        position = new_node;
+      } else if (op.action == BatchAction::kAssign) {
+        Node *new_node = new Node{op.key};
+        ReplaceNode(position, new_node);
+        position = new_node;
+      }
+      res.push_back(!found);
+    }
+
+    previous = position;
+  }
+
+  return res;
+}
+
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+template <typename ForwardIt>
+std::vector<bool>
+RedBlackTree<Key, Compare, Lookup, Augment>::ApplyBatchRebuild(
+    ForwardIt first, ForwardIt last, size_type count) {
+  std::vector<bool> res;
+  std::vector<Node *> nodes;
+  std::vector<Node *> created;
+  std::vector<Node *> removed;
+  res.reserve(count);
+  nodes.reserve(tree_size + count);
+  Node *current = GetMinNode();
+
+  try {
+    for (; first != last; ++first) {
+      const BatchOp<key_type> &op = *first;
+
+      while (current != head && IsLess(current->key, op.key)) {
+        nodes.push_back(current);
+        current = current->GetNextNode();
+      }
+
+      if (current != head && !IsLess(op.key, current->key)) {
+        nodes.push_back(current);
+        current = current->GetNextNode();
+      }
+
+      bool found = !nodes.empty() && !IsLess(nodes.back()->key, op.key);
+
+      if (op.action == BatchAction::kErase) {
+        if (found) {
+          removed.push_back(nodes.back());
+          nodes.pop_back();
+        }
+        res.push_back(found);
+      } else {
+        if (!found || op.action == BatchAction::kAssign) {
+          created.push_back(new Node{op.key});
+          if (found) {
+            removed.push_back(nodes.back());
+            nodes.back() = created.back();
+          } else {
+            nodes.push_back(created.back());
+          }
+        }
+        res.push_back(!found);
+      }
+    }
+
+    for (; current != head; current = current->GetNextNode()) {
+      nodes.push_back(current);
+    }
+
+    lookup.Reserve(nodes.size());
+  } catch (...) {
+    for (Node *node : created) {
+      delete node;
+    }
+    throw;
+  }
+
+  LinkSorted(nodes);
+  finger = nullptr;
+  IndexNodes();
+
+  for (Node *node : removed) {
+    DestroyNode(node);
+  }
+
+  return res;
+}
+
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+typename RedBlackTree<Key, Compare, Lookup, Augment>::Node *
+RedBlackTree<Key, Compare, Lookup, Augment>::FingerLowerBound(
+    Node *start, const_reference key) const {
+  if (!GetRoot()) {
+    return head;
+  }
+
+  Node *node = start;
+  if (node == head) {
+    node = GetMaxNode();
+    if (IsLess(node->key, key)) {
+      return head;
+    }
+  }
+
+  // Climb until the subtree of node is known to hold the lower bound (or the
+  // lower bound is the parent we stopped below), then descend as usual. Only
+  // the levels up to the common ancestor of start and the result are visited.
+  Node *res = head;
+  if (IsLess(node->key, key)) {
+    while (node != head->parent) {
+      Node *parent = node->parent;
+      if (node == parent->left && !IsLess(parent->key, key)) {
+        res = parent;
+        break;
+      }
+      node = parent;
+    }
+  } else {
+    res = node;
+    while (node != head->parent) {
+      Node *parent = node->parent;
+      if (node == parent->right && IsLess(parent->key, key)) {
+        break;
+      }
+      node = parent;
+    }
+  }
+
+  while (node) {
+    if (!IsLess(node->key, key)) {
+      res = node;
+      node = node->left;
+    } else {
+      node = node->right;
+    }
+  }
+
+  return res;
+}
+
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+void RedBlackTree<Key, Compare, Lookup, Augment>::InsertBefore(Node *position,
+                                                               Node *new_node) {
+  if (!GetRoot()) {
+    new_node->color = Color::kBlack;
+    new_node->parent = head;
+    SetRoot(new_node);
+    UpdateSizeAndMinMaxNode(new_node);
+    UpdateAugment(new_node);
+    lookup.Insert(new_node);
+    return;
+  }
+
+  Node *parent;
+  if (position == head) {
+    parent = GetMaxNode();
+    parent->right = new_node;
+  } else if (!position->left) {
+    parent = position;
+    parent->left = new_node;
+  } else {
+    parent = SearchMaxNode(position->left);
+    parent->right = new_node;
+  }
+
+  new_node->parent = parent;
+  UpdateSizeAndMinMaxNode(new_node);
+  UpdateAugmentUp(new_node);
+  BalanceForInsert(new_node);
+  lookup.Insert(new_node);
+}
+
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+void RedBlackTree<Key, Compare, Lookup, Augment>::ReplaceNode(Node *node,
+                                                              Node *new_node) {
+  new_node->parent = node->parent;
+  new_node->left = node->left;
+  new_node->right = node->right;
+  new_node->color = node->color;
+
+  if (node == GetRoot()) {
+    SetRoot(new_node);
+  } else if (node->parent->left == node) {
+    node->parent->left = new_node;
+  } else {
+    node->parent->right = new_node;
+  }
+  UpdateParent(new_node);
+  UpdateAugmentUp(new_node);
+
+  if (GetMinNode() == node) {
+    SetMinNode(new_node);
+  }
+  if (GetMaxNode() == node) {
+    SetMaxNode(new_node);
+  }
+  if (finger == node) {
+    finger = new_node;
+  }
+
+  lookup.Erase(node);
+  lookup.Insert(new_node);
+  DestroyNode(node);
+}
+
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+void RedBlackTree<Key, Compare, Lookup, Augment>::LinkSorted(
+    const std::vector<Node *> &nodes) {
+  tree_size = nodes.size();
+
+  if (nodes.empty()) {
+    SetupHead();
+    return;
+  }
+
+  Node *root = LinkSubtree(nodes.data(), nodes.size(), 0,
+                           GetRedDepth(nodes.size()));
+  root->parent = head;
+  SetRoot(root);
+  SetMinNode(nodes.front());
+  SetMaxNode(nodes.back());
+}
+
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+typename RedBlackTree<Key, Compare, Lookup, Augment>::Node *
+RedBlackTree<Key, Compare, Lookup, Augment>::LinkSubtree(Node *const *nodes,
+                                                         size_type count,
+                                                         size_type depth,
+                                                         size_type red_depth) {
+  if (count == 0) {
+    return nullptr;
+  }
+
+  size_type left_count = (count - 1) / 2;
+  Node *node = nodes[left_count];
+
+  node->color = depth == red_depth ? Color::kRed : Color::kBlack;
+  node->left = LinkSubtree(nodes, left_count, depth + 1, red_depth);
+  node->right = LinkSubtree(nodes + left_count + 1, count - 1 - left_count,
+                            depth + 1, red_depth);
+  UpdateParent(node);
+  UpdateAugment(node);
+
+  return node;
+}
+
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+void RedBlackTree<Key, Compare, Lookup, Augment>::Erase(iterator position) {
   Node *extracted_node = ExtractNode(position);
 
-  delete extracted_node;
+  if (extracted_node) {
+    DestroyNode(extracted_node);
+  }
 }
 
-template <typename Key, typename Compare>
-typename RedBlackTree<Key, Compare>::Node *
-RedBlackTree<Key, Compare>::ExtractNode(iterator pos) {
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+typename RedBlackTree<Key, Compare, Lookup, Augment>::key_type
+RedBlackTree<Key, Compare, Lookup, Augment>::ExtractKey(iterator position) {
+  Node *extracted_node = ExtractNode(position);
+
+  try {
+    key_type key = std::move(extracted_node->key);
+    DestroyNode(extracted_node);
+    extracted_node = nullptr;
+    return key;
+  } catch (...) {
+    if (extracted_node) {
+      DestroyNode(extracted_node);
+    }
+    throw;
+  }
+}
+
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+typename RedBlackTree<Key, Compare, Lookup, Augment>::Node *
+RedBlackTree<Key, Compare, Lookup, Augment>::ExtractNode(iterator pos) {
   if (pos == End()) {
     return nullptr;
   }
 
   Node *extracted_node = pos.node_;
+  if (finger == extracted_node) {
+    finger = nullptr;
+  }
+  lookup.Erase(extracted_node);
+  bool moved = false;
+
+  // The neighbour of an extreme node becomes the new extreme. Stepping to it
+  // is amortized O(1), unlike a descent from the root.
+  Node *new_min =
+      extracted_node == GetMinNode() ? extracted_node->GetNextNode() : nullptr;
+  Node *new_max = extracted_node == GetMaxNode()
+                      ? extracted_node->GetPreviousNode()
+                      : nullptr;
 
   if (extracted_node->left && extracted_node->right) {
     Node *replace = SearchMinNode(extracted_node->right);
     SwapForErase(extracted_node, replace);
+    moved = true;
   }
 
   if (extracted_node->color == Color::kBlack &&
@@ -455,22 +1429,30 @@ RedBlackTree<Key, Compare>::ExtractNode(iterator pos) {
       replace = extracted_node->right;
     }
     SwapForErase(extracted_node, replace);
+    moved = true;
   }
 
+  // The node is a leaf now. Rotations need up-to-date augment data below
+  // them, so the path the node moved down is refreshed before rebalancing.
   if (extracted_node->color == Color::kBlack && !extracted_node->left &&
       !extracted_node->right) {
+    if (moved) {
+      UpdateAugmentUp(extracted_node);
+    }
     BalanceForErase(extracted_node);
   }
 
+  Node *parent = extracted_node->parent;
   ExtractFromTree(extracted_node);
+  UpdateAugmentUp(parent);
 
-  UpdateParam(extracted_node);
+  UpdateParam(extracted_node, new_min, new_max);
 
   return extracted_node;
 }
 
-template <typename Key, typename Compare>
-void RedBlackTree<Key, Compare>::ExtractFromTree(Node *node) {
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+void RedBlackTree<Key, Compare, Lookup, Augment>::ExtractFromTree(Node *node) {
   if (node == GetRoot()) {
     SetupHead();
   } else {
@@ -482,14 +1464,16 @@ void RedBlackTree<Key, Compare>::ExtractFromTree(Node *node) {
   }
 }
 
-template <typename Key, typename Compare>
-void RedBlackTree<Key, Compare>::UpdateParam(Node *node) {
-  if (GetMinNode() == node) {
-    SetMinNode(SearchMinNode(GetRoot()));
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+void RedBlackTree<Key, Compare, Lookup, Augment>::UpdateParam(Node *node,
+                                                              Node *new_min,
+                                                              Node *new_max) {
+  if (new_min) {
+    SetMinNode(new_min);
   }
 
-  if (GetMaxNode() == node) {
-    SetMaxNode(SearchMaxNode(GetRoot()));
+  if (new_max) {
+    SetMaxNode(new_max);
   }
 
   --tree_size;
@@ -497,8 +1481,9 @@ void RedBlackTree<Key, Compare>::UpdateParam(Node *node) {
   node->ToDefault();
 }
 
-template <typename Key, typename Compare>
-void RedBlackTree<Key, Compare>::SwapForErase(Node *node, Node *other) {
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+void RedBlackTree<Key, Compare, Lookup, Augment>::SwapForErase(Node *node,
+                                                               Node *other) {
   if (other->parent->left == other) {
     other->parent->left = node;
   } else {
@@ -521,16 +1506,17 @@ void RedBlackTree<Key, Compare>::SwapForErase(Node *node, Node *other) {
   UpdateParent(other);
 }
 
-template <typename KeyType, typename Compare>
-void RedBlackTree<KeyType, Compare>::SwapNode(Node *node_1, Node *node_2) {
+template <typename KeyType, typename Compare, typename Lookup, typename Augment>
+void RedBlackTree<KeyType, Compare, Lookup, Augment>::SwapNode(Node *node_1,
+                                                               Node *node_2) {
   std::swap(node_1->parent, node_2->parent);
   std::swap(node_1->left, node_2->left);
   std::swap(node_1->right, node_2->right);
   std::swap(node_1->color, node_2->color);
 }
 
-template <typename KeyType, typename Compare>
-void RedBlackTree<KeyType, Compare>::UpdateParent(Node *node) {
+template <typename KeyType, typename Compare, typename Lookup, typename Augment>
+void RedBlackTree<KeyType, Compare, Lookup, Augment>::UpdateParent(Node *node) {
   if (node->left) {
     node->left->parent = node;
   }
@@ -540,8 +1526,10 @@ void RedBlackTree<KeyType, Compare>::UpdateParent(Node *node) {
   }
 }
 
-template <typename KeyType, typename Comparator>
-void RedBlackTree<KeyType, Comparator>::BalanceForErase(Node *extracted_node) {
+template <typename KeyType, typename Comparator, typename Lookup,
+          typename Augment>
+void RedBlackTree<KeyType, Comparator, Lookup, Augment>::BalanceForErase(
+    Node *extracted_node) {
   Node *parent = extracted_node->parent;
 
   while (extracted_node != GetRoot() &&
@@ -611,49 +1599,52 @@ void RedBlackTree<KeyType, Comparator>::BalanceForErase(Node *extracted_node) {
   }
 }
 
-template <typename KeyType, typename Compare>
-bool RedBlackTree<KeyType, Compare>::isRed(Node *node) const {
+template <typename KeyType, typename Compare, typename Lookup, typename Augment>
+bool RedBlackTree<KeyType, Compare, Lookup, Augment>::isRed(Node *node) const {
   return node->color == Color::kRed;
 }
 
-template <typename KeyType, typename Compare>
-bool RedBlackTree<KeyType, Compare>::IsChildrenBlack(Node *node) const {
+template <typename KeyType, typename Compare, typename Lookup, typename Augment>
+bool RedBlackTree<KeyType, Compare, Lookup, Augment>::IsChildrenBlack(
+    Node *node) const {
   return (!node->left || node->left->color == Color::kBlack) &&
          (!node->right || node->right->color == Color::kBlack);
 }
 
-template <typename KeyType, typename Compare>
-bool RedBlackTree<KeyType, Compare>::IsLeftChildRed(Node *node) const {
+template <typename KeyType, typename Compare, typename Lookup, typename Augment>
+bool RedBlackTree<KeyType, Compare, Lookup, Augment>::IsLeftChildRed(
+    Node *node) const {
   return node->left && node->left->color == Color::kRed &&
          (!node->right || node->right->color == Color::kBlack);
 }
 
-template <typename KeyType, typename Compare>
-bool RedBlackTree<KeyType, Compare>::IsRightChildRed(Node *node) const {
+template <typename KeyType, typename Compare, typename Lookup, typename Augment>
+bool RedBlackTree<KeyType, Compare, Lookup, Augment>::IsRightChildRed(
+    Node *node) const {
   return node->right && node->right->color == Color::kRed &&
          (!node->left || node->left->color == Color::kBlack);
 }
 
-template <typename Key, typename Compare>
-typename RedBlackTree<Key, Compare>::Node *
-RedBlackTree<Key, Compare>::SearchMinNode(Node *node) const {
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+typename RedBlackTree<Key, Compare, Lookup, Augment>::Node *
+RedBlackTree<Key, Compare, Lookup, Augment>::SearchMinNode(Node *node) const {
   while (true) {
     if (!node->left) return node;
     node = node->left;
   }
 }
 
-template <typename Key, typename Compare>
-typename RedBlackTree<Key, Compare>::Node *
-RedBlackTree<Key, Compare>::SearchMaxNode(Node *node) const {
+template <typename Key, typename Compare, typename Lookup, typename Augment>
+typename RedBlackTree<Key, Compare, Lookup, Augment>::Node *
+RedBlackTree<Key, Compare, Lookup, Augment>::SearchMaxNode(Node *node) const {
   while (true) {
     if (!node->right) return node;
     node = node->right;
   }
 }
 
-template <typename KeyType, typename Compare>
-bool RedBlackTree<KeyType, Compare>::CheckTree() const {
+template <typename KeyType, typename Compare, typename Lookup, typename Augment>
+bool RedBlackTree<KeyType, Compare, Lookup, Augment>::CheckTree() const {
   if (!GetRoot()) {
     return true;
   }
@@ -677,8 +1668,9 @@ bool RedBlackTree<KeyType, Compare>::CheckTree() const {
   return true;
 }
 
-template <typename KeyType, typename Compare>
-bool RedBlackTree<KeyType, Compare>::CheckRedNodes(const Node *node) const {
+template <typename KeyType, typename Compare, typename Lookup, typename Augment>
+bool RedBlackTree<KeyType, Compare, Lookup, Augment>::CheckRedNodes(
+    const Node *node) const {
   if (node->color == Color::kRed) {
     if (node->left && node->left->color == Color::kRed) {
       return false;
@@ -703,8 +1695,9 @@ bool RedBlackTree<KeyType, Compare>::CheckRedNodes(const Node *node) const {
   return true;
 }
 
-template <typename KeyType, typename Compare>
-int RedBlackTree<KeyType, Compare>::CheckBlackHeight(const Node *node) const {
+template <typename KeyType, typename Compare, typename Lookup, typename Augment>
+int RedBlackTree<KeyType, Compare, Lookup, Augment>::CheckBlackHeight(
+    const Node *node) const {
   if (!node) {
     return 0;
   }
@@ -0,0 +1,51 @@
+#ifndef CONTAINERS_RED_BLACK_TREE_TREE_LOOKUP_H_
+#define CONTAINERS_RED_BLACK_TREE_TREE_LOOKUP_H_
+
+#include <cstddef>
+#include <type_traits>
+
+namespace RBtreeMapSet {
+
+// Lookup policies let RedBlackTree keep a side index of its nodes for point
+// lookups. Lookup::Index<Key, Node> is told about every node that enters
+// (Insert) or leaves (Erase, Clear) the tree. Reserve(count) may allocate
+// and throw; afterwards Insert must not allocate until the index holds count
+// nodes. Find returns the node of an equal key or nullptr. If kComplete is
+// set, nullptr means that no such key is stored; otherwise the tree is
+// searched and the node it finds is passed to Touch.
+//
+// TreeLookup keeps no index, so every lookup descends the tree.
+struct TreeLookup {
+  template <typename Key, typename Node>
+  struct Index {
+    static constexpr bool kComplete = false;
+
+    void Reserve(std::size_t) {}
+    void Insert(Node *) noexcept {}
+    void Erase(const Node *) noexcept {}
+    void Clear() noexcept {}
+
+    template <typename Equal>
+    Node *Find(const Key &, Equal) noexcept {
+      return nullptr;
+    }
+
+    void Touch(Node *) noexcept {}
+    std::size_t GetMemoryUsage() const noexcept { return 0; }
+  };
+};
+
+// Hash of a tree key for lookup policies. For map the tree key is the
+// (key, value) pair and only its key is hashed.
+template <typename Hash, typename Key>
+std::size_t HashKey(const Hash &hash, const Key &key) noexcept {
+  if constexpr (std::is_invocable_v<const Hash &, const Key &>) {
+    return hash(key);
+  } else {
+    return hash(key.first);
+  }
+}
+
+}  // namespace RBtreeMapSet
+
+#endif  // CONTAINERS_RED_BLACK_TREE_TREE_LOOKUP_H_
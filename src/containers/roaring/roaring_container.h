@@ -0,0 +1,100 @@
+#ifndef CONTAINERS_ROARING_ROARING_CONTAINER_H_
+#define CONTAINERS_ROARING_ROARING_CONTAINER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace RBtreeMapSet {
+
+// The 2^16 low values that share the high bits of an int_set chunk, stored
+// in whichever of three forms is smallest, as in Roaring bitmaps:
+//
+// - kArray: up to kArrayMax sorted values, 2 bytes each;
+// - kBitmap: one bit per possible value, 8 KiB, once there are more;
+// - kRun: the first and last value of each run of consecutive values,
+//   4 bytes per run, chosen by Optimize for clustered values.
+//
+// Inserts and erases switch between arrays and bitmaps at kArrayMax values.
+// Run containers are edited in place and turn into the other forms when
+// their runs fragment. Set operations work on 64-bit words with popcount
+// whenever a bitmap is involved.
+class RoaringContainer {
+ public:
+  enum class Kind : std::uint8_t { kArray, kBitmap, kRun };
+
+  static constexpr std::uint32_t kArrayMax = 4096;
+  static constexpr std::size_t kWords = 1024;
+  static constexpr std::uint32_t kNone = 0x10000;
+
+  // A value of the container and where it is stored: its index in the
+  // array, or the index of its run.
+  struct Position {
+    std::uint32_t index;
+    std::uint32_t low;
+  };
+
+  bool Contains(std::uint16_t low) const noexcept;
+  bool Insert(std::uint16_t low);
+  bool Erase(std::uint16_t low);
+
+  std::uint32_t GetCardinality() const noexcept;
+  bool IsEmpty() const noexcept;
+  Kind GetKind() const noexcept;
+  std::size_t GetMemoryUsage() const noexcept;
+
+  // Iteration in increasing order. Next and Previous return false when
+  // there is no further value; LowerBound when no value is >= low.
+  Position Front() const noexcept;
+  Position Back() const noexcept;
+  bool Next(Position &position) const noexcept;
+  bool Previous(Position &position) const noexcept;
+  bool LowerBound(std::uint32_t low, Position &position) const noexcept;
+
+  // Stores the values as runs if that is the smallest form, and leaves run
+  // form if it is not.
+  void Optimize();
+
+  static RoaringContainer Union(const RoaringContainer &a,
+                                const RoaringContainer &b);
+  static RoaringContainer Intersection(const RoaringContainer &a,
+                                       const RoaringContainer &b);
+  static RoaringContainer Difference(const RoaringContainer &a,
+                                     const RoaringContainer &b);
+
+  bool operator==(const RoaringContainer &other) const;
+
+ private:
+  static std::uint32_t PopCount(std::uint64_t word) noexcept;
+  static std::uint32_t TrailingZeros(std::uint64_t word) noexcept;
+  static std::uint32_t LeadingZeros(std::uint64_t word) noexcept;
+  static void SetRange(std::uint64_t *bits, std::uint32_t first,
+                       std::uint32_t last) noexcept;
+
+  std::size_t FindRun(std::uint32_t low) const noexcept;
+  // First value >= from that is set, or unset if flip is all ones.
+  std::uint32_t NextBit(std::uint32_t from,
+                        std::uint64_t flip = 0) const noexcept;
+  std::uint32_t PreviousBit(std::uint32_t from) const noexcept;
+  std::size_t CountRuns() const noexcept;
+  std::vector<std::uint64_t> MakeWords() const;
+  std::vector<std::uint16_t> MakeArray() const;
+  std::vector<std::uint16_t> MakeRuns() const;
+  void SetWords(std::vector<std::uint64_t> bits) noexcept;
+  void SetArray(std::vector<std::uint16_t> array) noexcept;
+  void SetRuns(std::vector<std::uint16_t> runs) noexcept;
+  void Normalize();
+
+  // Sorted values for kArray; the first and last value of each run, in
+  // turn, for kRun.
+  std::vector<std::uint16_t> values;
+  // kWords words for kBitmap, empty otherwise.
+  std::vector<std::uint64_t> words;
+  std::uint32_t cardinality = 0;
+  Kind kind = Kind::kArray;
+};
+
+}  // namespace RBtreeMapSet
+
+#include "roaring_container.tpp"
+#endif  // CONTAINERS_ROARING_ROARING_CONTAINER_H_
@@ -0,0 +1,658 @@
+#include <algorithm>
+#include <utility>
+
+#include "roaring_container.h"
+
+namespace RBtreeMapSet {
+
+inline std::uint32_t RoaringContainer::PopCount(std::uint64_t word) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_popcountll(word);
+#else
+  std::uint32_t count = 0;
+  for (; word; word &= word - 1) {
+    ++count;
+  }
+  return count;
+#endif
+}
+
+inline std::uint32_t RoaringContainer::TrailingZeros(
+    std::uint64_t word) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_ctzll(word);
+#else
+  std::uint32_t count = 0;
+  for (; !(word & 1); word >>= 1) {
+    ++count;
+  }
+  return count;
+#endif
+}
+
+inline std::uint32_t RoaringContainer::LeadingZeros(
+    std::uint64_t word) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_clzll(word);
+#else
+  std::uint32_t count = 0;
+  for (; !(word >> 63); word <<= 1) {
+    ++count;
+  }
+  return count;
+#endif
+}
+
+inline void RoaringContainer::SetRange(std::uint64_t *bits,
+                                       std::uint32_t first,
+                                       std::uint32_t last) noexcept {
+  std::size_t first_word = first >> 6;
+  std::size_t last_word = last >> 6;
+  std::uint64_t first_mask = ~std::uint64_t{0} << (first & 63);
+  std::uint64_t last_mask = ~std::uint64_t{0} >> (63 - (last & 63));
+
+  if (first_word == last_word) {
+    bits[first_word] |= first_mask & last_mask;
+    return;
+  }
+
+  bits[first_word] |= first_mask;
+  std::fill(bits + first_word + 1, bits + last_word, ~std::uint64_t{0});
+  bits[last_word] |= last_mask;
+}
+
+inline bool RoaringContainer::Contains(std::uint16_t low) const noexcept {
+  switch (kind) {
+    case Kind::kArray:
+      return std::binary_search(values.begin(), values.end(), low);
+    case Kind::kBitmap:
+      return words[low >> 6] >> (low & 63) & 1;
+    case Kind::kRun: {
+      std::size_t run = FindRun(low);
+      return run < values.size() / 2 && values[2 * run] <= low;
+    }
+  }
+  return false;
+}
+
+inline bool RoaringContainer::Insert(std::uint16_t low) {
+  switch (kind) {
+    case Kind::kArray: {
+      auto it = std::lower_bound(values.begin(), values.end(), low);
+      if (it != values.end() && *it == low) {
+        return false;
+      }
+      if (cardinality == kArrayMax) {
+        SetWords(MakeWords());
+        return Insert(low);
+      }
+      values.insert(it, low);
+      break;
+    }
+    case Kind::kBitmap: {
+      std::uint64_t bit = std::uint64_t{1} << (low & 63);
+      if (words[low >> 6] & bit) {
+        return false;
+      }
+      words[low >> 6] |= bit;
+      break;
+    }
+    case Kind::kRun: {
+      std::size_t run = FindRun(low);
+      std::size_t runs = values.size() / 2;
+      if (run < runs && values[2 * run] <= low) {
+        return false;
+      }
+
+      bool joins_previous = run > 0 && values[2 * run - 1] + 1 == low;
+      bool joins_next = run < runs && values[2 * run] == low + 1;
+      if (joins_previous && joins_next) {
+        values[2 * run - 1] = values[2 * run + 1];
+        values.erase(values.begin() + 2 * run, values.begin() + 2 * run + 2);
+      } else if (joins_previous) {
+        values[2 * run - 1] = low;
+      } else if (joins_next) {
+        values[2 * run] = low;
+      } else {
+        values.insert(values.begin() + 2 * run, {low, low});
+      }
+      ++cardinality;
+      Normalize();
+      return true;
+    }
+  }
+
+  ++cardinality;
+  return true;
+}
+
+inline bool RoaringContainer::Erase(std::uint16_t low) {
+  switch (kind) {
+    case Kind::kArray: {
+      auto it = std::lower_bound(values.begin(), values.end(), low);
+      if (it == values.end() || *it != low) {
+        return false;
+      }
+      values.erase(it);
+      break;
+    }
+    case Kind::kBitmap: {
+      std::uint64_t bit = std::uint64_t{1} << (low & 63);
+      if (!(words[low >> 6] & bit)) {
+        return false;
+      }
+      words[low >> 6] &= ~bit;
+      break;
+    }
+    case Kind::kRun: {
+      std::size_t run = FindRun(low);
+      if (run == values.size() / 2 || values[2 * run] > low) {
+        return false;
+      }
+
+      std::uint16_t first = values[2 * run];
+      std::uint16_t last = values[2 * run + 1];
+      if (first == last) {
+        values.erase(values.begin() + 2 * run, values.begin() + 2 * run + 2);
+      } else if (low == first) {
+        values[2 * run] = low + 1;
+      } else if (low == last) {
+        values[2 * run + 1] = low - 1;
+      } else {
+        values.insert(values.begin() + 2 * run + 1,
+                      {static_cast<std::uint16_t>(low - 1),
+                       static_cast<std::uint16_t>(low + 1)});
+      }
+      break;
+    }
+  }
+
+  --cardinality;
+  Normalize();
+  return true;
+}
+
+inline std::uint32_t RoaringContainer::GetCardinality() const noexcept {
+  return cardinality;
+}
+
+inline bool RoaringContainer::IsEmpty() const noexcept {
+  return cardinality == 0;
+}
+
+inline RoaringContainer::Kind RoaringContainer::GetKind() const noexcept {
+  return kind;
+}
+
+inline std::size_t RoaringContainer::GetMemoryUsage() const noexcept {
+  return values.capacity() * sizeof(std::uint16_t) +
+         words.capacity() * sizeof(std::uint64_t);
+}
+
+inline RoaringContainer::Position RoaringContainer::Front() const noexcept {
+  if (kind == Kind::kBitmap) {
+    return {0, NextBit(0)};
+  }
+  return {0, values.front()};
+}
+
+inline RoaringContainer::Position RoaringContainer::Back() const noexcept {
+  switch (kind) {
+    case Kind::kArray:
+      return {static_cast<std::uint32_t>(values.size() - 1), values.back()};
+    case Kind::kBitmap:
+      return {0, PreviousBit(kNone - 1)};
+    case Kind::kRun:
+      return {static_cast<std::uint32_t>(values.size() / 2 - 1),
+              values.back()};
+  }
+  return {0, 0};
+}
+
+inline bool RoaringContainer::Next(Position &position) const noexcept {
+  switch (kind) {
+    case Kind::kArray:
+      if (position.index + 1 >= values.size()) {
+        return false;
+      }
+      position.low = values[++position.index];
+      return true;
+    case Kind::kBitmap: {
+      std::uint32_t low = NextBit(position.low + 1);
+      if (low == kNone) {
+        return false;
+      }
+      position.low = low;
+      return true;
+    }
+    case Kind::kRun:
+      if (position.low < values[2 * position.index + 1]) {
+        ++position.low;
+        return true;
+      }
+      if (2 * (position.index + 1) >= values.size()) {
+        return false;
+      }
+      position.low = values[2 * ++position.index];
+      return true;
+  }
+  return false;
+}
+
+inline bool RoaringContainer::Previous(Position &position) const noexcept {
+  switch (kind) {
+    case Kind::kArray:
+      if (position.index == 0) {
+        return false;
+      }
+      position.low = values[--position.index];
+      return true;
+    case Kind::kBitmap: {
+      std::uint32_t low =
+          position.low == 0 ? kNone : PreviousBit(position.low - 1);
+      if (low == kNone) {
+        return false;
+      }
+      position.low = low;
+      return true;
+    }
+    case Kind::kRun:
+      if (position.low > values[2 * position.index]) {
+        --position.low;
+        return true;
+      }
+      if (position.index == 0) {
+        return false;
+      }
+      position.low = values[2 * --position.index + 1];
+      return true;
+  }
+  return false;
+}
+
+inline bool RoaringContainer::LowerBound(std::uint32_t low,
+                                         Position &position) const noexcept {
+  switch (kind) {
+    case Kind::kArray: {
+      auto it = std::lower_bound(values.begin(), values.end(), low);
+      if (it == values.end()) {
+        return false;
+      }
+      position = {static_cast<std::uint32_t>(it - values.begin()), *it};
+      return true;
+    }
+    case Kind::kBitmap:
+      position = {0, NextBit(low)};
+      return position.low != kNone;
+    case Kind::kRun: {
+      std::size_t run = FindRun(low);
+      if (run == values.size() / 2) {
+        return false;
+      }
+      position = {static_cast<std::uint32_t>(run),
+                  std::max<std::uint32_t>(low, values[2 * run])};
+      return true;
+    }
+  }
+  return false;
+}
+
+inline void RoaringContainer::Optimize() {
+  std::size_t run_bytes = CountRuns() * 2 * sizeof(std::uint16_t);
+  std::size_t other_bytes = cardinality <= kArrayMax
+                                ? cardinality * sizeof(std::uint16_t)
+                                : kWords * sizeof(std::uint64_t);
+
+  if (run_bytes < other_bytes) {
+    if (kind != Kind::kRun) {
+      SetRuns(MakeRuns());
+    }
+  } else if (kind == Kind::kRun) {
+    if (cardinality <= kArrayMax) {
+      SetArray(MakeArray());
+    } else {
+      SetWords(MakeWords());
+    }
+  }
+  values.shrink_to_fit();
+}
+
+inline RoaringContainer RoaringContainer::Union(const RoaringContainer &a,
+                                                const RoaringContainer &b) {
+  RoaringContainer res;
+
+  if (a.kind == Kind::kArray && b.kind == Kind::kArray &&
+      a.cardinality + b.cardinality <= kArrayMax) {
+    std::vector<std::uint16_t> array(a.cardinality + b.cardinality);
+    array.erase(std::set_union(a.values.begin(), a.values.end(),
+                               b.values.begin(), b.values.end(),
+                               array.begin()),
+                array.end());
+    res.SetArray(std::move(array));
+    return res;
+  }
+
+  const RoaringContainer &bits_source = b.kind == Kind::kBitmap ? b : a;
+  const RoaringContainer &other = b.kind == Kind::kBitmap ? a : b;
+  std::vector<std::uint64_t> bits = bits_source.MakeWords();
+
+  switch (other.kind) {
+    case Kind::kBitmap:
+      for (std::size_t i = 0; i < kWords; ++i) {
+        bits[i] |= other.words[i];
+      }
+      break;
+    case Kind::kArray:
+      for (std::uint16_t low : other.values) {
+        bits[low >> 6] |= std::uint64_t{1} << (low & 63);
+      }
+      break;
+    case Kind::kRun:
+      for (std::size_t i = 0; i < other.values.size(); i += 2) {
+        SetRange(bits.data(), other.values[i], other.values[i + 1]);
+      }
+      break;
+  }
+
+  res.SetWords(std::move(bits));
+  res.Normalize();
+  return res;
+}
+
+inline RoaringContainer RoaringContainer::Intersection(
+    const RoaringContainer &a, const RoaringContainer &b) {
+  RoaringContainer res;
+
+  if (a.kind == Kind::kArray && b.kind == Kind::kArray) {
+    std::vector<std::uint16_t> array(std::min(a.cardinality, b.cardinality));
+    array.erase(std::set_intersection(a.values.begin(), a.values.end(),
+                                      b.values.begin(), b.values.end(),
+                                      array.begin()),
+                array.end());
+    res.SetArray(std::move(array));
+    return res;
+  }
+
+  if (a.kind == Kind::kArray || b.kind == Kind::kArray) {
+    const RoaringContainer &array_source = a.kind == Kind::kArray ? a : b;
+    const RoaringContainer &other = a.kind == Kind::kArray ? b : a;
+    std::vector<std::uint16_t> array;
+    array.reserve(array_source.cardinality);
+    for (std::uint16_t low : array_source.values) {
+      if (other.Contains(low)) {
+        array.push_back(low);
+      }
+    }
+    res.SetArray(std::move(array));
+    return res;
+  }
+
+  std::vector<std::uint64_t> bits = a.MakeWords();
+  std::vector<std::uint64_t> other_bits;
+  const std::uint64_t *other_words = b.words.data();
+  if (b.kind != Kind::kBitmap) {
+    other_bits = b.MakeWords();
+    other_words = other_bits.data();
+  }
+
+  for (std::size_t i = 0; i < kWords; ++i) {
+    bits[i] &= other_words[i];
+  }
+
+  res.SetWords(std::move(bits));
+  res.Normalize();
+  return res;
+}
+
+inline RoaringContainer RoaringContainer::Difference(
+    const RoaringContainer &a, const RoaringContainer &b) {
+  RoaringContainer res;
+
+  if (a.kind == Kind::kArray) {
+    std::vector<std::uint16_t> array;
+    if (b.kind == Kind::kArray) {
+      array.resize(a.cardinality);
+      array.erase(std::set_difference(a.values.begin(), a.values.end(),
+                                      b.values.begin(), b.values.end(),
+                                      array.begin()),
+                  array.end());
+    } else {
+      array.reserve(a.cardinality);
+      for (std::uint16_t low : a.values) {
+        if (!b.Contains(low)) {
+          array.push_back(low);
+        }
+      }
+    }
+    res.SetArray(std::move(array));
+    return res;
+  }
+
+  std::vector<std::uint64_t> bits = a.MakeWords();
+  std::vector<std::uint64_t> other_bits;
+  const std::uint64_t *other_words = b.words.data();
+  if (b.kind != Kind::kBitmap) {
+    other_bits = b.MakeWords();
+    other_words = other_bits.data();
+  }
+
+  for (std::size_t i = 0; i < kWords; ++i) {
+    bits[i] &= ~other_words[i];
+  }
+
+  res.SetWords(std::move(bits));
+  res.Normalize();
+  return res;
+}
+
+inline bool RoaringContainer::operator==(const RoaringContainer &other) const {
+  if (cardinality != other.cardinality) {
+    return false;
+  }
+
+  if (kind == other.kind) {
+    return values == other.values && words == other.words;
+  }
+
+  return MakeWords() == other.MakeWords();
+}
+
+// Index of the first run that ends at or after low.
+inline std::size_t RoaringContainer::FindRun(std::uint32_t low) const noexcept {
+  std::size_t first = 0;
+  std::size_t last = values.size() / 2;
+
+  while (first < last) {
+    std::size_t middle = (first + last) / 2;
+    if (values[2 * middle + 1] < low) {
+      first = middle + 1;
+    } else {
+      last = middle;
+    }
+  }
+
+  return first;
+}
+
+inline std::uint32_t RoaringContainer::NextBit(
+    std::uint32_t from, std::uint64_t flip) const noexcept {
+  if (from >= kNone) {
+    return kNone;
+  }
+
+  std::size_t i = from >> 6;
+  std::uint64_t word = (words[i] ^ flip) & (~std::uint64_t{0} << (from & 63));
+
+  while (!word) {
+    if (++i == kWords) {
+      return kNone;
+    }
+    word = words[i] ^ flip;
+  }
+
+  return static_cast<std::uint32_t>(i * 64 + TrailingZeros(word));
+}
+
+inline std::uint32_t RoaringContainer::PreviousBit(
+    std::uint32_t from) const noexcept {
+  std::size_t i = from >> 6;
+  std::uint64_t word = words[i] & (~std::uint64_t{0} >> (63 - (from & 63)));
+
+  while (!word) {
+    if (i-- == 0) {
+      return kNone;
+    }
+    word = words[i];
+  }
+
+  return static_cast<std::uint32_t>(i * 64 + 63 - LeadingZeros(word));
+}
+
+inline std::size_t RoaringContainer::CountRuns() const noexcept {
+  std::size_t runs = 0;
+
+  switch (kind) {
+    case Kind::kArray:
+      for (std::size_t i = 0; i < values.size(); ++i) {
+        runs += i == 0 || values[i] != values[i - 1] + 1;
+      }
+      break;
+    case Kind::kBitmap: {
+      // A run starts at every set bit whose lower neighbour is clear.
+      std::uint64_t carry = 0;
+      for (std::uint64_t word : words) {
+        runs += PopCount(word & ~(word << 1 | carry));
+        carry = word >> 63;
+      }
+      break;
+    }
+    case Kind::kRun:
+      runs = values.size() / 2;
+      break;
+  }
+
+  return runs;
+}
+
+inline std::vector<std::uint64_t> RoaringContainer::MakeWords() const {
+  if (kind == Kind::kBitmap) {
+    return words;
+  }
+
+  std::vector<std::uint64_t> bits(kWords);
+  if (kind == Kind::kArray) {
+    for (std::uint16_t low : values) {
+      bits[low >> 6] |= std::uint64_t{1} << (low & 63);
+    }
+  } else {
+    for (std::size_t i = 0; i < values.size(); i += 2) {
+      SetRange(bits.data(), values[i], values[i + 1]);
+    }
+  }
+
+  return bits;
+}
+
+inline std::vector<std::uint16_t> RoaringContainer::MakeArray() const {
+  if (kind == Kind::kArray) {
+    return values;
+  }
+
+  std::vector<std::uint16_t> array;
+  array.reserve(cardinality);
+  if (kind == Kind::kBitmap) {
+    for (std::size_t i = 0; i < kWords; ++i) {
+      for (std::uint64_t word = words[i]; word; word &= word - 1) {
+        array.push_back(
+            static_cast<std::uint16_t>(i * 64 + TrailingZeros(word)));
+      }
+    }
+  } else {
+    for (std::size_t i = 0; i < values.size(); i += 2) {
+      for (std::uint32_t low = values[i]; low <= values[i + 1]; ++low) {
+        array.push_back(static_cast<std::uint16_t>(low));
+      }
+    }
+  }
+
+  return array;
+}
+
+inline std::vector<std::uint16_t> RoaringContainer::MakeRuns() const {
+  if (kind == Kind::kRun) {
+    return values;
+  }
+
+  std::vector<std::uint16_t> runs;
+  runs.reserve(CountRuns() * 2);
+  if (kind == Kind::kArray) {
+    for (std::size_t i = 0; i < values.size(); ++i) {
+      if (i == 0 || values[i] != values[i - 1] + 1) {
+        runs.push_back(values[i]);
+        runs.push_back(values[i]);
+      } else {
+        runs.back() = values[i];
+      }
+    }
+  } else {
+    for (std::uint32_t first = NextBit(0); first != kNone;) {
+      std::uint32_t end = NextBit(first, ~std::uint64_t{0});
+      runs.push_back(static_cast<std::uint16_t>(first));
+      runs.push_back(static_cast<std::uint16_t>(end - 1));
+      first = NextBit(end);
+    }
+  }
+
+  return runs;
+}
+
+inline void RoaringContainer::SetWords(
+    std::vector<std::uint64_t> bits) noexcept {
+  words = std::move(bits);
+  values = std::vector<std::uint16_t>();
+  kind = Kind::kBitmap;
+  cardinality = 0;
+  for (std::uint64_t word : words) {
+    cardinality += PopCount(word);
+  }
+}
+
+inline void RoaringContainer::SetArray(
+    std::vector<std::uint16_t> array) noexcept {
+  values = std::move(array);
+  words = std::vector<std::uint64_t>();
+  kind = Kind::kArray;
+  cardinality = static_cast<std::uint32_t>(values.size());
+}
+
+inline void RoaringContainer::SetRuns(
+    std::vector<std::uint16_t> runs) noexcept {
+  values = std::move(runs);
+  words = std::vector<std::uint64_t>();
+  kind = Kind::kRun;
+  cardinality = 0;
+  for (std::size_t i = 0; i < values.size(); i += 2) {
+    cardinality += values[i + 1] - values[i] + 1;
+  }
+}
+
+// Keeps arrays at kArrayMax values or fewer and bitmaps above that, and
+// leaves run form once it stops being smaller than both.
+inline void RoaringContainer::Normalize() {
+  if (kind == Kind::kArray && cardinality > kArrayMax) {
+    SetWords(MakeWords());
+  } else if (kind == Kind::kBitmap && cardinality <= kArrayMax) {
+    SetArray(MakeArray());
+  } else if (kind == Kind::kRun &&
+             values.size() * sizeof(std::uint16_t) >
+                 std::min<std::size_t>(cardinality * sizeof(std::uint16_t),
+                                       kWords * sizeof(std::uint64_t))) {
+    if (cardinality <= kArrayMax) {
+      SetArray(MakeArray());
+    } else {
+      SetWords(MakeWords());
+    }
+  }
+}
+
+}  // namespace RBtreeMapSet
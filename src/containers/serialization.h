@@ -0,0 +1,160 @@
+#ifndef CONTAINERS_SERIALIZATION_H_
+#define CONTAINERS_SERIALIZATION_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace RBtreeMapSet {
+
+// Writes and reads a single element in the binary format used by save() and
+// load(). Trivially copyable types are stored as their raw bytes, strings as
+// a length followed by the characters and pairs member by member. Values are
+// stored in host byte order. kMinSize is the fewest bytes a record can take,
+// which bounds how many records a stream of a given length can hold.
+template <typename T, typename = void>
+struct Serializer;
+
+template <typename T>
+struct Serializer<T, std::enable_if_t<std::is_trivially_copyable_v<T>>> {
+  static constexpr std::uint64_t kFixedSize = sizeof(T);
+  static constexpr std::uint64_t kMinSize = sizeof(T);
+
+  static void Write(std::ostream &os, const T &value) {
+    os.write(reinterpret_cast<const char *>(&value), sizeof(T));
+  }
+
+  static T Read(std::istream &is) {
+    T value{};
+    is.read(reinterpret_cast<char *>(&value), sizeof(T));
+    return value;
+  }
+};
+
+template <typename CharT, typename Traits, typename Alloc>
+struct Serializer<std::basic_string<CharT, Traits, Alloc>> {
+  using string_type = std::basic_string<CharT, Traits, Alloc>;
+
+  static constexpr std::uint64_t kFixedSize = 0;
+  static constexpr std::uint64_t kMinSize = sizeof(std::uint64_t);
+  // Characters read at a time, so that a corrupt length fails at the end of
+  // the stream instead of allocating the whole string up front.
+  static constexpr std::uint64_t kChunk = 1 << 16;
+
+  static void Write(std::ostream &os, const string_type &value) {
+    Serializer<std::uint64_t>::Write(os, value.size());
+    os.write(reinterpret_cast<const char *>(value.data()),
+             value.size() * sizeof(CharT));
+  }
+
+  static string_type Read(std::istream &is) {
+    std::uint64_t length = Serializer<std::uint64_t>::Read(is);
+    if (!is) {
+      return string_type{};
+    }
+
+    string_type value;
+    while (value.size() < length && is) {
+      std::uint64_t done = value.size();
+      std::uint64_t chunk = std::min(length - done, kChunk);
+      value.resize(done + chunk);
+      is.read(reinterpret_cast<char *>(&value[done]), chunk * sizeof(CharT));
+    }
+    return value;
+  }
+};
+
+template <typename First, typename Second>
+struct Serializer<std::pair<First, Second>,
+                  std::enable_if_t<!std::is_trivially_copyable_v<
+                      std::pair<First, Second>>>> {
+  using first_type = Serializer<std::remove_const_t<First>>;
+  using second_type = Serializer<std::remove_const_t<Second>>;
+
+  static constexpr std::uint64_t kFixedSize =
+      first_type::kFixedSize && second_type::kFixedSize
+          ? first_type::kFixedSize + second_type::kFixedSize
+          : 0;
+  static constexpr std::uint64_t kMinSize =
+      first_type::kMinSize + second_type::kMinSize;
+
+  static void Write(std::ostream &os, const std::pair<First, Second> &value) {
+    first_type::Write(os, value.first);
+    second_type::Write(os, value.second);
+  }
+
+  static std::pair<First, Second> Read(std::istream &is) {
+    return std::pair<First, Second>{first_type::Read(is),
+                                    second_type::Read(is)};
+  }
+};
+
+// Stream header: magic, format version, size of one record (0 when records
+// have variable length) and the number of records that follow.
+struct SerializationHeader {
+  static constexpr std::uint32_t kMagic = 0x53544252;  // "RBTS"
+  static constexpr std::uint32_t kVersion = 1;
+
+  template <typename Value>
+  static void Write(std::ostream &os, std::uint64_t count) {
+    Serializer<std::uint32_t>::Write(os, kMagic);
+    Serializer<std::uint32_t>::Write(os, kVersion);
+    Serializer<std::uint64_t>::Write(os, Serializer<Value>::kFixedSize);
+    Serializer<std::uint64_t>::Write(os, count);
+    CheckStream(os);
+  }
+
+  template <typename Value>
+  static std::uint64_t Read(std::istream &is) {
+    std::uint32_t magic = Serializer<std::uint32_t>::Read(is);
+    std::uint32_t version = Serializer<std::uint32_t>::Read(is);
+    std::uint64_t record_size = Serializer<std::uint64_t>::Read(is);
+    std::uint64_t count = Serializer<std::uint64_t>::Read(is);
+    CheckStream(is);
+
+    if (magic != kMagic || version != kVersion ||
+        record_size != Serializer<Value>::kFixedSize ||
+        count > RemainingBytes(is) / Serializer<Value>::kMinSize) {
+      throw std::runtime_error("Stream does not hold a serialized container");
+    }
+
+    return count;
+  }
+
+  // Bytes left in a seekable stream, or the largest count for other streams,
+  // whose records are then only checked as they are read.
+  static std::uint64_t RemainingBytes(std::istream &is) {
+    std::istream::pos_type current = is.tellg();
+    if (current == std::istream::pos_type(-1)) {
+      is.clear();
+      return std::numeric_limits<std::uint64_t>::max();
+    }
+
+    is.seekg(0, std::ios::end);
+    std::istream::pos_type last = is.tellg();
+    is.seekg(current);
+    if (!is || last == std::istream::pos_type(-1)) {
+      is.clear();
+      is.seekg(current);
+      return std::numeric_limits<std::uint64_t>::max();
+    }
+
+    return static_cast<std::uint64_t>(last - current);
+  }
+
+  static void CheckStream(const std::ios &stream) {
+    if (!stream) {
+      throw std::runtime_error("Container serialization stream failed");
+    }
+  }
+};
+
+}  // namespace RBtreeMapSet
+
+#endif  // CONTAINERS_SERIALIZATION_H_
@@ -2,123 +2,303 @@
 
 namespace RBtreeMapSet {
 
-template <typename Key>
-set<Key>::set() : tree(new tree_type{}) {}
+template <typename Key, typename Compare, typename Lookup>
+set<Key, Compare, Lookup>::set() : tree(new tree_type{}) {}
 
-template <typename Key>
-set<Key>::set(std::initializer_list<value_type> const &items) : set() {
+template <typename Key, typename Compare, typename Lookup>
+set<Key, Compare, Lookup>::set(const key_compare &comp)
+    : tree(new tree_type(comp)) {}
+
+template <typename Key, typename Compare, typename Lookup>
+set<Key, Compare, Lookup>::set(std::initializer_list<value_type> const &items)
+    : set() {
   for (auto i : items) {
     insert(i);
   }
 }
 
-template <typename Key>
-set<Key>::set(const set &other) : tree(new tree_type(*other.tree)) {}
+template <typename Key, typename Compare, typename Lookup>
+set<Key, Compare, Lookup>::set(const set &other)
+    : tree(new tree_type(*other.tree)) {}
 
-template <typename Key>
-set<Key>::set(set &&other) noexcept
+template <typename Key, typename Compare, typename Lookup>
+set<Key, Compare, Lookup>::set(set &&other) noexcept
     : tree(new tree_type(std::move(*other.tree))) {}
 
-template <typename Key>
-set<Key>::~set() {
+template <typename Key, typename Compare, typename Lookup>
+set<Key, Compare, Lookup>::~set() {
   delete tree;
   tree = nullptr;
 }
 
-template <typename Key>
-set<Key> &set<Key>::operator=(const set &other) {
+template <typename Key, typename Compare, typename Lookup>
+set<Key, Compare, Lookup> &set<Key, Compare, Lookup>::operator=(
+    const set &other) {
   *tree = *other.tree;
   return *this;
 }
 
-template <typename Key>
-set<Key> &set<Key>::operator=(set &&other) noexcept {
+template <typename Key, typename Compare, typename Lookup>
+set<Key, Compare, Lookup> &set<Key, Compare, Lookup>::operator=(
+    set &&other) noexcept {
   *tree = std::move(*other.tree);
   return *this;
 }
 
-template <typename Key>
-typename set<Key>::iterator set<Key>::begin() noexcept {
+template <typename Key, typename Compare, typename Lookup>
+typename set<Key, Compare, Lookup>::iterator
+set<Key, Compare, Lookup>::begin() noexcept {
   return tree->Begin();
 }
 
-template <typename Key>
-typename set<Key>::const_iterator set<Key>::begin() const noexcept {
+template <typename Key, typename Compare, typename Lookup>
+typename set<Key, Compare, Lookup>::const_iterator
+set<Key, Compare, Lookup>::begin() const noexcept {
   return tree->Begin();
 }
 
-template <typename Key>
-typename set<Key>::iterator set<Key>::end() noexcept {
+template <typename Key, typename Compare, typename Lookup>
+typename set<Key, Compare, Lookup>::iterator
+set<Key, Compare, Lookup>::end() noexcept {
   return tree->End();
 }
 
-template <typename Key>
-typename set<Key>::const_iterator set<Key>::end() const noexcept {
+template <typename Key, typename Compare, typename Lookup>
+typename set<Key, Compare, Lookup>::const_iterator
+set<Key, Compare, Lookup>::end() const noexcept {
   return tree->End();
 }
 
-template <typename Key>
-bool set<Key>::empty() const noexcept {
+template <typename Key, typename Compare, typename Lookup>
+bool set<Key, Compare, Lookup>::empty() const noexcept {
   return tree->isEmpty();
 }
 
-template <typename Key>
-typename set<Key>::size_type set<Key>::size() const noexcept {
+template <typename Key, typename Compare, typename Lookup>
+typename set<Key, Compare, Lookup>::size_type
+set<Key, Compare, Lookup>::size() const noexcept {
   return tree->GetSize();
 }
 
-template <typename Key>
-typename set<Key>::size_type set<Key>::max_size() const noexcept {
+template <typename Key, typename Compare, typename Lookup>
+typename set<Key, Compare, Lookup>::size_type
+set<Key, Compare, Lookup>::max_size() const noexcept {
   return tree->GetMaxSize();
 }
 
-template <typename Key>
-void set<Key>::clear() noexcept {
+template <typename Key, typename Compare, typename Lookup>
+typename set<Key, Compare, Lookup>::const_reference
+set<Key, Compare, Lookup>::front() const {
+  if (empty()) {
+    throw std::out_of_range("front() called on an empty set");
+  }
+
+  return *begin();
+}
+
+template <typename Key, typename Compare, typename Lookup>
+typename set<Key, Compare, Lookup>::const_reference
+set<Key, Compare, Lookup>::back() const {
+  if (empty()) {
+    throw std::out_of_range("back() called on an empty set");
+  }
+
+  return *--end();
+}
+
+template <typename Key, typename Compare, typename Lookup>
+void set<Key, Compare, Lookup>::pop_front() {
+  if (empty()) {
+    throw std::out_of_range("pop_front() called on an empty set");
+  }
+
+  tree->Erase(tree->Begin());
+}
+
+template <typename Key, typename Compare, typename Lookup>
+void set<Key, Compare, Lookup>::pop_back() {
+  if (empty()) {
+    throw std::out_of_range("pop_back() called on an empty set");
+  }
+
+  tree->Erase(--tree->End());
+}
+
+template <typename Key, typename Compare, typename Lookup>
+typename set<Key, Compare, Lookup>::value_type
+set<Key, Compare, Lookup>::extract_min() {
+  if (empty()) {
+    throw std::out_of_range("extract_min() called on an empty set");
+  }
+
+  return tree->ExtractKey(tree->Begin());
+}
+
+template <typename Key, typename Compare, typename Lookup>
+typename set<Key, Compare, Lookup>::value_type
+set<Key, Compare, Lookup>::extract_max() {
+  if (empty()) {
+    throw std::out_of_range("extract_max() called on an empty set");
+  }
+
+  return tree->ExtractKey(--tree->End());
+}
+
+template <typename Key, typename Compare, typename Lookup>
+void set<Key, Compare, Lookup>::clear() noexcept {
   tree->RemoveTree();
 }
 
-template <typename Key>
-std::pair<typename set<Key>::iterator, bool> set<Key>::insert(
-    const value_type &value) {
+template <typename Key, typename Compare, typename Lookup>
+std::pair<typename set<Key, Compare, Lookup>::iterator, bool>
+set<Key, Compare, Lookup>::insert(const value_type &value) {
   return tree->Insert(value);
 }
 
-template <typename Key>
+template <typename Key, typename Compare, typename Lookup>
+typename set<Key, Compare, Lookup>::iterator set<Key, Compare, Lookup>::insert(
+    const_iterator hint, const value_type &value) {
+  return tree->Insert(value, hint).first;
+}
+
+template <typename Key, typename Compare, typename Lookup>
 template <typename... Args>
-std::vector<std::pair<typename set<Key>::iterator, bool>> set<Key>::insert_many(
-    Args &&...args) {
+std::vector<std::pair<typename set<Key, Compare, Lookup>::iterator, bool>>
+set<Key, Compare, Lookup>::insert_many(Args &&...args) {
   return tree->Insert_many((args)...);
 }
 
-template <typename Key>
-void set<Key>::erase(iterator pos) {
+template <typename Key, typename Compare, typename Lookup>
+void set<Key, Compare, Lookup>::erase(iterator pos) {
   tree->Erase(pos);
 }
 
-template <typename Key>
-void set<Key>::swap(set &other) noexcept {
+template <typename Key, typename Compare, typename Lookup>
+void set<Key, Compare, Lookup>::swap(set &other) noexcept {
   tree->SwapTree(*other.tree);
 }
 
-template <typename Key>
-void set<Key>::merge(set &other) {
+template <typename Key, typename Compare, typename Lookup>
+void set<Key, Compare, Lookup>::merge(set &other) {
   tree->Merge(*other.tree);
 }
 
-template <typename Key>
-typename set<Key>::iterator set<Key>::find(const key_type &key) const {
+template <typename Key, typename Compare, typename Lookup>
+template <typename ForwardIt>
+std::vector<bool> set<Key, Compare, Lookup>::apply_batch(ForwardIt first,
+                                                         ForwardIt last) {
+  return tree->ApplyBatch(first, last);
+}
+
+template <typename Key, typename Compare, typename Lookup>
+void set<Key, Compare, Lookup>::compact(NodeLayout layout) {
+  tree->Compact(layout);
+}
+
+template <typename Key, typename Compare, typename Lookup>
+typename set<Key, Compare, Lookup>::iterator set<Key, Compare, Lookup>::find(
+    const key_type &key) const {
   return tree->Find(key);
 }
 
-template <typename Key>
-bool set<Key>::contains(const key_type &key) const {
+template <typename Key, typename Compare, typename Lookup>
+typename set<Key, Compare, Lookup>::iterator set<Key, Compare, Lookup>::find(
+    const key_type &key, const_iterator hint) const {
+  return tree->Find(key, hint);
+}
+
+template <typename Key, typename Compare, typename Lookup>
+typename set<Key, Compare, Lookup>::iterator
+set<Key, Compare, Lookup>::lower_bound(const key_type &key) const {
+  return tree->LowerBound(key);
+}
+
+template <typename Key, typename Compare, typename Lookup>
+typename set<Key, Compare, Lookup>::iterator
+set<Key, Compare, Lookup>::lower_bound(const key_type &key,
+                                       const_iterator hint) const {
+  return tree->LowerBound(key, hint);
+}
+
+template <typename Key, typename Compare, typename Lookup>
+bool set<Key, Compare, Lookup>::contains(const key_type &key) const {
   iterator it = tree->Find(key);
 
   return it != end();
 }
 
-template <typename Key>
-bool set<Key>::operator==(const set &other) const {
+template <typename Key, typename Compare, typename Lookup>
+typename set<Key, Compare, Lookup>::key_compare
+set<Key, Compare, Lookup>::key_comp() const {
+  return tree->GetComparator();
+}
+
+template <typename Key, typename Compare, typename Lookup>
+std::vector<typename set<Key, Compare, Lookup>::iterator>
+set<Key, Compare, Lookup>::split(size_type parts) {
+  return tree->Split(parts);
+}
+
+template <typename Key, typename Compare, typename Lookup>
+std::vector<typename set<Key, Compare, Lookup>::const_iterator>
+set<Key, Compare, Lookup>::split(size_type parts) const {
+  std::vector<iterator> res = tree->Split(parts);
+  return std::vector<const_iterator>(res.begin(), res.end());
+}
+
+template <typename Key, typename Compare, typename Lookup>
+std::vector<typename set<Key, Compare, Lookup>::iterator>
+set<Key, Compare, Lookup>::split(size_type parts, const key_type &lo,
+                                 const key_type &hi) {
+  return tree->Split(parts, lo, hi);
+}
+
+template <typename Key, typename Compare, typename Lookup>
+std::vector<typename set<Key, Compare, Lookup>::const_iterator>
+set<Key, Compare, Lookup>::split(size_type parts, const key_type &lo,
+                                 const key_type &hi) const {
+  std::vector<iterator> res = tree->Split(parts, lo, hi);
+  return std::vector<const_iterator>(res.begin(), res.end());
+}
+
+template <typename Key, typename Compare, typename Lookup>
+void set<Key, Compare, Lookup>::set_finger_mode(bool enabled) noexcept {
+  tree->SetFingerMode(enabled);
+}
+
+template <typename Key, typename Compare, typename Lookup>
+typename set<Key, Compare, Lookup>::size_type
+set<Key, Compare, Lookup>::index_memory_usage() const noexcept {
+  return tree->GetIndexMemoryUsage();
+}
+
+template <typename Key, typename Compare, typename Lookup>
+void set<Key, Compare, Lookup>::save(std::ostream &os) const {
+  SerializationHeader::Write<value_type>(os, size());
+
+  for (const_iterator it = begin(); it != end(); ++it) {
+    Serializer<value_type>::Write(os, *it);
+  }
+
+  SerializationHeader::CheckStream(os);
+}
+
+template <typename Key, typename Compare, typename Lookup>
+void set<Key, Compare, Lookup>::load(std::istream &is) {
+  std::uint64_t count = SerializationHeader::Read<value_type>(is);
+  tree_type loaded(tree->GetComparator());
+
+  loaded.BuildFromSorted(count, [&is]() {
+    value_type value = Serializer<value_type>::Read(is);
+    SerializationHeader::CheckStream(is);
+    return value;
+  });
+
+  tree->SwapTree(loaded);
+}
+
+template <typename Key, typename Compare, typename Lookup>
+bool set<Key, Compare, Lookup>::operator==(const set &other) const {
   if (this == &other) return true;
 
   if (size() != other.size()) return false;
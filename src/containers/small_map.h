@@ -0,0 +1,76 @@
+#ifndef CONTAINERS_SMALL_MAP_H_
+#define CONTAINERS_SMALL_MAP_H_
+
+#include <stdexcept>
+
+#include "red_black_tree/map_compare.h"
+#include "small_tree/small_tree.h"
+
+namespace RBtreeMapSet {
+
+// map that keeps up to N elements inline and switches to a red-black tree
+// when it grows past N, see SmallTree. The template parameters follow map,
+// with N in place of Lookup: small_map<Key, T, std::less<Key>, 4>.
+template <typename Key, typename T, typename Compare = std::less<Key>,
+          std::size_t N = 8>
+class small_map {
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<const key_type, mapped_type>;
+  using reference = value_type &;
+  using const_reference = const value_type &;
+  using key_compare = Compare;
+  using MapCompare = MapKeyCompare<key_type, mapped_type, key_compare>;
+
+  using tree_type = SmallTree<value_type, MapCompare, N>;
+  using iterator = typename tree_type::iterator;
+  using const_iterator = typename tree_type::const_iterator;
+  using size_type = std::size_t;
+
+  small_map();
+  explicit small_map(const key_compare &comp);
+  small_map(std::initializer_list<value_type> const &items);
+
+  mapped_type &at(const key_type &key);
+  const mapped_type &at(const key_type &key) const;
+  mapped_type &operator[](const key_type &key);
+
+  iterator begin() noexcept;
+  const_iterator begin() const noexcept;
+  iterator end() noexcept;
+  const_iterator end() const noexcept;
+
+  bool empty() const noexcept;
+  size_type size() const noexcept;
+  size_type max_size() const noexcept;
+  bool is_inline() const noexcept;
+
+  void clear() noexcept;
+  std::pair<iterator, bool> insert(const value_type &value);
+  std::pair<iterator, bool> insert(const key_type &key, const mapped_type &obj);
+  std::pair<iterator, bool> insert_or_assign(const key_type &key,
+                                             const mapped_type &obj);
+  template <typename... Args>
+  std::vector<std::pair<iterator, bool>> insert_many(Args &&...args);
+  void erase(iterator pos);
+  void swap(small_map &other) noexcept(
+      std::is_nothrow_move_constructible_v<value_type>);
+  void merge(small_map &other);
+
+  iterator find(const key_type &key);
+  const_iterator find(const key_type &key) const;
+  bool contains(const key_type &key) const;
+
+  key_compare key_comp() const;
+
+  bool operator==(const small_map &other) const;
+
+ private:
+  tree_type tree;
+};
+
+}  // namespace RBtreeMapSet
+
+#include "small_map.tpp"
+#endif  // CONTAINERS_SMALL_MAP_H_
@@ -0,0 +1,195 @@
+#include "small_map.h"
+
+namespace RBtreeMapSet {
+
+template <typename Key, typename T, typename Compare, std::size_t N>
+small_map<Key, T, Compare, N>::small_map() : tree(MapCompare{}) {}
+
+template <typename Key, typename T, typename Compare, std::size_t N>
+small_map<Key, T, Compare, N>::small_map(const key_compare &comp)
+    : tree(MapCompare{comp}) {}
+
+template <typename Key, typename T, typename Compare, std::size_t N>
+small_map<Key, T, Compare, N>::small_map(
+    std::initializer_list<value_type> const &items)
+    : small_map() {
+  for (auto i : items) {
+    insert(i);
+  }
+}
+
+template <typename Key, typename T, typename Compare, std::size_t N>
+typename small_map<Key, T, Compare, N>::mapped_type &
+small_map<Key, T, Compare, N>::at(const key_type &key) {
+  iterator it = find(key);
+
+  if (it == end()) {
+    throw std::out_of_range("Element with the specified key not found");
+  }
+
+  return (*it).second;
+}
+
+template <typename Key, typename T, typename Compare, std::size_t N>
+const typename small_map<Key, T, Compare, N>::mapped_type &
+small_map<Key, T, Compare, N>::at(const key_type &key) const {
+  return const_cast<small_map<Key, T, Compare, N> *>(this)->at(key);
+}
+
+template <typename Key, typename T, typename Compare, std::size_t N>
+typename small_map<Key, T, Compare, N>::mapped_type &
+small_map<Key, T, Compare, N>::operator[](const key_type &key) {
+  iterator it = find(key);
+
+  if (it == end()) {
+    it = insert({key, mapped_type{}}).first;
+  }
+
+  return (*it).second;
+}
+
+template <typename Key, typename T, typename Compare, std::size_t N>
+typename small_map<Key, T, Compare, N>::iterator
+small_map<Key, T, Compare, N>::begin() noexcept {
+  return tree.Begin();
+}
+
+template <typename Key, typename T, typename Compare, std::size_t N>
+typename small_map<Key, T, Compare, N>::const_iterator
+small_map<Key, T, Compare, N>::begin() const noexcept {
+  return tree.Begin();
+}
+
+template <typename Key, typename T, typename Compare, std::size_t N>
+typename small_map<Key, T, Compare, N>::iterator
+small_map<Key, T, Compare, N>::end() noexcept {
+  return tree.End();
+}
+
+template <typename Key, typename T, typename Compare, std::size_t N>
+typename small_map<Key, T, Compare, N>::const_iterator
+small_map<Key, T, Compare, N>::end() const noexcept {
+  return tree.End();
+}
+
+template <typename Key, typename T, typename Compare, std::size_t N>
+bool small_map<Key, T, Compare, N>::empty() const noexcept {
+  return tree.isEmpty();
+}
+
+template <typename Key, typename T, typename Compare, std::size_t N>
+typename small_map<Key, T, Compare, N>::size_type
+small_map<Key, T, Compare, N>::size() const noexcept {
+  return tree.GetSize();
+}
+
+template <typename Key, typename T, typename Compare, std::size_t N>
+typename small_map<Key, T, Compare, N>::size_type
+small_map<Key, T, Compare, N>::max_size() const noexcept {
+  return tree.GetMaxSize();
+}
+
+template <typename Key, typename T, typename Compare, std::size_t N>
+bool small_map<Key, T, Compare, N>::is_inline() const noexcept {
+  return tree.IsInline();
+}
+
+template <typename Key, typename T, typename Compare, std::size_t N>
+void small_map<Key, T, Compare, N>::clear() noexcept {
+  tree.RemoveTree();
+}
+
+template <typename Key, typename T, typename Compare, std::size_t N>
+std::pair<typename small_map<Key, T, Compare, N>::iterator, bool>
+small_map<Key, T, Compare, N>::insert(const value_type &value) {
+  return tree.Insert(value);
+}
+
+template <typename Key, typename T, typename Compare, std::size_t N>
+std::pair<typename small_map<Key, T, Compare, N>::iterator, bool>
+small_map<Key, T, Compare, N>::insert(const key_type &key,
+                                      const mapped_type &obj) {
+  return tree.Insert(value_type{key, obj});
+}
+
+template <typename Key, typename T, typename Compare, std::size_t N>
+std::pair<typename small_map<Key, T, Compare, N>::iterator, bool>
+small_map<Key, T, Compare, N>::insert_or_assign(const key_type &key,
+                                                const mapped_type &obj) {
+  iterator it = find(key);
+
+  if (it == end()) {
+    return tree.Insert(value_type{key, obj});
+  }
+
+  (*it).second = obj;
+
+  return {it, false};
+}
+
+template <typename Key, typename T, typename Compare, std::size_t N>
+template <typename... Args>
+std::vector<std::pair<typename small_map<Key, T, Compare, N>::iterator, bool>>
+small_map<Key, T, Compare, N>::insert_many(Args &&...args) {
+  return tree.Insert_many((args)...);
+}
+
+template <typename Key, typename T, typename Compare, std::size_t N>
+void small_map<Key, T, Compare, N>::erase(iterator pos) {
+  tree.Erase(pos);
+}
+
+template <typename Key, typename T, typename Compare, std::size_t N>
+void small_map<Key, T, Compare, N>::swap(small_map &other) noexcept(
+    std::is_nothrow_move_constructible_v<value_type>) {
+  tree.SwapTree(other.tree);
+}
+
+template <typename Key, typename T, typename Compare, std::size_t N>
+void small_map<Key, T, Compare, N>::merge(small_map &other) {
+  tree.Merge(other.tree);
+}
+
+template <typename Key, typename T, typename Compare, std::size_t N>
+typename small_map<Key, T, Compare, N>::iterator
+small_map<Key, T, Compare, N>::find(const key_type &key) {
+  return tree.Find({key, mapped_type{}});
+}
+
+template <typename Key, typename T, typename Compare, std::size_t N>
+typename small_map<Key, T, Compare, N>::const_iterator
+small_map<Key, T, Compare, N>::find(const key_type &key) const {
+  return const_iterator(const_cast<small_map *>(this)->find(key));
+}
+
+template <typename Key, typename T, typename Compare, std::size_t N>
+bool small_map<Key, T, Compare, N>::contains(const key_type &key) const {
+  return find(key) != end();
+}
+
+template <typename Key, typename T, typename Compare, std::size_t N>
+typename small_map<Key, T, Compare, N>::key_compare
+small_map<Key, T, Compare, N>::key_comp() const {
+  return tree.GetComparator().comp;
+}
+
+template <typename Key, typename T, typename Compare, std::size_t N>
+bool small_map<Key, T, Compare, N>::operator==(const small_map &other) const {
+  if (this == &other) return true;
+
+  if (size() != other.size()) return false;
+
+  auto it_1 = begin();
+  auto it_2 = other.begin();
+
+  while (it_1 != end()) {
+    if (*it_1 != *it_2) return false;
+
+    ++it_1;
+    ++it_2;
+  }
+
+  return true;
+}
+
+}  // namespace RBtreeMapSet
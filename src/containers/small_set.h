@@ -0,0 +1,62 @@
+#ifndef CONTAINERS_SMALL_SET_H_
+#define CONTAINERS_SMALL_SET_H_
+
+#include "small_tree/small_tree.h"
+
+namespace RBtreeMapSet {
+
+// set that keeps up to N elements inline and switches to a red-black tree
+// when it grows past N, see SmallTree. The template parameters follow set,
+// with N in place of Lookup: small_set<Key, std::less<Key>, 4>.
+template <typename Key, typename Compare = std::less<Key>, std::size_t N = 8>
+class small_set {
+ public:
+  using key_type = Key;
+  using value_type = Key;
+  using reference = value_type &;
+  using const_reference = const value_type &;
+  using key_compare = Compare;
+
+  using tree_type = SmallTree<value_type, key_compare, N>;
+  using iterator = typename tree_type::iterator;
+  using const_iterator = typename tree_type::const_iterator;
+  using size_type = std::size_t;
+
+  small_set();
+  explicit small_set(const key_compare &comp);
+  small_set(std::initializer_list<value_type> const &items);
+
+  iterator begin() noexcept;
+  const_iterator begin() const noexcept;
+  iterator end() noexcept;
+  const_iterator end() const noexcept;
+
+  bool empty() const noexcept;
+  size_type size() const noexcept;
+  size_type max_size() const noexcept;
+  bool is_inline() const noexcept;
+
+  void clear() noexcept;
+  std::pair<iterator, bool> insert(const value_type &value);
+  template <typename... Args>
+  std::vector<std::pair<iterator, bool>> insert_many(Args &&...args);
+  void erase(iterator pos);
+  void swap(small_set &other) noexcept(
+      std::is_nothrow_move_constructible_v<value_type>);
+  void merge(small_set &other);
+
+  iterator find(const key_type &key) const;
+  bool contains(const key_type &key) const;
+
+  key_compare key_comp() const;
+
+  bool operator==(const small_set &other) const;
+
+ private:
+  mutable tree_type tree;
+};
+
+}  // namespace RBtreeMapSet
+
+#include "small_set.tpp"
+#endif  // CONTAINERS_SMALL_SET_H_
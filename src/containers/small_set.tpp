@@ -0,0 +1,136 @@
+#include "small_set.h"
+
+namespace RBtreeMapSet {
+
+template <typename Key, typename Compare, std::size_t N>
+small_set<Key, Compare, N>::small_set() : tree() {}
+
+template <typename Key, typename Compare, std::size_t N>
+small_set<Key, Compare, N>::small_set(const key_compare &comp) : tree(comp) {}
+
+template <typename Key, typename Compare, std::size_t N>
+small_set<Key, Compare, N>::small_set(
+    std::initializer_list<value_type> const &items)
+    : small_set() {
+  for (auto i : items) {
+    insert(i);
+  }
+}
+
+template <typename Key, typename Compare, std::size_t N>
+typename small_set<Key, Compare, N>::iterator
+small_set<Key, Compare, N>::begin() noexcept {
+  return tree.Begin();
+}
+
+template <typename Key, typename Compare, std::size_t N>
+typename small_set<Key, Compare, N>::const_iterator
+small_set<Key, Compare, N>::begin() const noexcept {
+  return static_cast<const tree_type &>(tree).Begin();
+}
+
+template <typename Key, typename Compare, std::size_t N>
+typename small_set<Key, Compare, N>::iterator
+small_set<Key, Compare, N>::end() noexcept {
+  return tree.End();
+}
+
+template <typename Key, typename Compare, std::size_t N>
+typename small_set<Key, Compare, N>::const_iterator
+small_set<Key, Compare, N>::end() const noexcept {
+  return static_cast<const tree_type &>(tree).End();
+}
+
+template <typename Key, typename Compare, std::size_t N>
+bool small_set<Key, Compare, N>::empty() const noexcept {
+  return tree.isEmpty();
+}
+
+template <typename Key, typename Compare, std::size_t N>
+typename small_set<Key, Compare, N>::size_type
+small_set<Key, Compare, N>::size() const noexcept {
+  return tree.GetSize();
+}
+
+template <typename Key, typename Compare, std::size_t N>
+typename small_set<Key, Compare, N>::size_type
+small_set<Key, Compare, N>::max_size() const noexcept {
+  return tree.GetMaxSize();
+}
+
+template <typename Key, typename Compare, std::size_t N>
+bool small_set<Key, Compare, N>::is_inline() const noexcept {
+  return tree.IsInline();
+}
+
+template <typename Key, typename Compare, std::size_t N>
+void small_set<Key, Compare, N>::clear() noexcept {
+  tree.RemoveTree();
+}
+
+template <typename Key, typename Compare, std::size_t N>
+std::pair<typename small_set<Key, Compare, N>::iterator, bool>
+small_set<Key, Compare, N>::insert(const value_type &value) {
+  return tree.Insert(value);
+}
+
+template <typename Key, typename Compare, std::size_t N>
+template <typename... Args>
+std::vector<std::pair<typename small_set<Key, Compare, N>::iterator, bool>>
+small_set<Key, Compare, N>::insert_many(Args &&...args) {
+  return tree.Insert_many((args)...);
+}
+
+template <typename Key, typename Compare, std::size_t N>
+void small_set<Key, Compare, N>::erase(iterator pos) {
+  tree.Erase(pos);
+}
+
+template <typename Key, typename Compare, std::size_t N>
+void small_set<Key, Compare, N>::swap(small_set &other) noexcept(
+    std::is_nothrow_move_constructible_v<value_type>) {
+  tree.SwapTree(other.tree);
+}
+
+template <typename Key, typename Compare, std::size_t N>
+void small_set<Key, Compare, N>::merge(small_set &other) {
+  tree.Merge(other.tree);
+}
+
+template <typename Key, typename Compare, std::size_t N>
+typename small_set<Key, Compare, N>::iterator small_set<Key, Compare, N>::find(
+    const key_type &key) const {
+  return tree.Find(key);
+}
+
+template <typename Key, typename Compare, std::size_t N>
+bool small_set<Key, Compare, N>::contains(const key_type &key) const {
+  return find(key) != end();
+}
+
+template <typename Key, typename Compare, std::size_t N>
+typename small_set<Key, Compare, N>::key_compare
+small_set<Key, Compare, N>::key_comp() const {
+  return tree.GetComparator();
+}
+
+template <typename Key, typename Compare, std::size_t N>
+bool small_set<Key, Compare, N>::operator==(const small_set &other) const {
+  if (this == &other) return true;
+
+  if (size() != other.size()) return false;
+
+  auto it_1 = begin();
+  auto it_2 = other.begin();
+
+  while (it_1 != end()) {
+    if (*it_1 != *it_2) return false;
+
+    ++it_1;
+    ++it_2;
+  }
+
+  return true;
+}
+
+}  // namespace RBtreeMapSet
@@ -0,0 +1,214 @@
+#ifndef CONTAINERS_SMALL_TREE_SMALL_TREE_H_
+#define CONTAINERS_SMALL_TREE_SMALL_TREE_H_
+
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+#include "../red_black_tree/red_black_tree.h"
+
+namespace RBtreeMapSet {
+
+// Ordered storage with the RedBlackTree interface that keeps up to N keys
+// inline and only moves them into a heap-allocated RedBlackTree once the
+// (N + 1)-th key arrives. Inline keys never move: a small rank table keeps
+// them in order, so iterators stay valid across inserts and erases of other
+// keys. Spilling into the tree invalidates all iterators; clear() returns to
+// inline storage.
+template <typename Key, typename Compare = std::less<Key>, std::size_t N = 8>
+class SmallTree {
+ private:
+  struct Iterator;
+  struct IteratorConst;
+
+ public:
+  using key_type = Key;
+  using reference = key_type &;
+  using const_reference = const key_type &;
+  using iterator = Iterator;
+  using const_iterator = IteratorConst;
+  using size_type = std::size_t;
+  using key_compare = Compare;
+  using tree_type = RedBlackTree<Key, Compare>;
+
+  static_assert(N > 0 && N < 255, "inline capacity must be in [1, 254]");
+
+  SmallTree();
+  explicit SmallTree(const key_compare &comp);
+  SmallTree(const SmallTree &other);
+  SmallTree(SmallTree &&other) noexcept(
+      std::is_nothrow_move_constructible_v<Key>);
+  SmallTree &operator=(const SmallTree &other);
+  SmallTree &operator=(SmallTree &&other) noexcept(
+      std::is_nothrow_move_constructible_v<Key>);
+  ~SmallTree();
+
+  void RemoveTree();
+
+  iterator Begin() noexcept;
+  const_iterator Begin() const noexcept;
+  iterator End() noexcept;
+  const_iterator End() const noexcept;
+
+  bool isEmpty() const noexcept;
+  size_type GetSize() const noexcept;
+  size_type GetMaxSize() const noexcept;
+  bool IsInline() const noexcept;
+
+  std::pair<iterator, bool> Insert(const key_type &key);
+  template <typename... Args>
+  std::vector<std::pair<iterator, bool>> Insert_many(Args &&...args);
+  void Erase(iterator position);
+  void SwapTree(SmallTree &other) noexcept(
+      std::is_nothrow_move_constructible_v<Key>);
+  void Merge(SmallTree &other);
+  iterator Find(const_reference key) noexcept;
+  key_compare GetComparator() const;
+
+ private:
+  static constexpr std::uint8_t kFree = 0xFF;
+  static constexpr size_type kEnd = N;
+
+  key_type *Slot(size_type slot) noexcept;
+  const key_type *Slot(size_type slot) const noexcept;
+  size_type LowerRank(const_reference key) const;
+  void Spill();
+  void DestroyInline() noexcept;
+  void MoveFrom(SmallTree &other) noexcept(
+      std::is_nothrow_move_constructible_v<Key>);
+
+  struct Iterator {
+    using iterator_category = std::bidirectional_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = typename SmallTree::key_type;
+    using pointer = value_type *;
+    using reference = value_type &;
+
+    Iterator() = delete;
+
+    Iterator(SmallTree *owner, size_type slot,
+             typename tree_type::iterator node)
+        : owner_(owner), slot_(slot), node_(node) {}
+
+    reference operator*() const noexcept {
+      return owner_->tree ? *node_ : *owner_->Slot(slot_);
+    }
+
+    pointer operator->() const noexcept { return &**this; }
+
+    iterator &operator++() noexcept {
+      if (owner_->tree) {
+        ++node_;
+      } else if (slot_ != kEnd) {
+        size_type rank = owner_->rank_of[slot_] + 1;
+        slot_ = rank < owner_->inline_size ? owner_->order[rank] : kEnd;
+      } else {
+        slot_ = owner_->inline_size ? owner_->order[0] : kEnd;
+      }
+      return *this;
+    }
+
+    iterator operator++(int) noexcept {
+      iterator tmp{*this};
+      ++(*this);
+      return tmp;
+    }
+
+    iterator &operator--() noexcept {
+      if (owner_->tree) {
+        --node_;
+      } else if (slot_ != kEnd) {
+        size_type rank = owner_->rank_of[slot_];
+        slot_ = rank ? owner_->order[rank - 1] : kEnd;
+      } else {
+        size_type size = owner_->inline_size;
+        slot_ = size ? owner_->order[size - 1] : kEnd;
+      }
+      return *this;
+    }
+
+    iterator operator--(int) noexcept {
+      iterator tmp{*this};
+      --(*this);
+      return tmp;
+    }
+
+    bool operator==(const iterator &other) const noexcept {
+      return slot_ == other.slot_ && node_ == other.node_;
+    }
+
+    bool operator!=(const iterator &other) const noexcept {
+      return !(*this == other);
+    }
+
+    SmallTree *owner_;
+    size_type slot_;
+    typename tree_type::iterator node_;
+  };
+
+  struct IteratorConst {
+    using iterator_category = std::bidirectional_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = typename SmallTree::key_type;
+    using pointer = const value_type *;
+    using reference = const value_type &;
+
+    IteratorConst() = delete;
+
+    IteratorConst(const iterator &it) : it_(it) {}
+
+    reference operator*() const noexcept { return *it_; }
+
+    pointer operator->() const noexcept { return &*it_; }
+
+    const_iterator &operator++() noexcept {
+      ++it_;
+      return *this;
+    }
+
+    const_iterator operator++(int) noexcept {
+      const_iterator tmp{*this};
+      ++it_;
+      return tmp;
+    }
+
+    const_iterator &operator--() noexcept {
+      --it_;
+      return *this;
+    }
+
+    const_iterator operator--(int) noexcept {
+      const_iterator tmp{*this};
+      --it_;
+      return tmp;
+    }
+
+    friend bool operator==(const const_iterator &it1,
+                           const const_iterator &it2) noexcept {
+      return it1.it_ == it2.it_;
+    }
+
+    friend bool operator!=(const const_iterator &it1,
+                           const const_iterator &it2) noexcept {
+      return it1.it_ != it2.it_;
+    }
+
+    iterator it_;
+  };
+
+  using compare_traits = CompareTraits<Compare, Key>;
+
+  alignas(key_type) unsigned char slots[N * sizeof(key_type)];
+  std::uint8_t order[N];
+  std::uint8_t rank_of[N];
+  size_type inline_size;
+  tree_type *tree;
+  Compare cmp;
+};
+
+}  // namespace RBtreeMapSet
+
+#include "small_tree.tpp"
+#endif  // CONTAINERS_SMALL_TREE_SMALL_TREE_H_
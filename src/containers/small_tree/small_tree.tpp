@@ -0,0 +1,355 @@
+#include <limits>
+#include <new>
+#include <utility>
+
+#include "small_tree.h"
+
+namespace RBtreeMapSet {
+
+template <typename Key, typename Compare, std::size_t N>
+SmallTree<Key, Compare, N>::SmallTree() : SmallTree(key_compare{}) {}
+
+template <typename Key, typename Compare, std::size_t N>
+SmallTree<Key, Compare, N>::SmallTree(const key_compare &comp)
+    : inline_size(0), tree(nullptr), cmp(comp) {
+  for (size_type slot = 0; slot < N; ++slot) {
+    rank_of[slot] = kFree;
+  }
+}
+
+template <typename Key, typename Compare, std::size_t N>
+SmallTree<Key, Compare, N>::SmallTree(const SmallTree &other)
+    : SmallTree(other.cmp) {
+  if (other.tree) {
+    tree = new tree_type(*other.tree);
+    return;
+  }
+
+  try {
+    for (size_type rank = 0; rank < other.inline_size; ++rank) {
+      size_type slot = other.order[rank];
+      ::new (static_cast<void *>(Slot(slot))) key_type(*other.Slot(slot));
+      order[rank] = slot;
+      rank_of[slot] = rank;
+      ++inline_size;
+    }
+  } catch (...) {
+    DestroyInline();
+    throw;
+  }
+}
+
+template <typename Key, typename Compare, std::size_t N>
+SmallTree<Key, Compare, N>::SmallTree(SmallTree &&other) noexcept(
+    std::is_nothrow_move_constructible_v<Key>)
+    : SmallTree(other.cmp) {
+  MoveFrom(other);
+}
+
+template <typename Key, typename Compare, std::size_t N>
+SmallTree<Key, Compare, N> &SmallTree<Key, Compare, N>::operator=(
+    const SmallTree &other) {
+  if (this != &other) {
+    SmallTree copy(other);
+    RemoveTree();
+    MoveFrom(copy);
+  }
+  return *this;
+}
+
+template <typename Key, typename Compare, std::size_t N>
+SmallTree<Key, Compare, N> &SmallTree<Key, Compare, N>::operator=(
+    SmallTree &&other) noexcept(std::is_nothrow_move_constructible_v<Key>) {
+  if (this != &other) {
+    RemoveTree();
+    MoveFrom(other);
+  }
+  return *this;
+}
+
+template <typename Key, typename Compare, std::size_t N>
+SmallTree<Key, Compare, N>::~SmallTree() {
+  RemoveTree();
+}
+
+template <typename Key, typename Compare, std::size_t N>
+void SmallTree<Key, Compare, N>::MoveFrom(SmallTree &other) noexcept(
+    std::is_nothrow_move_constructible_v<Key>) {
+  cmp = other.cmp;
+
+  if (other.tree) {
+    tree = other.tree;
+    other.tree = nullptr;
+    return;
+  }
+
+  for (size_type rank = 0; rank < other.inline_size; ++rank) {
+    size_type slot = other.order[rank];
+    ::new (static_cast<void *>(Slot(slot)))
+        key_type(std::move(*other.Slot(slot)));
+    order[rank] = slot;
+    rank_of[slot] = rank;
+    ++inline_size;
+  }
+
+  other.DestroyInline();
+}
+
+template <typename Key, typename Compare, std::size_t N>
+void SmallTree<Key, Compare, N>::DestroyInline() noexcept {
+  for (size_type rank = 0; rank < inline_size; ++rank) {
+    Slot(order[rank])->~key_type();
+    rank_of[order[rank]] = kFree;
+  }
+  inline_size = 0;
+}
+
+template <typename Key, typename Compare, std::size_t N>
+void SmallTree<Key, Compare, N>::RemoveTree() {
+  delete tree;
+  tree = nullptr;
+  DestroyInline();
+}
+
+template <typename Key, typename Compare, std::size_t N>
+typename SmallTree<Key, Compare, N>::key_type *SmallTree<Key, Compare, N>::Slot(
+    size_type slot) noexcept {
+  return std::launder(reinterpret_cast<key_type *>(slots) + slot);
+}
+
+template <typename Key, typename Compare, std::size_t N>
+const typename SmallTree<Key, Compare, N>::key_type *
+SmallTree<Key, Compare, N>::Slot(size_type slot) const noexcept {
+  return std::launder(reinterpret_cast<const key_type *>(slots) + slot);
+}
+
+template <typename Key, typename Compare, std::size_t N>
+typename SmallTree<Key, Compare, N>::iterator
+SmallTree<Key, Compare, N>::Begin() noexcept {
+  if (tree) {
+    return iterator(this, kEnd, tree->Begin());
+  }
+  return iterator(this, inline_size ? order[0] : kEnd,
+                  typename tree_type::iterator(nullptr));
+}
+
+template <typename Key, typename Compare, std::size_t N>
+typename SmallTree<Key, Compare, N>::const_iterator
+SmallTree<Key, Compare, N>::Begin() const noexcept {
+  return const_iterator(const_cast<SmallTree *>(this)->Begin());
+}
+
+template <typename Key, typename Compare, std::size_t N>
+typename SmallTree<Key, Compare, N>::iterator
+SmallTree<Key, Compare, N>::End() noexcept {
+  if (tree) {
+    return iterator(this, kEnd, tree->End());
+  }
+  return iterator(this, kEnd, typename tree_type::iterator(nullptr));
+}
+
+template <typename Key, typename Compare, std::size_t N>
+typename SmallTree<Key, Compare, N>::const_iterator
+SmallTree<Key, Compare, N>::End() const noexcept {
+  return const_iterator(const_cast<SmallTree *>(this)->End());
+}
+
+template <typename Key, typename Compare, std::size_t N>
+bool SmallTree<Key, Compare, N>::isEmpty() const noexcept {
+  return GetSize() == 0;
+}
+
+template <typename Key, typename Compare, std::size_t N>
+typename SmallTree<Key, Compare, N>::size_type
+SmallTree<Key, Compare, N>::GetSize() const noexcept {
+  return tree ? tree->GetSize() : inline_size;
+}
+
+template <typename Key, typename Compare, std::size_t N>
+typename SmallTree<Key, Compare, N>::size_type
+SmallTree<Key, Compare, N>::GetMaxSize() const noexcept {
+  return ((std::numeric_limits<size_type>::max() / 2) - sizeof(SmallTree)) /
+         (sizeof(key_type) + 3 * sizeof(void *));
+}
+
+template <typename Key, typename Compare, std::size_t N>
+bool SmallTree<Key, Compare, N>::IsInline() const noexcept {
+  return !tree;
+}
+
+template <typename Key, typename Compare, std::size_t N>
+typename SmallTree<Key, Compare, N>::size_type
+SmallTree<Key, Compare, N>::LowerRank(const_reference key) const {
+  size_type rank = 0;
+
+  while (rank < inline_size &&
+         compare_traits::Less(cmp, *Slot(order[rank]), key)) {
+    ++rank;
+  }
+
+  return rank;
+}
+
+template <typename Key, typename Compare, std::size_t N>
+std::pair<typename SmallTree<Key, Compare, N>::iterator, bool>
+SmallTree<Key, Compare, N>::Insert(const key_type &key) {
+  if (tree) {
+    std::pair<typename tree_type::iterator, bool> res = tree->Insert(key);
+    return {iterator(this, kEnd, res.first), res.second};
+  }
+
+  size_type rank = LowerRank(key);
+  if (rank < inline_size &&
+      !compare_traits::Less(cmp, key, *Slot(order[rank]))) {
+    return {iterator(this, order[rank], typename tree_type::iterator(nullptr)),
+            false};
+  }
+
+  if (inline_size == N) {
+    Spill();
+    return Insert(key);
+  }
+
+  size_type slot = 0;
+  while (rank_of[slot] != kFree) {
+    ++slot;
+  }
+
+  ::new (static_cast<void *>(Slot(slot))) key_type(key);
+
+  for (size_type i = inline_size; i > rank; --i) {
+    order[i] = order[i - 1];
+    rank_of[order[i]] = i;
+  }
+  order[rank] = slot;
+  rank_of[slot] = rank;
+  ++inline_size;
+
+  return {iterator(this, slot, typename tree_type::iterator(nullptr)), true};
+}
+
+template <typename Key, typename Compare, std::size_t N>
+void SmallTree<Key, Compare, N>::Spill() {
+  tree_type *spilled = new tree_type(cmp);
+  size_type rank = 0;
+
+  try {
+    spilled->BuildFromSorted(inline_size, [this, &rank]() {
+      return key_type(std::move_if_noexcept(*Slot(order[rank++])));
+    });
+  } catch (...) {
+    delete spilled;
+    throw;
+  }
+
+  DestroyInline();
+  tree = spilled;
+}
+
+template <typename Key, typename Compare, std::size_t N>
+template <typename... Args>
+std::vector<std::pair<typename SmallTree<Key, Compare, N>::iterator, bool>>
+SmallTree<Key, Compare, N>::Insert_many(Args &&...args) {
+  std::vector<std::pair<iterator, bool>> res;
+  res.reserve(sizeof...(args));
+
+  for (auto item : {args...}) {
+    res.push_back(Insert(item));
+  }
+
+  return res;
+}
+
+template <typename Key, typename Compare, std::size_t N>
+void SmallTree<Key, Compare, N>::Erase(iterator position) {
+  if (tree) {
+    tree->Erase(position.node_);
+    return;
+  }
+
+  size_type slot = position.slot_;
+  if (slot == kEnd) {
+    return;
+  }
+
+  size_type rank = rank_of[slot];
+  Slot(slot)->~key_type();
+  rank_of[slot] = kFree;
+  --inline_size;
+
+  for (size_type i = rank; i < inline_size; ++i) {
+    order[i] = order[i + 1];
+    rank_of[order[i]] = i;
+  }
+}
+
+template <typename Key, typename Compare, std::size_t N>
+void SmallTree<Key, Compare, N>::SwapTree(SmallTree &other) noexcept(
+    std::is_nothrow_move_constructible_v<Key>) {
+  if (this == &other) {
+    return;
+  }
+
+  SmallTree tmp(std::move(other));
+  other.MoveFrom(*this);
+  MoveFrom(tmp);
+}
+
+template <typename Key, typename Compare, std::size_t N>
+void SmallTree<Key, Compare, N>::Merge(SmallTree &other) {
+  if (this == &other) {
+    return;
+  }
+
+  if (tree && other.tree) {
+    tree->Merge(*other.tree);
+    return;
+  }
+
+  iterator it = other.Begin();
+  while (it != other.End()) {
+    iterator next = it;
+    ++next;
+    if (Insert(*it).second) {
+      other.Erase(it);
+    }
+    it = next;
+  }
+}
+
+template <typename Key, typename Compare, std::size_t N>
+typename SmallTree<Key, Compare, N>::iterator SmallTree<Key, Compare, N>::Find(
+    const_reference key) noexcept {
+  if (tree) {
+    return iterator(this, kEnd, tree->Find(key));
+  }
+
+  if constexpr (compare_traits::kThreeWay) {
+    for (size_type rank = 0; rank < inline_size; ++rank) {
+      int res = compare_traits::ThreeWay(cmp, key, *Slot(order[rank]));
+      if (res == 0) {
+        return iterator(this, order[rank],
+                        typename tree_type::iterator(nullptr));
+      }
+      if (res < 0) {
+        break;
+      }
+    }
+  } else {
+    size_type rank = LowerRank(key);
+    if (rank < inline_size &&
+        !compare_traits::Less(cmp, key, *Slot(order[rank]))) {
+      return iterator(this, order[rank], typename tree_type::iterator(nullptr));
+    }
+  }
+
+  return End();
+}
+
+template <typename Key, typename Compare, std::size_t N>
+typename SmallTree<Key, Compare, N>::key_compare
+SmallTree<Key, Compare, N>::GetComparator() const {
+  return cmp;
+}
+
+}  // namespace RBtreeMapSet
@@ -0,0 +1,74 @@
+#ifndef CONTAINERS_STATIC_MAP_H_
+#define CONTAINERS_STATIC_MAP_H_
+
+#include <array>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+#include "red_black_tree/compare_traits.h"
+
+namespace RBtreeMapSet {
+
+// Fixed lookup table sorted at compile time. A constexpr static_map is built
+// by the compiler and lives in read-only data: no heap, no startup work.
+// Lookups are a binary search over the sorted array. Duplicate keys, and at()
+// on a missing key, are compile errors when evaluated in a constant
+// expression and throw at run time. Compare is a "less" predicate or a
+// three-way comparator, as for map.
+template <typename Key, typename T, std::size_t N,
+          typename Compare = std::less<Key>>
+class static_map {
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<const key_type, mapped_type>;
+  using reference = value_type &;
+  using const_reference = const value_type &;
+  using key_compare = Compare;
+  using iterator = const value_type *;
+  using const_iterator = const value_type *;
+  using size_type = std::size_t;
+
+  static_assert(N > 0, "static_map needs at least one element");
+
+  constexpr explicit static_map(const value_type (&items)[N]);
+
+  constexpr const mapped_type &at(const key_type &key) const;
+
+  constexpr const_iterator begin() const noexcept;
+  constexpr const_iterator end() const noexcept;
+
+  constexpr bool empty() const noexcept;
+  constexpr size_type size() const noexcept;
+  constexpr size_type max_size() const noexcept;
+
+  constexpr const_iterator find(const key_type &key) const;
+  constexpr bool contains(const key_type &key) const;
+  constexpr const_iterator lower_bound(const key_type &key) const;
+
+ private:
+  template <std::size_t... I>
+  constexpr static_map(const value_type (&items)[N],
+                       const std::array<size_type, N> &order,
+                       std::index_sequence<I...>);
+
+  static constexpr std::array<size_type, N> SortedOrder(
+      const value_type (&items)[N]);
+
+  using compare_traits = CompareTraits<Compare, Key>;
+
+  std::array<value_type, N> data;
+};
+
+template <typename Key, typename T, typename Compare = std::less<Key>,
+          std::size_t N>
+constexpr static_map<Key, T, N, Compare> make_static_map(
+    const std::pair<const Key, T> (&items)[N]) {
+  return static_map<Key, T, N, Compare>(items);
+}
+
+}  // namespace RBtreeMapSet
+
+#include "static_map.tpp"
+#endif  // CONTAINERS_STATIC_MAP_H_
@@ -0,0 +1,64 @@
+#ifndef CONTAINERS_STATIC_SET_H_
+#define CONTAINERS_STATIC_SET_H_
+
+#include <array>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+#include "red_black_tree/compare_traits.h"
+
+namespace RBtreeMapSet {
+
+// Fixed set of keys sorted at compile time, see static_map.
+template <typename Key, std::size_t N, typename Compare = std::less<Key>>
+class static_set {
+ public:
+  using key_type = Key;
+  using value_type = Key;
+  using reference = value_type &;
+  using const_reference = const value_type &;
+  using key_compare = Compare;
+  using iterator = const value_type *;
+  using const_iterator = const value_type *;
+  using size_type = std::size_t;
+
+  static_assert(N > 0, "static_set needs at least one element");
+
+  constexpr explicit static_set(const value_type (&items)[N]);
+
+  constexpr const_iterator begin() const noexcept;
+  constexpr const_iterator end() const noexcept;
+
+  constexpr bool empty() const noexcept;
+  constexpr size_type size() const noexcept;
+  constexpr size_type max_size() const noexcept;
+
+  constexpr const_iterator find(const key_type &key) const;
+  constexpr bool contains(const key_type &key) const;
+  constexpr const_iterator lower_bound(const key_type &key) const;
+
+ private:
+  template <std::size_t... I>
+  constexpr static_set(const value_type (&items)[N],
+                       const std::array<size_type, N> &order,
+                       std::index_sequence<I...>);
+
+  static constexpr std::array<size_type, N> SortedOrder(
+      const value_type (&items)[N]);
+
+  using compare_traits = CompareTraits<Compare, Key>;
+
+  std::array<value_type, N> data;
+};
+
+template <typename Key, typename Compare = std::less<Key>, std::size_t N>
+constexpr static_set<Key, N, Compare> make_static_set(
+    const Key (&items)[N]) {
+  return static_set<Key, N, Compare>(items);
+}
+
+}  // namespace RBtreeMapSet
+
+#include "static_set.tpp"
+#endif  // CONTAINERS_STATIC_SET_H_
@@ -0,0 +1,108 @@
+#include "static_set.h"
+
+namespace RBtreeMapSet {
+
+template <typename Key, std::size_t N, typename Compare>
+constexpr static_set<Key, N, Compare>::static_set(const value_type (&items)[N])
+    : static_set(items, SortedOrder(items), std::make_index_sequence<N>{}) {}
+
+template <typename Key, std::size_t N, typename Compare>
+template <std::size_t... I>
+constexpr static_set<Key, N, Compare>::static_set(
+    const value_type (&items)[N], const std::array<size_type, N> &order,
+    std::index_sequence<I...>)
+    : data{{items[order[I]]...}} {}
+
+template <typename Key, std::size_t N, typename Compare>
+constexpr std::array<typename static_set<Key, N, Compare>::size_type, N>
+static_set<Key, N, Compare>::SortedOrder(const value_type (&items)[N]) {
+  std::array<size_type, N> order{};
+  Compare cmp{};
+
+  for (size_type i = 0; i < N; ++i) {
+    size_type j = i;
+    while (j > 0 && compare_traits::Less(cmp, items[i], items[order[j - 1]])) {
+      order[j] = order[j - 1];
+      --j;
+    }
+    order[j] = i;
+  }
+
+  for (size_type i = 1; i < N; ++i) {
+    if (!compare_traits::Less(cmp, items[order[i - 1]],
+                              items[order[i]])) {
+      throw std::invalid_argument("static_set keys must be unique");
+    }
+  }
+
+  return order;
+}
+
+template <typename Key, std::size_t N, typename Compare>
+constexpr typename static_set<Key, N, Compare>::const_iterator
+static_set<Key, N, Compare>::begin() const noexcept {
+  return data.data();
+}
+
+template <typename Key, std::size_t N, typename Compare>
+constexpr typename static_set<Key, N, Compare>::const_iterator
+static_set<Key, N, Compare>::end() const noexcept {
+  return data.data() + N;
+}
+
+template <typename Key, std::size_t N, typename Compare>
+constexpr bool static_set<Key, N, Compare>::empty() const noexcept {
+  return false;
+}
+
+template <typename Key, std::size_t N, typename Compare>
+constexpr typename static_set<Key, N, Compare>::size_type
+static_set<Key, N, Compare>::size() const noexcept {
+  return N;
+}
+
+template <typename Key, std::size_t N, typename Compare>
+constexpr typename static_set<Key, N, Compare>::size_type
+static_set<Key, N, Compare>::max_size() const noexcept {
+  return N;
+}
+
+template <typename Key, std::size_t N, typename Compare>
+constexpr typename static_set<Key, N, Compare>::const_iterator
+static_set<Key, N, Compare>::lower_bound(const key_type &key) const {
+  size_type first = 0;
+  size_type count = N;
+  Compare cmp{};
+
+  while (count > 0) {
+    size_type step = count / 2;
+    if (compare_traits::Less(cmp, data[first + step], key)) {
+      first += step + 1;
+      count -= step + 1;
+    } else {
+      count = step;
+    }
+  }
+
+  return begin() + first;
+}
+
+template <typename Key, std::size_t N, typename Compare>
+constexpr typename static_set<Key, N, Compare>::const_iterator
+static_set<Key, N, Compare>::find(const key_type &key) const {
+  const_iterator it = lower_bound(key);
+
+  if (it == end() || compare_traits::Less(Compare{}, key, *it)) {
+    return end();
+  }
+
+  return it;
+}
+
+template <typename Key, std::size_t N, typename Compare>
+constexpr bool static_set<Key, N, Compare>::contains(
+    const key_type &key) const {
+  return find(key) != end();
+}
+
+}  // namespace RBtreeMapSet
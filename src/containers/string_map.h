@@ -0,0 +1,82 @@
+#ifndef CONTAINERS_STRING_MAP_H_
+#define CONTAINERS_STRING_MAP_H_
+
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "radix_tree/radix_tree.h"
+
+namespace RBtreeMapSet {
+
+// map from strings stored in a compressed radix tree, see string_set and
+// RadixTree. Nodes do not store whole keys, so iterators yield
+// std::pair<const std::string &, T &> built on the fly instead of a
+// reference to a stored value_type; it->first and it->second work as usual.
+template <typename T>
+class string_map {
+ public:
+  using key_type = std::string;
+  using mapped_type = T;
+  using value_type = std::pair<const key_type, mapped_type>;
+
+  using tree_type = RadixTree<mapped_type>;
+  using iterator = typename tree_type::iterator;
+  using const_iterator = typename tree_type::const_iterator;
+  using reference = typename iterator::reference;
+  using const_reference = typename const_iterator::reference;
+  using size_type = std::size_t;
+
+  string_map();
+  string_map(std::initializer_list<value_type> const &items);
+  string_map(const string_map &other);
+  string_map(string_map &&other) noexcept;
+  ~string_map();
+
+  string_map &operator=(const string_map &other);
+  string_map &operator=(string_map &&other) noexcept;
+
+  mapped_type &at(std::string_view key);
+  const mapped_type &at(std::string_view key) const;
+  mapped_type &operator[](std::string_view key);
+
+  iterator begin() noexcept;
+  const_iterator begin() const noexcept;
+  iterator end() noexcept;
+  const_iterator end() const noexcept;
+
+  bool empty() const noexcept;
+  size_type size() const noexcept;
+  size_type max_size() const noexcept;
+
+  void clear() noexcept;
+  std::pair<iterator, bool> insert(const value_type &value);
+  std::pair<iterator, bool> insert(std::string_view key,
+                                   const mapped_type &obj);
+  std::pair<iterator, bool> insert_or_assign(std::string_view key,
+                                             const mapped_type &obj);
+  void erase(iterator pos);
+  void swap(string_map &other) noexcept;
+  void merge(string_map &other);
+
+  iterator find(std::string_view key);
+  const_iterator find(std::string_view key) const;
+  iterator lower_bound(std::string_view key);
+  const_iterator lower_bound(std::string_view key) const;
+  bool contains(std::string_view key) const;
+
+  // Elements whose key starts with prefix, in order.
+  PrefixRange<iterator> with_prefix(std::string_view prefix);
+  PrefixRange<const_iterator> with_prefix(std::string_view prefix) const;
+
+  bool operator==(const string_map &other) const;
+
+ private:
+  tree_type *tree;
+};
+
+}  // namespace RBtreeMapSet
+
+#include "string_map.tpp"
+#endif  // CONTAINERS_STRING_MAP_H_
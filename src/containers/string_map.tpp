@@ -0,0 +1,206 @@
+#include "string_map.h"
+
+namespace RBtreeMapSet {
+
+template <typename T>
+string_map<T>::string_map() : tree(new tree_type{}) {}
+
+template <typename T>
+string_map<T>::string_map(std::initializer_list<value_type> const &items)
+    : string_map() {
+  for (auto &i : items) {
+    insert(i);
+  }
+}
+
+template <typename T>
+string_map<T>::string_map(const string_map &other)
+    : tree(new tree_type(*other.tree)) {}
+
+template <typename T>
+string_map<T>::string_map(string_map &&other) noexcept
+    : tree(new tree_type(std::move(*other.tree))) {}
+
+template <typename T>
+string_map<T>::~string_map() {
+  delete tree;
+  tree = nullptr;
+}
+
+template <typename T>
+string_map<T> &string_map<T>::operator=(const string_map &other) {
+  *tree = *other.tree;
+  return *this;
+}
+
+template <typename T>
+string_map<T> &string_map<T>::operator=(string_map &&other) noexcept {
+  *tree = std::move(*other.tree);
+  return *this;
+}
+
+template <typename T>
+typename string_map<T>::mapped_type &string_map<T>::at(std::string_view key) {
+  iterator it = tree->Find(key);
+
+  if (it == end()) {
+    throw std::out_of_range("Element with the specified key not found");
+  }
+
+  return (*it).second;
+}
+
+template <typename T>
+const typename string_map<T>::mapped_type &string_map<T>::at(
+    std::string_view key) const {
+  return const_cast<string_map<T> *>(this)->at(key);
+}
+
+template <typename T>
+typename string_map<T>::mapped_type &string_map<T>::operator[](
+    std::string_view key) {
+  return (*tree->Insert(key).first).second;
+}
+
+template <typename T>
+typename string_map<T>::iterator string_map<T>::begin() noexcept {
+  return tree->Begin();
+}
+
+template <typename T>
+typename string_map<T>::const_iterator string_map<T>::begin() const noexcept {
+  return tree->Begin();
+}
+
+template <typename T>
+typename string_map<T>::iterator string_map<T>::end() noexcept {
+  return tree->End();
+}
+
+template <typename T>
+typename string_map<T>::const_iterator string_map<T>::end() const noexcept {
+  return tree->End();
+}
+
+template <typename T>
+bool string_map<T>::empty() const noexcept {
+  return tree->isEmpty();
+}
+
+template <typename T>
+typename string_map<T>::size_type string_map<T>::size() const noexcept {
+  return tree->GetSize();
+}
+
+template <typename T>
+typename string_map<T>::size_type string_map<T>::max_size() const noexcept {
+  return tree->GetMaxSize();
+}
+
+template <typename T>
+void string_map<T>::clear() noexcept {
+  tree->RemoveTree();
+}
+
+template <typename T>
+std::pair<typename string_map<T>::iterator, bool> string_map<T>::insert(
+    const value_type &value) {
+  return tree->Insert(value.first, value.second);
+}
+
+template <typename T>
+std::pair<typename string_map<T>::iterator, bool> string_map<T>::insert(
+    std::string_view key, const mapped_type &obj) {
+  return tree->Insert(key, obj);
+}
+
+template <typename T>
+std::pair<typename string_map<T>::iterator, bool>
+string_map<T>::insert_or_assign(std::string_view key, const mapped_type &obj) {
+  std::pair<iterator, bool> res = tree->Insert(key, obj);
+
+  if (!res.second) {
+    (*res.first).second = obj;
+  }
+
+  return res;
+}
+
+template <typename T>
+void string_map<T>::erase(iterator pos) {
+  tree->Erase(pos);
+}
+
+template <typename T>
+void string_map<T>::swap(string_map &other) noexcept {
+  tree->SwapTree(*other.tree);
+}
+
+template <typename T>
+void string_map<T>::merge(string_map &other) {
+  tree->Merge(*other.tree);
+}
+
+template <typename T>
+typename string_map<T>::iterator string_map<T>::find(std::string_view key) {
+  return tree->Find(key);
+}
+
+template <typename T>
+typename string_map<T>::const_iterator string_map<T>::find(
+    std::string_view key) const {
+  return tree->Find(key);
+}
+
+template <typename T>
+typename string_map<T>::iterator string_map<T>::lower_bound(
+    std::string_view key) {
+  return tree->LowerBound(key);
+}
+
+template <typename T>
+typename string_map<T>::const_iterator string_map<T>::lower_bound(
+    std::string_view key) const {
+  return tree->LowerBound(key);
+}
+
+template <typename T>
+bool string_map<T>::contains(std::string_view key) const {
+  return tree->Contains(key);
+}
+
+template <typename T>
+PrefixRange<typename string_map<T>::iterator> string_map<T>::with_prefix(
+    std::string_view prefix) {
+  return tree->WithPrefix(prefix);
+}
+
+template <typename T>
+PrefixRange<typename string_map<T>::const_iterator> string_map<T>::with_prefix(
+    std::string_view prefix) const {
+  PrefixRange<iterator> range = tree->WithPrefix(prefix);
+  return {range.first, range.last};
+}
+
+template <typename T>
+bool string_map<T>::operator==(const string_map &other) const {
+  if (this == &other) return true;
+
+  if (size() != other.size()) return false;
+
+  auto it_1 = begin();
+  auto it_2 = other.begin();
+
+  while (it_1 != end()) {
+    if ((*it_1).first != (*it_2).first || (*it_1).second != (*it_2).second) {
+      return false;
+    }
+
+    ++it_1;
+    ++it_2;
+  }
+
+  return true;
+}
+
+}  // namespace RBtreeMapSet
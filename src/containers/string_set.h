@@ -0,0 +1,74 @@
+#ifndef CONTAINERS_STRING_SET_H_
+#define CONTAINERS_STRING_SET_H_
+
+#include <initializer_list>
+#include <string>
+#include <string_view>
+
+#include "radix_tree/radix_tree.h"
+
+namespace RBtreeMapSet {
+
+// set of strings stored in a compressed radix tree, see RadixTree. Keys with
+// long shared prefixes, such as URLs and paths, keep one copy of each
+// prefix, and lookups cost O(key length) instead of O(log n) string
+// comparisons. Iteration is in the order of std::string. Iterators hold a
+// copy of their key, so *it refers into the iterator and is not kept alive
+// by the set.
+class string_set {
+ public:
+  using key_type = std::string;
+  using value_type = std::string;
+  using reference = const value_type &;
+  using const_reference = const value_type &;
+
+  using tree_type = RadixTree<>;
+  using iterator = tree_type::iterator;
+  using const_iterator = tree_type::const_iterator;
+  using size_type = std::size_t;
+
+  string_set();
+  string_set(std::initializer_list<value_type> const &items);
+  string_set(const string_set &other);
+  string_set(string_set &&other) noexcept;
+  ~string_set();
+
+  string_set &operator=(const string_set &other);
+  string_set &operator=(string_set &&other) noexcept;
+
+  iterator begin() noexcept;
+  const_iterator begin() const noexcept;
+  iterator end() noexcept;
+  const_iterator end() const noexcept;
+
+  bool empty() const noexcept;
+  size_type size() const noexcept;
+  size_type max_size() const noexcept;
+
+  void clear() noexcept;
+  std::pair<iterator, bool> insert(std::string_view key);
+  void erase(iterator pos);
+  void swap(string_set &other) noexcept;
+  void merge(string_set &other);
+
+  iterator find(std::string_view key);
+  const_iterator find(std::string_view key) const;
+  iterator lower_bound(std::string_view key);
+  const_iterator lower_bound(std::string_view key) const;
+  bool contains(std::string_view key) const;
+
+  // Elements that start with prefix, in order: for (auto &key :
+  // set.with_prefix("/api/")).
+  PrefixRange<iterator> with_prefix(std::string_view prefix);
+  PrefixRange<const_iterator> with_prefix(std::string_view prefix) const;
+
+  bool operator==(const string_set &other) const;
+
+ private:
+  tree_type *tree;
+};
+
+}  // namespace RBtreeMapSet
+
+#include "string_set.tpp"
+#endif  // CONTAINERS_STRING_SET_H_
@@ -0,0 +1,125 @@
+#include "string_set.h"
+
+namespace RBtreeMapSet {
+
+inline string_set::string_set() : tree(new tree_type{}) {}
+
+inline string_set::string_set(std::initializer_list<value_type> const &items)
+    : string_set() {
+  for (auto &i : items) {
+    insert(i);
+  }
+}
+
+inline string_set::string_set(const string_set &other)
+    : tree(new tree_type(*other.tree)) {}
+
+inline string_set::string_set(string_set &&other) noexcept
+    : tree(new tree_type(std::move(*other.tree))) {}
+
+inline string_set::~string_set() {
+  delete tree;
+  tree = nullptr;
+}
+
+inline string_set &string_set::operator=(const string_set &other) {
+  *tree = *other.tree;
+  return *this;
+}
+
+inline string_set &string_set::operator=(string_set &&other) noexcept {
+  *tree = std::move(*other.tree);
+  return *this;
+}
+
+inline string_set::iterator string_set::begin() noexcept {
+  return tree->Begin();
+}
+
+inline string_set::const_iterator string_set::begin() const noexcept {
+  return tree->Begin();
+}
+
+inline string_set::iterator string_set::end() noexcept { return tree->End(); }
+
+inline string_set::const_iterator string_set::end() const noexcept {
+  return tree->End();
+}
+
+inline bool string_set::empty() const noexcept { return tree->isEmpty(); }
+
+inline string_set::size_type string_set::size() const noexcept {
+  return tree->GetSize();
+}
+
+inline string_set::size_type string_set::max_size() const noexcept {
+  return tree->GetMaxSize();
+}
+
+inline void string_set::clear() noexcept { tree->RemoveTree(); }
+
+inline std::pair<string_set::iterator, bool> string_set::insert(
+    std::string_view key) {
+  return tree->Insert(key);
+}
+
+inline void string_set::erase(iterator pos) { tree->Erase(pos); }
+
+inline void string_set::swap(string_set &other) noexcept {
+  tree->SwapTree(*other.tree);
+}
+
+inline void string_set::merge(string_set &other) { tree->Merge(*other.tree); }
+
+inline string_set::iterator string_set::find(std::string_view key) {
+  return tree->Find(key);
+}
+
+inline string_set::const_iterator string_set::find(
+    std::string_view key) const {
+  return tree->Find(key);
+}
+
+inline string_set::iterator string_set::lower_bound(std::string_view key) {
+  return tree->LowerBound(key);
+}
+
+inline string_set::const_iterator string_set::lower_bound(
+    std::string_view key) const {
+  return tree->LowerBound(key);
+}
+
+inline bool string_set::contains(std::string_view key) const {
+  return tree->Contains(key);
+}
+
+inline PrefixRange<string_set::iterator> string_set::with_prefix(
+    std::string_view prefix) {
+  return tree->WithPrefix(prefix);
+}
+
+inline PrefixRange<string_set::const_iterator> string_set::with_prefix(
+    std::string_view prefix) const {
+  PrefixRange<iterator> range = tree->WithPrefix(prefix);
+  return {range.first, range.last};
+}
+
+inline bool string_set::operator==(const string_set &other) const {
+  if (this == &other) return true;
+
+  if (size() != other.size()) return false;
+
+  auto it_1 = begin();
+  auto it_2 = other.begin();
+
+  while (it_1 != end()) {
+    if (*it_1 != *it_2) return false;
+
+    ++it_1;
+    ++it_2;
+  }
+
+  return true;
+}
+
+}  // namespace RBtreeMapSet
@@ -0,0 +1,126 @@
+#ifndef CONTAINERS_TTL_MAP_H_
+#define CONTAINERS_TTL_MAP_H_
+
+#include <chrono>
+#include <vector>
+
+#include "red_black_tree/red_black_tree.h"
+
+namespace RBtreeMapSet {
+
+// Augment policy of ttl_map, see red_black_tree/augment.h. deadline is a
+// per-node field set by ttl_map; every node also keeps the earliest deadline
+// in its subtree.
+template <typename TimePoint>
+struct DeadlineAugment {
+  static constexpr bool kEnabled = true;
+
+  template <typename Key>
+  struct Data {
+    TimePoint deadline{};
+    TimePoint min_deadline{};
+  };
+
+  template <typename Node>
+  static void Update(Node *node) noexcept {
+    node->min_deadline = node->deadline;
+    if (node->left && node->left->min_deadline < node->min_deadline) {
+      node->min_deadline = node->left->min_deadline;
+    }
+    if (node->right && node->right->min_deadline < node->min_deadline) {
+      node->min_deadline = node->right->min_deadline;
+    }
+  }
+};
+
+// map whose entries expire. Each entry is one tree node ordered by key that
+// also carries its deadline; every node keeps the earliest deadline of its
+// subtree, so expire_until reaches the k expired entries in O(k log n)
+// without a second index. Expired entries stay visible to lookups until
+// expire_until removes them. Clock provides now(), duration and time_point,
+// like the std::chrono clocks.
+template <typename Key, typename T, typename Compare = std::less<Key>,
+          typename Clock = std::chrono::steady_clock>
+class ttl_map {
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<const key_type, mapped_type>;
+  using reference = value_type &;
+  using const_reference = const value_type &;
+  using key_compare = Compare;
+  using clock_type = Clock;
+  using duration = typename Clock::duration;
+  using time_point = typename Clock::time_point;
+
+  struct ValueLess {
+    bool operator()(const_reference value_1, const_reference value_2) const {
+      return comp(value_1.first, value_2.first);
+    }
+
+    key_compare comp;
+  };
+
+  using tree_type = RedBlackTree<value_type, ValueLess, TreeLookup,
+                                 DeadlineAugment<time_point>>;
+  using iterator = typename tree_type::iterator;
+  using const_iterator = typename tree_type::const_iterator;
+  using size_type = std::size_t;
+
+  ttl_map();
+  explicit ttl_map(const key_compare &comp);
+  ttl_map(const ttl_map &other);
+  ttl_map(ttl_map &&other) noexcept;
+  ~ttl_map();
+
+  ttl_map &operator=(const ttl_map &other);
+  ttl_map &operator=(ttl_map &&other) noexcept;
+
+  iterator begin() noexcept;
+  const_iterator begin() const noexcept;
+  iterator end() noexcept;
+  const_iterator end() const noexcept;
+
+  bool empty() const noexcept;
+  size_type size() const noexcept;
+  size_type max_size() const noexcept;
+
+  void clear() noexcept;
+  // Inserts an entry that expires ttl from now, unless the key is stored.
+  std::pair<iterator, bool> insert(const key_type &key, const mapped_type &obj,
+                                   duration ttl);
+  // Same, but a stored entry gets obj and the new deadline.
+  std::pair<iterator, bool> insert_or_assign(const key_type &key,
+                                             const mapped_type &obj,
+                                             duration ttl);
+  void erase(iterator pos);
+  void swap(ttl_map &other) noexcept;
+
+  iterator find(const key_type &key);
+  const_iterator find(const key_type &key) const;
+  bool contains(const key_type &key) const;
+
+  // Moves the deadline of the entry to ttl from now. Returns false if the key
+  // is not stored.
+  bool touch(const key_type &key, duration ttl);
+  time_point expiry(const_iterator pos) const noexcept;
+
+  // Erases every entry whose deadline is not after now, earliest deadline
+  // first, and returns how many there were. fn(reference) sees each entry
+  // just before it is erased and may move its mapped value out.
+  size_type expire_until(time_point now);
+  template <typename Fn>
+  size_type expire_until(time_point now, Fn fn);
+
+  key_compare key_comp() const;
+
+ private:
+  void set_deadline(iterator pos, time_point deadline) noexcept;
+
+  tree_type *tree;
+};
+
+}  // namespace RBtreeMapSet
+
+#include "ttl_map.tpp"
+#endif  // CONTAINERS_TTL_MAP_H_
@@ -0,0 +1,213 @@
+#include <algorithm>
+
+#include "ttl_map.h"
+
+namespace RBtreeMapSet {
+
+template <typename Key, typename T, typename Compare, typename Clock>
+ttl_map<Key, T, Compare, Clock>::ttl_map() : tree(new tree_type{}) {}
+
+template <typename Key, typename T, typename Compare, typename Clock>
+ttl_map<Key, T, Compare, Clock>::ttl_map(const key_compare &comp)
+    : tree(new tree_type(ValueLess{comp})) {}
+
+template <typename Key, typename T, typename Compare, typename Clock>
+ttl_map<Key, T, Compare, Clock>::ttl_map(const ttl_map &other)
+    : tree(new tree_type(*other.tree)) {}
+
+template <typename Key, typename T, typename Compare, typename Clock>
+ttl_map<Key, T, Compare, Clock>::ttl_map(ttl_map &&other) noexcept
+    : tree(new tree_type(std::move(*other.tree))) {}
+
+template <typename Key, typename T, typename Compare, typename Clock>
+ttl_map<Key, T, Compare, Clock>::~ttl_map() {
+  delete tree;
+  tree = nullptr;
+}
+
+template <typename Key, typename T, typename Compare, typename Clock>
+ttl_map<Key, T, Compare, Clock> &ttl_map<Key, T, Compare, Clock>::operator=(
+    const ttl_map &other) {
+  *tree = *other.tree;
+  return *this;
+}
+
+template <typename Key, typename T, typename Compare, typename Clock>
+ttl_map<Key, T, Compare, Clock> &ttl_map<Key, T, Compare, Clock>::operator=(
+    ttl_map &&other) noexcept {
+  *tree = std::move(*other.tree);
+  return *this;
+}
+
+template <typename Key, typename T, typename Compare, typename Clock>
+typename ttl_map<Key, T, Compare, Clock>::iterator
+ttl_map<Key, T, Compare, Clock>::begin() noexcept {
+  return tree->Begin();
+}
+
+template <typename Key, typename T, typename Compare, typename Clock>
+typename ttl_map<Key, T, Compare, Clock>::const_iterator
+ttl_map<Key, T, Compare, Clock>::begin() const noexcept {
+  return tree->Begin();
+}
+
+template <typename Key, typename T, typename Compare, typename Clock>
+typename ttl_map<Key, T, Compare, Clock>::iterator
+ttl_map<Key, T, Compare, Clock>::end() noexcept {
+  return tree->End();
+}
+
+template <typename Key, typename T, typename Compare, typename Clock>
+typename ttl_map<Key, T, Compare, Clock>::const_iterator
+ttl_map<Key, T, Compare, Clock>::end() const noexcept {
+  return tree->End();
+}
+
+template <typename Key, typename T, typename Compare, typename Clock>
+bool ttl_map<Key, T, Compare, Clock>::empty() const noexcept {
+  return tree->isEmpty();
+}
+
+template <typename Key, typename T, typename Compare, typename Clock>
+typename ttl_map<Key, T, Compare, Clock>::size_type
+ttl_map<Key, T, Compare, Clock>::size() const noexcept {
+  return tree->GetSize();
+}
+
+template <typename Key, typename T, typename Compare, typename Clock>
+typename ttl_map<Key, T, Compare, Clock>::size_type
+ttl_map<Key, T, Compare, Clock>::max_size() const noexcept {
+  return tree->GetMaxSize();
+}
+
+template <typename Key, typename T, typename Compare, typename Clock>
+void ttl_map<Key, T, Compare, Clock>::clear() noexcept {
+  tree->RemoveTree();
+}
+
+template <typename Key, typename T, typename Compare, typename Clock>
+std::pair<typename ttl_map<Key, T, Compare, Clock>::iterator, bool>
+ttl_map<Key, T, Compare, Clock>::insert(const key_type &key,
+                                        const mapped_type &obj,
+                                        duration ttl) {
+  time_point deadline = Clock::now() + ttl;
+  std::pair<iterator, bool> res = tree->Insert(value_type{key, obj});
+
+  if (res.second) {
+    set_deadline(res.first, deadline);
+  }
+
+  return res;
+}
+
+template <typename Key, typename T, typename Compare, typename Clock>
+std::pair<typename ttl_map<Key, T, Compare, Clock>::iterator, bool>
+ttl_map<Key, T, Compare, Clock>::insert_or_assign(const key_type &key,
+                                                  const mapped_type &obj,
+                                                  duration ttl) {
+  time_point deadline = Clock::now() + ttl;
+  std::pair<iterator, bool> res = tree->Insert(value_type{key, obj});
+
+  if (!res.second) {
+    (*res.first).second = obj;
+  }
+  set_deadline(res.first, deadline);
+
+  return res;
+}
+
+template <typename Key, typename T, typename Compare, typename Clock>
+void ttl_map<Key, T, Compare, Clock>::erase(iterator pos) {
+  tree->Erase(pos);
+}
+
+template <typename Key, typename T, typename Compare, typename Clock>
+void ttl_map<Key, T, Compare, Clock>::swap(ttl_map &other) noexcept {
+  tree->SwapTree(*other.tree);
+}
+
+template <typename Key, typename T, typename Compare, typename Clock>
+typename ttl_map<Key, T, Compare, Clock>::iterator
+ttl_map<Key, T, Compare, Clock>::find(const key_type &key) {
+  return tree->Find({key, mapped_type{}});
+}
+
+template <typename Key, typename T, typename Compare, typename Clock>
+typename ttl_map<Key, T, Compare, Clock>::const_iterator
+ttl_map<Key, T, Compare, Clock>::find(const key_type &key) const {
+  return tree->Find({key, mapped_type{}});
+}
+
+template <typename Key, typename T, typename Compare, typename Clock>
+bool ttl_map<Key, T, Compare, Clock>::contains(const key_type &key) const {
+  return find(key) != end();
+}
+
+template <typename Key, typename T, typename Compare, typename Clock>
+bool ttl_map<Key, T, Compare, Clock>::touch(const key_type &key,
+                                            duration ttl) {
+  iterator it = find(key);
+
+  if (it == end()) {
+    return false;
+  }
+
+  set_deadline(it, Clock::now() + ttl);
+  return true;
+}
+
+template <typename Key, typename T, typename Compare, typename Clock>
+typename ttl_map<Key, T, Compare, Clock>::time_point
+ttl_map<Key, T, Compare, Clock>::expiry(const_iterator pos) const noexcept {
+  return pos.node_->deadline;
+}
+
+template <typename Key, typename T, typename Compare, typename Clock>
+typename ttl_map<Key, T, Compare, Clock>::size_type
+ttl_map<Key, T, Compare, Clock>::expire_until(time_point now) {
+  return expire_until(now, [](reference) {});
+}
+
+template <typename Key, typename T, typename Compare, typename Clock>
+template <typename Fn>
+typename ttl_map<Key, T, Compare, Clock>::size_type
+ttl_map<Key, T, Compare, Clock>::expire_until(time_point now, Fn fn) {
+  std::vector<iterator> expired;
+  tree->SearchAugmented(
+      [&now](const auto &node) { return !(now < node.min_deadline); },
+      [](const_reference) { return false; },
+      [&now, &expired](iterator it) {
+        if (!(now < it.node_->deadline)) {
+          expired.push_back(it);
+        }
+      });
+
+  std::stable_sort(expired.begin(), expired.end(),
+                   [](iterator it_1, iterator it_2) {
+                     return it_1.node_->deadline < it_2.node_->deadline;
+                   });
+
+  // Erasing relinks nodes without moving them, so the other iterators stay
+  // valid.
+  for (iterator it : expired) {
+    fn(*it);
+    tree->Erase(it);
+  }
+
+  return expired.size();
+}
+
+template <typename Key, typename T, typename Compare, typename Clock>
+typename ttl_map<Key, T, Compare, Clock>::key_compare
+ttl_map<Key, T, Compare, Clock>::key_comp() const {
+  return tree->GetComparator().comp;
+}
+
+template <typename Key, typename T, typename Compare, typename Clock>
+void ttl_map<Key, T, Compare, Clock>::set_deadline(
+    iterator pos, time_point deadline) noexcept {
+  pos.node_->deadline = deadline;
+  tree->RefreshAugment(pos);
+}
+
+}  // namespace RBtreeMapSet
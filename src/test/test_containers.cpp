@@ -1,5 +1,15 @@
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <set>
+#include <sstream>
+#include <string_view>
+#include <thread>
+
 #include "../containers/containers.h"
 
 // TREE//
@@ -55,6 +65,47 @@ TEST(RedBlackTree, Constructors_4) {
   EXPECT_NE(tree_2.Find(2), tree_2.End());
 }
 
+TEST(RedBlackTree, CopyAssign) {
+  RBtreeMapSet::RedBlackTree<std::string> source;
+  RBtreeMapSet::RedBlackTree<std::string> tree;
+  for (int key = 0; key < 300; ++key) {
+    source.Insert(std::to_string(key * 7919 % 300));
+    tree.Insert(std::to_string(key + 1000));
+  }
+
+  std::set<const std::string *> nodes;
+  for (auto it = tree.Begin(); it != tree.End(); ++it) {
+    nodes.insert(&*it);
+  }
+
+  tree = source;
+  EXPECT_EQ(tree.CheckTree(), true);
+  EXPECT_EQ(std::vector<std::string>(tree.Begin(), tree.End()),
+            std::vector<std::string>(source.Begin(), source.End()));
+  std::set<const std::string *> reused;
+  for (auto it = tree.Begin(); it != tree.End(); ++it) {
+    reused.insert(&*it);
+  }
+  EXPECT_EQ(reused, nodes);
+
+  for (int key = 0; key < 300; key += 2) {
+    source.Erase(source.Find(std::to_string(key)));
+  }
+  tree.Compact();
+  tree = source;
+  EXPECT_EQ(tree.CheckTree(), true);
+  EXPECT_EQ(tree.GetSize(), 150U);
+  EXPECT_NE(tree.Find("299"), tree.End());
+  EXPECT_EQ(tree.Find("298"), tree.End());
+
+  RBtreeMapSet::RedBlackTree<std::string> small;
+  small.Insert("a");
+  small = tree;
+  EXPECT_EQ(small.CheckTree(), true);
+  EXPECT_EQ(std::vector<std::string>(small.Begin(), small.End()),
+            std::vector<std::string>(tree.Begin(), tree.End()));
+}
+
 TEST(RedBlackTree, Iterator_1) {
   RBtreeMapSet::RedBlackTree<int> tree;
   for (int i = 5; i >= 0; --i) {
@@ -405,6 +456,360 @@ TEST(RedBlackTree, Erase_6) {
   EXPECT_EQ(tree.CheckTree(), true);
 }
 
+struct CountingThreeWay {
+  int operator()(int a, int b) const {
+    ++*calls;
+    return a < b ? -1 : (a > b ? 1 : 0);
+  }
+
+  int *calls;
+};
+
+TEST(RedBlackTree, ThreeWayCompare) {
+  int calls = 0;
+  RBtreeMapSet::RedBlackTree<int, CountingThreeWay> tree{
+      CountingThreeWay{&calls}};
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_TRUE(tree.Insert(i).second);
+  }
+  EXPECT_EQ(tree.CheckTree(), true);
+
+  int root_key = 0;
+  for (int i = 0; i < 1000; ++i) {
+    calls = 0;
+    tree.Find(i);
+    if (calls == 1) {
+      root_key = i;
+    }
+    EXPECT_LE(calls, 20);
+  }
+
+  calls = 0;
+  EXPECT_NE(tree.Find(root_key), tree.End());
+  EXPECT_EQ(calls, 1);
+
+  calls = 0;
+  EXPECT_FALSE(tree.Insert(root_key).second);
+  EXPECT_EQ(calls, 1);
+
+  calls = 0;
+  EXPECT_EQ(tree.Find(1000), tree.End());
+  EXPECT_LE(calls, 20);
+
+  int expected = 0;
+  for (auto it = tree.Begin(); it != tree.End(); ++it) {
+    EXPECT_EQ(*it, expected++);
+  }
+}
+
+TEST(RedBlackTree, StringCompare) {
+  RBtreeMapSet::RedBlackTree<std::string> tree;
+  tree.Insert("b");
+  tree.Insert("a");
+  tree.Insert("c");
+  EXPECT_FALSE(tree.Insert("a").second);
+  EXPECT_EQ(tree.GetSize(), 3U);
+  EXPECT_NE(tree.Find("c"), tree.End());
+  EXPECT_EQ(tree.Find("d"), tree.End());
+  EXPECT_EQ(*tree.Begin(), "a");
+}
+
+TEST(RedBlackTree, BuildFromSorted) {
+  for (int count = 0; count < 300; ++count) {
+    RBtreeMapSet::RedBlackTree<int> tree;
+    tree.Insert(-1);
+    int next = 0;
+    tree.BuildFromSorted(count, [&next]() { return next++; });
+    EXPECT_EQ(tree.GetSize(), static_cast<std::size_t>(count));
+    EXPECT_EQ(tree.CheckTree(), true);
+
+    int expected = 0;
+    for (auto it = tree.Begin(); it != tree.End(); ++it) {
+      EXPECT_EQ(*it, expected++);
+    }
+    EXPECT_EQ(expected, count);
+  }
+
+  RBtreeMapSet::RedBlackTree<int> tree;
+  int next = 0;
+  tree.BuildFromSorted(100, [&next]() { return next += 2; });
+  EXPECT_TRUE(tree.Insert(51).second);
+  tree.Erase(tree.Find(100));
+  EXPECT_EQ(tree.CheckTree(), true);
+  EXPECT_EQ(tree.GetSize(), 100U);
+}
+
+TEST(RedBlackTree, ApplyBatch) {
+  using op = RBtreeMapSet::BatchOp<int>;
+  using RBtreeMapSet::BatchAction;
+
+  for (int batch_size : {5, 30, 400}) {
+    RBtreeMapSet::RedBlackTree<int> tree;
+    std::set<int> expected;
+    for (int key = 0; key < 1000; key += 5) {
+      tree.Insert(key);
+      expected.insert(key);
+    }
+
+    std::vector<op> ops;
+    unsigned seed = batch_size;
+    int key = 0;
+    for (int i = 0; i < batch_size; ++i) {
+      seed = seed * 1103515245 + 12345;
+      key += (seed >> 16) % (2000 / batch_size + 1);
+      ops.push_back({static_cast<BatchAction>((seed >> 8) % 3), key});
+    }
+    ops.push_back({BatchAction::kInsert, key});
+    ops.push_back({BatchAction::kErase, key});
+
+    std::vector<bool> res = tree.ApplyBatch(ops.begin(), ops.end());
+    ASSERT_EQ(res.size(), ops.size());
+
+    for (std::size_t i = 0; i < ops.size(); ++i) {
+      bool present = expected.count(ops[i].key) != 0;
+      if (ops[i].action == BatchAction::kErase) {
+        EXPECT_EQ(res[i], present);
+        expected.erase(ops[i].key);
+      } else {
+        EXPECT_EQ(res[i], !present);
+        expected.insert(ops[i].key);
+      }
+    }
+
+    EXPECT_EQ(tree.CheckTree(), true);
+    EXPECT_EQ(tree.GetSize(), expected.size());
+    auto it = tree.Begin();
+    for (int item : expected) {
+      EXPECT_EQ(*it, item);
+      ++it;
+    }
+    EXPECT_TRUE(it == tree.End());
+  }
+}
+
+TEST(RedBlackTree, Split) {
+  RBtreeMapSet::RedBlackTree<int> tree;
+  EXPECT_EQ(tree.Split(8).size(), 1U);
+
+  for (int key = 0; key < 1000; ++key) {
+    tree.Insert(key);
+  }
+
+  std::vector<RBtreeMapSet::RedBlackTree<int>::iterator> bounds =
+      tree.Split(16);
+  EXPECT_EQ(bounds.size(), 17U);
+  EXPECT_TRUE(bounds.front() == tree.Begin());
+  EXPECT_TRUE(bounds.back() == tree.End());
+
+  int expected = 0;
+  for (std::size_t part = 0; part + 1 < bounds.size(); ++part) {
+    int count = 0;
+    for (auto it = bounds[part]; it != bounds[part + 1]; ++it, ++count) {
+      EXPECT_EQ(*it, expected++);
+    }
+    EXPECT_GT(count, 0);
+  }
+  EXPECT_EQ(expected, 1000);
+
+  bounds = tree.Split(16, 100, 200);
+  EXPECT_EQ(*bounds.front(), 100);
+  EXPECT_EQ(*bounds.back(), 200);
+  EXPECT_EQ(tree.Split(16, 200, 100).size(), 1U);
+}
+
+TEST(RedBlackTree, FingerSearch) {
+  RBtreeMapSet::RedBlackTree<int> tree;
+  EXPECT_TRUE(tree.LowerBound(1, tree.End()) == tree.End());
+
+  for (int key = 0; key < 200; key += 2) {
+    tree.Insert(key);
+  }
+
+  std::vector<RBtreeMapSet::RedBlackTree<int>::const_iterator> hints;
+  for (auto it = tree.Begin(); it != tree.End(); ++it) {
+    hints.push_back(it);
+  }
+  hints.push_back(tree.End());
+
+  for (const auto &hint : hints) {
+    for (int key = -1; key <= 200; ++key) {
+      auto expected = tree.LowerBound(key);
+      ASSERT_TRUE(tree.LowerBound(key, hint) == expected);
+      ASSERT_TRUE(tree.Find(key, hint) ==
+                  (key % 2 == 0 && key < 200 ? expected : tree.End()));
+    }
+  }
+
+  auto res = tree.Insert(51, tree.Find(50));
+  EXPECT_TRUE(res.second);
+  EXPECT_EQ(*res.first, 51);
+  EXPECT_FALSE(tree.Insert(51, tree.End()).second);
+  EXPECT_TRUE(tree.Insert(-5, tree.End()).second);
+  EXPECT_TRUE(tree.Insert(500, tree.Begin()).second);
+  EXPECT_EQ(*tree.Begin(), -5);
+  EXPECT_EQ(tree.GetSize(), 103U);
+  EXPECT_EQ(tree.CheckTree(), true);
+}
+
+TEST(RedBlackTree, Compact) {
+  for (RBtreeMapSet::NodeLayout layout :
+       {RBtreeMapSet::NodeLayout::kInOrder,
+        RBtreeMapSet::NodeLayout::kVanEmdeBoas}) {
+    RBtreeMapSet::RedBlackTree<std::string> tree;
+    tree.Compact(layout);
+
+    for (int key = 0; key < 500; ++key) {
+      tree.Insert(std::to_string(key * 7919 % 500));
+    }
+    for (int key = 0; key < 500; key += 3) {
+      tree.Erase(tree.Find(std::to_string(key)));
+    }
+
+    std::vector<std::string> keys(tree.Begin(), tree.End());
+    std::vector<std::string> top;
+    for (auto it : tree.Split(64)) {
+      top.push_back(it == tree.End() ? "" : *it);
+    }
+
+    tree.Compact(layout);
+    EXPECT_EQ(tree.CheckTree(), true);
+    EXPECT_EQ(std::vector<std::string>(tree.Begin(), tree.End()), keys);
+    std::vector<std::string> top_after;
+    for (auto it : tree.Split(64)) {
+      top_after.push_back(it == tree.End() ? "" : *it);
+    }
+    EXPECT_EQ(top_after, top);
+
+    RBtreeMapSet::RedBlackTree<std::string> other;
+    other.Insert("1");
+    other.Insert("x");
+    other.Merge(tree);
+    EXPECT_EQ(other.GetSize(), 2 + keys.size() - 1);
+    EXPECT_EQ(tree.GetSize(), 1U);
+
+    tree.Compact(layout);
+    tree.Insert("y");
+    tree.Erase(tree.Find("1"));
+    EXPECT_EQ(std::vector<std::string>(tree.Begin(), tree.End()),
+              std::vector<std::string>{"y"});
+
+    other.Compact(layout);
+    other.Compact(layout);
+    for (int key = 0; key < 500; key += 2) {
+      other.Erase(other.Find(std::to_string(key)));
+    }
+    EXPECT_EQ(other.CheckTree(), true);
+    RBtreeMapSet::RedBlackTree<std::string> copy(other);
+    EXPECT_EQ(copy.GetSize(), other.GetSize());
+  }
+}
+
+TEST(RedBlackTree, HashLookup) {
+  using Tree =
+      RBtreeMapSet::RedBlackTree<int, std::less<int>,
+                                 RBtreeMapSet::HashLookup<std::hash<int>>>;
+  Tree tree;
+  std::set<int> expected;
+  auto check = [&expected](Tree &checked) {
+    EXPECT_EQ(checked.CheckTree(), true);
+    EXPECT_EQ(checked.GetSize(), expected.size());
+    for (int key = -1; key <= 1000; ++key) {
+      auto it = checked.Find(key);
+      if (expected.count(key)) {
+        ASSERT_TRUE(it != checked.End());
+        EXPECT_EQ(*it, key);
+      } else {
+        EXPECT_TRUE(it == checked.End());
+      }
+    }
+  };
+
+  for (int key = 0; key < 700; ++key) {
+    tree.Insert(key * 7919 % 1000);
+    expected.insert(key * 7919 % 1000);
+  }
+  for (int key = 0; key < 1000; key += 3) {
+    tree.Erase(tree.Find(key));
+    expected.erase(key);
+  }
+  check(tree);
+  EXPECT_GT(tree.GetIndexMemoryUsage(), expected.size() * sizeof(void *));
+
+  std::vector<RBtreeMapSet::BatchOp<int>> batch;
+  for (int key = 0; key < 1000; key += 5) {
+    batch.push_back({RBtreeMapSet::BatchAction::kAssign, key});
+    expected.insert(key);
+  }
+  tree.ApplyBatch(batch.begin(), batch.end());
+  check(tree);
+
+  tree.Compact();
+  check(tree);
+
+  Tree other;
+  other.Insert(1000);
+  other.Insert(0);
+  other.Merge(tree);
+  EXPECT_EQ(tree.GetSize(), 1U);
+  expected.insert(1000);
+  check(other);
+
+  Tree copy(other);
+  check(copy);
+  tree = std::move(other);
+  check(tree);
+
+  tree.BuildFromSorted(500, [key = 0]() mutable { return key += 2; });
+  expected.clear();
+  for (int key = 2; key <= 1000; key += 2) {
+    expected.insert(key);
+  }
+  check(tree);
+
+  tree.RemoveTree();
+  expected.clear();
+  check(tree);
+}
+
+TEST(RedBlackTree, CacheLookup) {
+  using Tree =
+      RBtreeMapSet::RedBlackTree<int, std::less<int>,
+                                 RBtreeMapSet::CacheLookup<std::hash<int>, 4>>;
+  Tree tree;
+  std::set<int> expected;
+  for (int key = 0; key < 64; ++key) {
+    tree.Insert(key);
+    expected.insert(key);
+  }
+
+  for (int round = 0; round < 4; ++round) {
+    for (int i = 0; i < 256; ++i) {
+      int key = i % 3 ? i % 4 : i * 37 % 80;
+      auto it = tree.Find(key);
+      ASSERT_EQ(it != tree.End(), expected.count(key) == 1);
+      if (it != tree.End()) {
+        EXPECT_EQ(*it, key);
+      }
+    }
+
+    for (int key = round; key < 64; key += 8) {
+      tree.Erase(tree.Find(key));
+      expected.erase(key);
+    }
+    std::vector<RBtreeMapSet::BatchOp<int>> batch{
+        {RBtreeMapSet::BatchAction::kAssign, 1},
+        {RBtreeMapSet::BatchAction::kAssign, 2}};
+    tree.ApplyBatch(batch.begin(), batch.end());
+    expected.insert({1, 2});
+    tree.Compact();
+  }
+
+  EXPECT_EQ(tree.CheckTree(), true);
+  EXPECT_EQ(std::set<int>(tree.Begin(), tree.End()), expected);
+  tree.RemoveTree();
+  EXPECT_TRUE(tree.Find(1) == tree.End());
+}
+
 // MAP//
 
 TEST(Map, Constructors_1) {
@@ -559,6 +964,449 @@ TEST(Map, Merge) {
   EXPECT_TRUE(map_2.empty());
 }
 
+struct StringThreeWay {
+  int operator()(const std::string &a, const std::string &b) const {
+    return a.compare(b);
+  }
+};
+
+// Ascending or descending, chosen per instance.
+struct Direction {
+  bool operator()(int a, int b) const { return desc ? b < a : a < b; }
+
+  bool desc = false;
+};
+
+TEST(Map, Compare) {
+  RBtreeMapSet::map<int, std::string, std::greater<int>> map{
+      {1, "1"}, {3, "3"}, {2, "2"}};
+  int expected = 3;
+  for (auto it = map.begin(); it != map.end(); ++it) {
+    EXPECT_EQ((*it).first, expected--);
+  }
+  EXPECT_TRUE(map.contains(2));
+  EXPECT_FALSE(map.contains(4));
+  EXPECT_TRUE(map.key_comp()(2, 1));
+
+  RBtreeMapSet::map<std::string, int, StringThreeWay> map_1;
+  map_1.insert("b", 2);
+  map_1.insert("a", 1);
+  EXPECT_FALSE(map_1.insert("b", 3).second);
+  EXPECT_EQ(map_1.at("a"), 1);
+  EXPECT_EQ(map_1.at("b"), 2);
+  EXPECT_THROW(map_1.at("c"), std::out_of_range);
+  EXPECT_EQ((*map_1.begin()).first, "a");
+
+  // An empty source still passes on its comparator.
+  using directed_map = RBtreeMapSet::map<int, int, Direction>;
+  directed_map empty(Direction{true});
+  directed_map copy(empty);
+  directed_map assigned;
+  assigned.insert(5, 5);
+  assigned = empty;
+  for (directed_map *target : {&copy, &assigned}) {
+    EXPECT_TRUE(target->key_comp().desc);
+    for (int key : {1, 3, 2}) {
+      target->insert(key, key);
+    }
+    EXPECT_EQ((*target->begin()).first, 3);
+    EXPECT_EQ((*--target->end()).first, 1);
+  }
+
+  RBtreeMapSet::ttl_map<int, int, Direction> ttl_empty(Direction{true});
+  RBtreeMapSet::ttl_map<int, int, Direction> ttl_copy(ttl_empty);
+  ttl_copy.insert(1, 1, std::chrono::seconds(1));
+  ttl_copy.insert(2, 2, std::chrono::seconds(1));
+  EXPECT_EQ((*ttl_copy.begin()).first, 2);
+}
+
+TEST(Map, SaveLoad) {
+  RBtreeMapSet::map<int, double> map;
+  for (int i = 0; i < 1000; ++i) {
+    map.insert(i * 3, i / 2.0);
+  }
+
+  std::stringstream stream;
+  map.save(stream);
+
+  RBtreeMapSet::map<int, double> loaded{{-1, 1.0}};
+  loaded.load(stream);
+  EXPECT_TRUE(loaded == map);
+  EXPECT_TRUE(loaded.insert(1, 1.0).second);
+  EXPECT_DOUBLE_EQ(loaded.at(300), 50.0);
+
+  RBtreeMapSet::map<std::string, std::string> map_1{
+      {"b", "2"}, {"a", ""}, {"c", "three"}};
+  std::stringstream stream_1;
+  map_1.save(stream_1);
+
+  RBtreeMapSet::map<std::string, std::string> loaded_1;
+  loaded_1.load(stream_1);
+  EXPECT_TRUE(loaded_1 == map_1);
+  EXPECT_EQ(loaded_1.at("c"), "three");
+}
+
+TEST(Map, LoadErrors) {
+  RBtreeMapSet::map<int, int> map{{1, 1}, {2, 2}, {3, 3}};
+  std::stringstream stream;
+  map.save(stream);
+  std::string data = stream.str();
+
+  RBtreeMapSet::map<int, int> loaded{{7, 7}};
+  std::stringstream truncated(data.substr(0, data.size() - 1));
+  EXPECT_THROW(loaded.load(truncated), std::runtime_error);
+  EXPECT_EQ(loaded.size(), 1U);
+  EXPECT_TRUE(loaded.contains(7));
+
+  std::stringstream garbage("not a container");
+  EXPECT_THROW(loaded.load(garbage), std::runtime_error);
+
+  std::stringstream other_type;
+  RBtreeMapSet::map<int, double>{{1, 1.0}}.save(other_type);
+  EXPECT_THROW(loaded.load(other_type), std::runtime_error);
+
+  // A record count far beyond the stream is rejected before anything is
+  // reserved for it. The count follows magic, version and record size.
+  std::string huge_count = data;
+  huge_count.replace(16, 8, 8, '\x7f');
+  RBtreeMapSet::hashed_map<int, int> hashed{{7, 7}};
+  std::stringstream corrupt(huge_count);
+  EXPECT_THROW(hashed.load(corrupt), std::runtime_error);
+  EXPECT_TRUE(hashed.contains(7));
+  std::stringstream short_count(data.substr(0, 20));
+  EXPECT_THROW(hashed.load(short_count), std::runtime_error);
+}
+
+TEST(Map, ApplyBatch) {
+  using batch_op = RBtreeMapSet::map<int, std::string>::batch_op;
+  using RBtreeMapSet::BatchAction;
+
+  RBtreeMapSet::map<int, std::string> map{{1, "1"}, {3, "3"}, {5, "5"}};
+  std::vector<batch_op> ops{{BatchAction::kInsert, {0, "0"}},
+                            {BatchAction::kInsert, {1, "one"}},
+                            {BatchAction::kAssign, {3, "three"}},
+                            {BatchAction::kErase, {5, ""}},
+                            {BatchAction::kErase, {6, ""}},
+                            {BatchAction::kAssign, {7, "7"}}};
+
+  std::vector<bool> res = map.apply_batch(ops.begin(), ops.end());
+  EXPECT_EQ(res, (std::vector<bool>{true, false, false, true, false, true}));
+
+  RBtreeMapSet::map<int, std::string> expected{
+      {0, "0"}, {1, "1"}, {3, "three"}, {7, "7"}};
+  EXPECT_TRUE(map == expected);
+
+  std::vector<batch_op> few{{BatchAction::kAssign, {1, "one"}}};
+  for (int key = 10; key < 100; ++key) {
+    map.insert(key, std::to_string(key));
+  }
+  EXPECT_EQ(map.apply_batch(few.begin(), few.end()),
+            std::vector<bool>{false});
+  EXPECT_EQ(map.at(1), "one");
+
+  // Unsorted batches give the same result whether or not they are as large
+  // as the map.
+  RBtreeMapSet::map<int, std::string> small{{10, "10"}};
+  std::vector<batch_op> unsorted{{BatchAction::kInsert, {5, "5"}},
+                                 {BatchAction::kInsert, {1, "1"}},
+                                 {BatchAction::kErase, {10, ""}},
+                                 {BatchAction::kAssign, {3, "3"}}};
+  EXPECT_EQ(small.apply_batch(unsorted.begin(), unsorted.end()),
+            (std::vector<bool>{true, true, true, true}));
+  EXPECT_TRUE(small == (RBtreeMapSet::map<int, std::string>{
+                           {1, "1"}, {3, "3"}, {5, "5"}}));
+  RBtreeMapSet::map<int, std::string> large{{10, "10"}, {2, "2"}, {4, "4"},
+                                            {6, "6"}, {8, "8"}};
+  EXPECT_EQ(large.apply_batch(unsorted.begin(), unsorted.end()),
+            (std::vector<bool>{true, true, true, true}));
+  EXPECT_TRUE(large == (RBtreeMapSet::map<int, std::string>{
+                           {1, "1"}, {2, "2"}, {3, "3"}, {4, "4"},
+                           {5, "5"}, {6, "6"}, {8, "8"}}));
+}
+
+TEST(Map, Parallel) {
+  RBtreeMapSet::map<int, long> map;
+  long expected = 0;
+  for (int key = 0; key < 100000; ++key) {
+    map.insert(key, key % 7);
+    expected += key % 7;
+  }
+
+  auto add = [](long acc, const std::pair<const int, long> &item) {
+    return acc + item.second;
+  };
+  auto combine = [](long acc_1, long acc_2) { return acc_1 + acc_2; };
+  EXPECT_EQ(RBtreeMapSet::parallel_reduce(map, 0L, add, combine), expected);
+  EXPECT_EQ(RBtreeMapSet::parallel_reduce(map, 10, 17, 0L, add, combine),
+            3 + 4 + 5 + 6 + 0 + 1 + 2);
+  // A start of 5 would be added once per range, so it is rejected for small
+  // containers, processed as one range, and for large ones alike.
+  EXPECT_THROW(RBtreeMapSet::parallel_reduce(map, 5L, add, combine),
+               std::invalid_argument);
+  EXPECT_THROW(RBtreeMapSet::parallel_reduce(map, 10, 17, 5L, add, combine),
+               std::invalid_argument);
+  auto multiply = [](long acc_1, long acc_2) { return acc_1 * acc_2; };
+  auto times = [](long acc, const std::pair<const int, long> &item) {
+    return acc * (item.second % 2 + 1);
+  };
+  EXPECT_EQ(RBtreeMapSet::parallel_reduce(map, 1, 5, 1L, times, multiply),
+            2 * 1 * 2 * 1);
+
+  RBtreeMapSet::parallel_for_each(
+      map, [](std::pair<const int, long> &item) { item.second *= 2; });
+  EXPECT_EQ(RBtreeMapSet::parallel_reduce(map, 0L, add, combine),
+            2 * expected);
+
+  std::atomic<int> visited{0};
+  RBtreeMapSet::parallel_for_each(
+      map, 500, 99000,
+      [&visited](const std::pair<const int, long> &) { ++visited; });
+  EXPECT_EQ(visited, 98500);
+
+  auto concat = [](std::string acc, const std::pair<const int, long> &item) {
+    return acc + std::to_string(item.first % 10);
+  };
+  auto join = [](std::string acc_1, const std::string &acc_2) {
+    return acc_1 + acc_2;
+  };
+  std::string digits =
+      RBtreeMapSet::parallel_reduce(map, 0, 30000, std::string(), concat, join);
+  ASSERT_EQ(digits.size(), 30000U);
+  EXPECT_EQ(digits.substr(0, 12), "012345678901");
+
+  EXPECT_THROW(RBtreeMapSet::parallel_for_each(
+                   map,
+                   [](const std::pair<const int, long> &item) {
+                     if (item.first == 54321) {
+                       throw std::runtime_error("stop");
+                     }
+                   }),
+               std::runtime_error);
+}
+
+TEST(Map, FingerMode) {
+  RBtreeMapSet::map<int, int> map;
+  map.set_finger_mode(true);
+
+  for (int key = 0; key < 1000; ++key) {
+    map.insert(key, key * key);
+  }
+  for (int key = 0; key < 1000; key += 3) {
+    EXPECT_EQ(map.at(key), key * key);
+    EXPECT_TRUE(map.contains(key));
+  }
+  EXPECT_FALSE(map.contains(1000));
+
+  auto it = map.find(500);
+  map.erase(it);
+  EXPECT_TRUE(map.find(500) == map.end());
+  EXPECT_EQ((*map.lower_bound(500)).first, 501);
+  EXPECT_EQ((*map.find(499)).second, 499 * 499);
+
+  map.clear();
+  EXPECT_TRUE(map.find(1) == map.end());
+  map.insert(map.end(), {7, 49});
+  map.set_finger_mode(false);
+  EXPECT_EQ(map.at(7), 49);
+
+  const RBtreeMapSet::map<int, int> &ref = map;
+  EXPECT_EQ((*ref.find(7)).second, 49);
+  EXPECT_EQ((*map.find(7, map.begin())).second, 49);
+}
+
+TEST(Map, Compact) {
+  RBtreeMapSet::map<int, std::string> map;
+  for (int key = 0; key < 100; ++key) {
+    map.insert(key, std::to_string(key));
+  }
+  RBtreeMapSet::map<int, std::string> copy(map);
+
+  map.compact();
+  EXPECT_TRUE(map == copy);
+  map[5] = "five";
+  map.compact(RBtreeMapSet::NodeLayout::kInOrder);
+  EXPECT_EQ(map.at(5), "five");
+  EXPECT_EQ(map.size(), 100U);
+}
+
+TEST(Map, Hashed) {
+  RBtreeMapSet::hashed_map<std::string, int> map;
+  RBtreeMapSet::map<std::string, int> plain;
+  for (int key = 0; key < 300; ++key) {
+    map.insert(std::to_string(key), key);
+    plain.insert(std::to_string(key), key);
+  }
+  for (int key = 0; key < 300; key += 4) {
+    map.erase(map.find(std::to_string(key)));
+    plain.erase(plain.find(std::to_string(key)));
+  }
+
+  map["1"] = -1;
+  plain["1"] = -1;
+  map.insert_or_assign("1000", 1000);
+  plain.insert_or_assign("1000", 1000);
+  EXPECT_EQ(map.at("1"), -1);
+  EXPECT_EQ(map.contains("4"), false);
+  EXPECT_EQ(map.contains("5"), true);
+  EXPECT_EQ(*map.lower_bound("40"), *plain.lower_bound("40"));
+  std::vector<std::pair<std::string, int>> items(map.begin(), map.end());
+  std::vector<std::pair<std::string, int>> plain_items(plain.begin(),
+                                                       plain.end());
+  EXPECT_EQ(items, plain_items);
+  EXPECT_GT(map.index_memory_usage(), 0U);
+  EXPECT_EQ(plain.index_memory_usage(), 0U);
+
+  map.compact();
+  map.clear();
+  EXPECT_TRUE(map.find("5") == map.end());
+  map["5"] = 5;
+  EXPECT_EQ(map.at("5"), 5);
+
+  RBtreeMapSet::hashed_set<int> set{3, 1, 2};
+  set.erase(set.find(2));
+  EXPECT_EQ(set.contains(1), true);
+  EXPECT_EQ(set.contains(2), false);
+}
+
+TEST(Map, Cached) {
+  RBtreeMapSet::cached_map<int, std::string, std::hash<int>, std::less<int>, 8>
+      map;
+  for (int key = 0; key < 100; ++key) {
+    map.insert(key, std::to_string(key));
+  }
+
+  for (int i = 0; i < 1000; ++i) {
+    int key = i % 2 ? 7 : i % 100;
+    EXPECT_EQ(map.at(key), std::to_string(key));
+  }
+  map.erase(map.find(7));
+  EXPECT_EQ(map.contains(7), false);
+  map[7] = "seven";
+  EXPECT_EQ(map.at(7), "seven");
+  EXPECT_EQ(map.size(), 100U);
+
+  // Const lookups from several threads share the cache.
+  const auto &view = map;
+  std::atomic<int> wrong{0};
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 4; ++t) {
+    readers.emplace_back([&view, &wrong, t]() {
+      for (int i = 0; i < 20000; ++i) {
+        int key = (i * (t + 3)) % 120;
+        bool found = view.contains(key);
+        if (found != (key < 100) ||
+            (found && view.at(key) != (key == 7 ? "seven"
+                                                : std::to_string(key)))) {
+          ++wrong;
+        }
+      }
+    });
+  }
+  for (std::thread &reader : readers) {
+    reader.join();
+  }
+  EXPECT_EQ(wrong, 0);
+
+  RBtreeMapSet::cached_set<int> set{1, 2, 3};
+  EXPECT_EQ(set.contains(2), true);
+  set.clear();
+  EXPECT_EQ(set.contains(2), false);
+}
+
+TEST(Map, CopyAssign) {
+  RBtreeMapSet::map<int, std::string> source;
+  RBtreeMapSet::map<int, std::string> map;
+  for (int key = 0; key < 100; ++key) {
+    source.insert(key * 37 % 100, std::to_string(key));
+  }
+  for (int key = 0; key < 10; ++key) {
+    map.insert(key, "old");
+  }
+
+  map = source;
+  EXPECT_TRUE(map == source);
+  EXPECT_EQ(map.at(37), "1");
+
+  source.clear();
+  source.insert(5, "five");
+  std::set<const std::pair<const int, std::string> *> nodes;
+  for (const auto &item : map) {
+    nodes.insert(&item);
+  }
+  map = source;
+  EXPECT_EQ(map.size(), 1U);
+  EXPECT_EQ(map.at(5), "five");
+  EXPECT_EQ(nodes.count(&map.front()), 1U);
+}
+
+TEST(Map, FrontBack) {
+  RBtreeMapSet::map<int, std::string> map{{2, "b"}, {1, "a"}, {3, "c"}};
+
+  map.front().second = "x";
+  EXPECT_EQ(map.at(1), "x");
+  EXPECT_EQ(map.back().first, 3);
+
+  std::pair<const int, std::string> last = map.extract_max();
+  EXPECT_EQ(last.second, "c");
+  map.pop_front();
+  EXPECT_EQ(map.front().first, 2);
+  EXPECT_EQ(map.back().first, 2);
+  EXPECT_EQ(map.extract_min().second, "b");
+  EXPECT_TRUE(map.empty());
+  EXPECT_THROW(map.back(), std::out_of_range);
+  EXPECT_THROW(map.pop_front(), std::out_of_range);
+}
+
+TEST(Map, Diff) {
+  struct Recorder {
+    void added(const std::pair<const int, std::string> &item) {
+      log += "+" + std::to_string(item.first);
+    }
+    void removed(const std::pair<const int, std::string> &item) {
+      log += "-" + std::to_string(item.first);
+    }
+    void changed(const std::pair<const int, std::string> &old_item,
+                 const std::pair<const int, std::string> &new_item) {
+      log += "~" + old_item.second + new_item.second;
+    }
+
+    std::string log;
+  };
+
+  RBtreeMapSet::map<int, std::string> a{
+      {1, "a"}, {2, "b"}, {4, "d"}, {6, "f"}};
+  RBtreeMapSet::map<int, std::string> b{
+      {0, "z"}, {2, "b"}, {4, "D"}, {5, "e"}};
+
+  Recorder recorder;
+  RBtreeMapSet::diff(a, b, recorder);
+  EXPECT_EQ(recorder.log, "+0-1~dD+5-6");
+
+  recorder.log.clear();
+  RBtreeMapSet::diff(a, a, recorder);
+  RBtreeMapSet::diff(a, RBtreeMapSet::map<int, std::string>(a), recorder);
+  EXPECT_EQ(recorder.log, "");
+
+  RBtreeMapSet::diff(RBtreeMapSet::map<int, std::string>{}, b, recorder);
+  EXPECT_EQ(recorder.log, "+0+2+4+5");
+
+  // One three-way call per merge step.
+  int calls = 0;
+  RBtreeMapSet::map<int, std::string, CountingThreeWay> c{
+      CountingThreeWay{&calls}};
+  RBtreeMapSet::map<int, std::string, CountingThreeWay> d{
+      CountingThreeWay{&calls}};
+  for (int key : {1, 2, 3}) {
+    c.insert(key, "c");
+    d.insert(key + 1, key == 2 ? "c" : "d");
+  }
+  recorder.log.clear();
+  calls = 0;
+  RBtreeMapSet::diff(c, d, recorder);
+  EXPECT_EQ(recorder.log, "-1~cd+4");
+  EXPECT_EQ(calls, 3);
+}
+
 // SET//
 
 TEST(Set, Constructors_1) {
@@ -689,6 +1537,1686 @@ TEST(Set, Merge) {
   EXPECT_TRUE(set_2.empty());
 }
 
+TEST(Set, Compare) {
+  RBtreeMapSet::set<int, std::greater<int>> set{1, 3, 2};
+  int expected = 3;
+  for (auto it = set.begin(); it != set.end(); ++it) {
+    EXPECT_EQ(*it, expected--);
+  }
+  EXPECT_NE(set.find(2), set.end());
+  EXPECT_TRUE(set.key_comp()(2, 1));
+
+  RBtreeMapSet::set<std::string> set_1{"b", "a", "c"};
+  EXPECT_FALSE(set_1.insert("a").second);
+  EXPECT_TRUE(set_1.contains("c"));
+  EXPECT_FALSE(set_1.contains("d"));
+  EXPECT_EQ(*set_1.begin(), "a");
+
+  RBtreeMapSet::set<int, Direction> empty(Direction{true});
+  RBtreeMapSet::set<int, Direction> copy(empty);
+  RBtreeMapSet::set<int, Direction> assigned{4};
+  assigned = empty;
+  for (auto *target : {&copy, &assigned}) {
+    EXPECT_TRUE(target->key_comp().desc);
+    for (int key : {1, 3, 2}) {
+      target->insert(key);
+    }
+    EXPECT_EQ(std::vector<int>(target->begin(), target->end()),
+              (std::vector<int>{3, 2, 1}));
+  }
+}
+
+TEST(Set, SaveLoad) {
+  RBtreeMapSet::set<int> set;
+  for (int i = 0; i < 500; ++i) {
+    set.insert(i * i);
+  }
+
+  std::stringstream stream;
+  set.save(stream);
+
+  RBtreeMapSet::set<int> loaded;
+  loaded.load(stream);
+  EXPECT_TRUE(loaded == set);
+  EXPECT_TRUE(loaded.contains(49));
+  EXPECT_FALSE(loaded.contains(50));
+
+  RBtreeMapSet::set<std::string> set_1{"x", "yy", ""};
+  std::stringstream stream_1;
+  set_1.save(stream_1);
+
+  RBtreeMapSet::set<std::string> loaded_1;
+  loaded_1.load(stream_1);
+  EXPECT_TRUE(loaded_1 == set_1);
+
+  RBtreeMapSet::set<std::string> long_set{std::string(200000, 'a'), "b"};
+  std::stringstream long_stream;
+  long_set.save(long_stream);
+  RBtreeMapSet::set<std::string> long_loaded;
+  long_loaded.load(long_stream);
+  EXPECT_TRUE(long_loaded == long_set);
+}
+
+TEST(Set, LoadCorrupt) {
+  RBtreeMapSet::set<std::string> set{"abc", "de"};
+  std::stringstream stream;
+  set.save(stream);
+  std::string data = stream.str();
+
+  // The length of the first string follows the 24-byte stream header. A
+  // corrupt length fails at the end of the stream, not in the allocator.
+  for (char byte : {'\x7f', '\x01'}) {
+    std::string corrupt = data;
+    corrupt.replace(24, 8, 8, byte);
+    std::stringstream corrupt_stream(corrupt);
+    RBtreeMapSet::set<std::string> loaded{"kept"};
+    EXPECT_THROW(loaded.load(corrupt_stream), std::runtime_error);
+    EXPECT_TRUE(loaded.contains("kept"));
+  }
+
+  std::stringstream empty;
+  RBtreeMapSet::set<std::string> loaded;
+  EXPECT_THROW(loaded.load(empty), std::runtime_error);
+
+  std::stringstream truncated(data.substr(0, data.size() - 1));
+  EXPECT_THROW(loaded.load(truncated), std::runtime_error);
+  EXPECT_TRUE(loaded.empty());
+}
+
+TEST(Set, ApplyBatch) {
+  using RBtreeMapSet::BatchAction;
+
+  RBtreeMapSet::set<int> set{2, 4, 6};
+  RBtreeMapSet::set<int>::batch_op ops[] = {{BatchAction::kErase, 2},
+                                            {BatchAction::kInsert, 3},
+                                            {BatchAction::kInsert, 4}};
+
+  std::vector<bool> res = set.apply_batch(std::begin(ops), std::end(ops));
+  EXPECT_EQ(res, (std::vector<bool>{true, true, false}));
+  EXPECT_TRUE(set == (RBtreeMapSet::set<int>{3, 4, 6}));
+
+  RBtreeMapSet::set<int> single{10};
+  RBtreeMapSet::set<int>::batch_op unsorted[] = {{BatchAction::kInsert, 5},
+                                                 {BatchAction::kInsert, 1}};
+  res = single.apply_batch(std::begin(unsorted), std::end(unsorted));
+  EXPECT_EQ(res, (std::vector<bool>{true, true}));
+  EXPECT_TRUE(single.contains(1));
+  EXPECT_TRUE(single == (RBtreeMapSet::set<int>{1, 5, 10}));
+}
+
+TEST(Set, Parallel) {
+  RBtreeMapSet::set<int> set{5, 1, 4, 2, 3};
+
+  auto add = [](int acc, int item) { return acc + item; };
+  EXPECT_EQ(RBtreeMapSet::parallel_reduce(set, 0, add, add), 15);
+  EXPECT_EQ(RBtreeMapSet::parallel_reduce(set, 2, 4, 0, add, add), 5);
+
+  const RBtreeMapSet::set<int> empty;
+  EXPECT_EQ(RBtreeMapSet::parallel_reduce(empty, 0, add, add), 0);
+}
+
+TEST(Set, Hint) {
+  RBtreeMapSet::set<int> set{10, 20, 30};
+
+  auto it = set.insert(set.find(20), 25);
+  EXPECT_EQ(*it, 25);
+  EXPECT_TRUE(set.insert(set.begin(), 25) == it);
+  EXPECT_EQ(*set.lower_bound(21, set.find(30)), 25);
+  EXPECT_TRUE(set.find(26, it) == set.end());
+
+  set.set_finger_mode(true);
+  EXPECT_TRUE(set.contains(30));
+  EXPECT_EQ(*set.lower_bound(11), 20);
+  EXPECT_EQ(set.size(), 4U);
+}
+
+TEST(Set, PopFrontBack) {
+  RBtreeMapSet::set<int> set;
+  EXPECT_THROW(set.front(), std::out_of_range);
+  EXPECT_THROW(set.pop_back(), std::out_of_range);
+  EXPECT_THROW(set.extract_min(), std::out_of_range);
+
+  std::set<int> expected;
+  for (int i = 0; i < 1000; ++i) {
+    set.insert(i * 7919 % 1009);
+    expected.insert(i * 7919 % 1009);
+  }
+
+  for (int i = 0; !expected.empty(); ++i) {
+    EXPECT_EQ(set.front(), *expected.begin());
+    EXPECT_EQ(set.back(), *expected.rbegin());
+    if (i % 4 == 0) {
+      EXPECT_EQ(set.extract_min(), *expected.begin());
+      expected.erase(expected.begin());
+    } else if (i % 4 == 1) {
+      EXPECT_EQ(set.extract_max(), *expected.rbegin());
+      expected.erase(--expected.end());
+    } else if (i % 4 == 2) {
+      set.pop_front();
+      expected.erase(expected.begin());
+    } else {
+      set.pop_back();
+      expected.erase(--expected.end());
+    }
+    EXPECT_EQ(std::vector<int>(set.begin(), set.end()),
+              std::vector<int>(expected.begin(), expected.end()));
+  }
+  EXPECT_TRUE(set.empty());
+  EXPECT_TRUE(set.begin() == set.end());
+}
+
+TEST(Set, Diff) {
+  struct Counter {
+    void added(int key) { added_sum += key; }
+    void removed(int key) { removed_sum += key; }
+
+    int added_sum = 0;
+    int removed_sum = 0;
+  } counter;
+
+  RBtreeMapSet::set<int> a{1, 2, 3, 10};
+  RBtreeMapSet::set<int> b{2, 3, 4, 20};
+  RBtreeMapSet::diff(a, b, counter);
+  EXPECT_EQ(counter.added_sum, 24);
+  EXPECT_EQ(counter.removed_sum, 11);
+}
+
+// MAPPED MAP//
+
+TEST(MappedMap, InsertFindErase) {
+  std::string path = testing::TempDir() + "mapped_map_1.bin";
+  std::remove(path.c_str());
+
+  RBtreeMapSet::mapped_map<int, double> map(path);
+  EXPECT_TRUE(map.empty());
+  for (int i = 0; i < 2000; ++i) {
+    EXPECT_TRUE(map.insert((i * 7919) % 2000, i).second);
+  }
+  EXPECT_FALSE(map.insert(5, 0.0).second);
+  EXPECT_EQ(map.size(), 2000U);
+
+  for (int i = 0; i < 2000; i += 2) {
+    map.erase(map.find(i));
+  }
+  EXPECT_EQ(map.size(), 1000U);
+  EXPECT_FALSE(map.contains(10));
+  EXPECT_TRUE(map.contains(11));
+  EXPECT_THROW(map.at(10), std::out_of_range);
+
+  int expected = 1;
+  for (auto it = map.begin(); it != map.end(); ++it) {
+    EXPECT_EQ(it->first, expected);
+    expected += 2;
+  }
+
+  map[10] = 1.5;
+  EXPECT_FALSE(map.insert_or_assign(10, 2.5).second);
+  EXPECT_DOUBLE_EQ(map.at(10), 2.5);
+  auto last = map.end();
+  --last;
+  EXPECT_EQ(last->first, 1999);
+  std::remove(path.c_str());
+}
+
+TEST(MappedMap, Reopen) {
+  std::string path = testing::TempDir() + "mapped_map_2.bin";
+  std::remove(path.c_str());
+
+  {
+    RBtreeMapSet::mapped_map<int, int> map(path);
+    map.reserve(100);
+    for (int i = 0; i < 500; ++i) {
+      map.insert(i, i * i);
+    }
+    map.erase(map.find(250));
+    map.flush();
+  }
+
+  {
+    RBtreeMapSet::mapped_map<int, int> map(path,
+                                           RBtreeMapSet::MappedMode::kReadOnly);
+    const auto &view = map;
+    EXPECT_EQ(view.size(), 499U);
+    EXPECT_EQ(view.at(20), 400);
+    EXPECT_EQ(view.find(21)->second, 441);
+    EXPECT_EQ((--view.end())->first, 499);
+    EXPECT_FALSE(view.contains(250));
+    EXPECT_THROW(view.at(250), std::out_of_range);
+    EXPECT_THROW(map.insert(1000, 1), std::logic_error);
+    EXPECT_THROW(map[1] = 5, std::logic_error);
+    EXPECT_THROW(map.at(20) = 5, std::logic_error);
+    EXPECT_THROW(map.find(20), std::logic_error);
+    EXPECT_THROW(map.begin(), std::logic_error);
+    EXPECT_THROW(map.clear(), std::logic_error);
+    EXPECT_EQ(view.at(1), 1);
+  }
+
+  {
+    RBtreeMapSet::mapped_map<int, int> map(path);
+    EXPECT_TRUE(map.insert(250, 1).second);
+    EXPECT_EQ(map.size(), 500U);
+    map.clear();
+    EXPECT_TRUE(map.empty());
+  }
+
+  using wide_map = RBtreeMapSet::mapped_map<long long, long long>;
+  EXPECT_THROW(wide_map map(path), std::runtime_error);
+  std::remove(path.c_str());
+}
+
+TEST(MappedMap, CorruptHeader) {
+  std::string path = testing::TempDir() + "mapped_map_3.bin";
+  std::remove(path.c_str());
+  {
+    RBtreeMapSet::mapped_map<int, int> map(path);
+    for (int i = 0; i < 100; ++i) {
+      map.insert(i, i);
+    }
+  }
+
+  // The root offset follows magic, version, key_size and node_size.
+  for (std::uint64_t root : {std::uint64_t{1} << 40, std::uint64_t{3}}) {
+    std::FILE *file = std::fopen(path.c_str(), "r+b");
+    ASSERT_NE(file, nullptr);
+    std::fseek(file, 24, SEEK_SET);
+    std::fwrite(&root, sizeof(root), 1, file);
+    std::fclose(file);
+    using int_map = RBtreeMapSet::mapped_map<int, int>;
+    EXPECT_THROW(int_map map(path, RBtreeMapSet::MappedMode::kReadOnly),
+                 std::runtime_error);
+  }
+  std::remove(path.c_str());
+}
+
+TEST(MappedMap, EdgeCases) {
+  std::string path = testing::TempDir() + "mapped_map_4.bin";
+  std::remove(path.c_str());
+  const int kMin = std::numeric_limits<int>::min();
+  const int kMax = std::numeric_limits<int>::max();
+
+  {
+    RBtreeMapSet::mapped_map<int, int> map(path);
+    const auto &view = map;
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.size(), 0U);
+    EXPECT_TRUE(map.begin() == map.end());
+    EXPECT_TRUE(view.find(0) == view.end());
+    EXPECT_FALSE(map.contains(0));
+    EXPECT_THROW(view.at(0), std::out_of_range);
+
+    EXPECT_TRUE(map.insert(kMax, 1).second);
+    EXPECT_TRUE(map.insert(kMin, 2).second);
+    EXPECT_TRUE(map.insert(0, 3).second);
+    EXPECT_FALSE(map.insert(kMin, 4).second);
+    EXPECT_EQ(map.at(kMin), 2);
+    EXPECT_EQ(map.size(), 3U);
+    EXPECT_EQ(map.begin()->first, kMin);
+    EXPECT_EQ((--map.end())->first, kMax);
+
+    while (!map.empty()) {
+      map.erase(map.begin());
+    }
+    EXPECT_EQ(map.size(), 0U);
+    EXPECT_TRUE(map.begin() == map.end());
+    EXPECT_FALSE(map.contains(kMax));
+
+    // Freed nodes are reused.
+    for (int i = 0; i < 3; ++i) {
+      EXPECT_TRUE(map.insert(i, i).second);
+    }
+    map.erase(map.find(1));
+  }
+
+  {
+    RBtreeMapSet::mapped_map<int, int> map(path,
+                                           RBtreeMapSet::MappedMode::kReadOnly);
+    const auto &view = map;
+    EXPECT_EQ(view.size(), 2U);
+    EXPECT_EQ(view.begin()->first, 0);
+    EXPECT_EQ((--view.end())->first, 2);
+
+    RBtreeMapSet::mapped_map<int, int> moved(std::move(map));
+    EXPECT_EQ(moved.size(), 2U);
+    EXPECT_EQ(std::as_const(moved).at(2), 2);
+  }
+  std::remove(path.c_str());
+}
+
+// MAPPED SET//
+
+TEST(MappedSet, Tree) {
+  std::string path = testing::TempDir() + "mapped_set_1.bin";
+  std::remove(path.c_str());
+
+  RBtreeMapSet::MappedRedBlackTree<int> tree(
+      path, RBtreeMapSet::MappedMode::kReadWrite);
+  for (int i = 0; i < 3000; ++i) {
+    tree.Insert((i * 31) % 3000);
+    if (i % 100 == 0) {
+      EXPECT_EQ(tree.CheckTree(), true);
+    }
+  }
+  for (int i = 0; i < 3000; i += 3) {
+    tree.Erase(tree.Find(i));
+    if (i % 99 == 0) {
+      EXPECT_EQ(tree.CheckTree(), true);
+    }
+  }
+  EXPECT_EQ(tree.GetSize(), 2000U);
+  EXPECT_EQ(tree.CheckTree(), true);
+
+  RBtreeMapSet::mapped_set<int, std::greater<int>> set(
+      testing::TempDir() + "mapped_set_2.bin");
+  set.clear();
+  set.insert(1);
+  set.insert(3);
+  set.insert(2);
+  EXPECT_EQ(*set.begin(), 3);
+  set.erase(set.find(3));
+  EXPECT_FALSE(set.contains(3));
+  EXPECT_EQ(set.size(), 2U);
+  std::remove(path.c_str());
+  std::remove((testing::TempDir() + "mapped_set_2.bin").c_str());
+}
+
+TEST(MappedSet, EdgeCases) {
+  std::string path = testing::TempDir() + "mapped_set_3.bin";
+  std::remove(path.c_str());
+  const std::uint64_t kMax = std::numeric_limits<std::uint64_t>::max();
+
+  {
+    RBtreeMapSet::mapped_set<std::uint64_t> set(path);
+    EXPECT_TRUE(set.empty());
+    EXPECT_TRUE(set.begin() == set.end());
+    EXPECT_TRUE(set.find(0) == set.end());
+
+    EXPECT_TRUE(set.insert(kMax).second);
+    EXPECT_TRUE(set.insert(0).second);
+    EXPECT_FALSE(set.insert(kMax).second);
+    EXPECT_FALSE(set.insert(0).second);
+    EXPECT_EQ(set.size(), 2U);
+    EXPECT_EQ(*set.begin(), 0U);
+    EXPECT_EQ(*--set.end(), kMax);
+
+    while (!set.empty()) {
+      set.erase(set.begin());
+    }
+    EXPECT_TRUE(set.begin() == set.end());
+    EXPECT_FALSE(set.contains(kMax));
+    EXPECT_TRUE(set.insert(7).second);
+  }
+
+  {
+    RBtreeMapSet::mapped_set<std::uint64_t> set(
+        path, RBtreeMapSet::MappedMode::kReadOnly);
+    EXPECT_EQ(set.size(), 1U);
+    EXPECT_EQ(*set.find(7), 7U);
+    EXPECT_THROW(set.insert(8), std::logic_error);
+    EXPECT_THROW(set.erase(set.begin()), std::logic_error);
+    EXPECT_THROW(set.clear(), std::logic_error);
+    EXPECT_EQ(set.size(), 1U);
+  }
+  std::remove(path.c_str());
+}
+
+// STATIC MAP//
+
+namespace {
+
+// Orders ints from largest to smallest, returning int like strcmp.
+struct DescendingThreeWay {
+  constexpr int operator()(int a, int b) const {
+    return a > b ? -1 : (a < b ? 1 : 0);
+  }
+};
+
+}  // namespace
+
+enum class Opcode { kAdd, kSub, kMul, kDiv };
+
+constexpr auto kOpcodeNames =
+    RBtreeMapSet::make_static_map<Opcode, std::string_view>(
+        {{Opcode::kMul, "mul"},
+         {Opcode::kAdd, "add"},
+         {Opcode::kDiv, "div"},
+         {Opcode::kSub, "sub"}});
+
+static_assert(kOpcodeNames.size() == 4);
+static_assert(kOpcodeNames.at(Opcode::kSub) == "sub");
+static_assert(kOpcodeNames.contains(Opcode::kDiv));
+static_assert(kOpcodeNames.begin()->first == Opcode::kAdd);
+
+TEST(StaticMap, Lookup) {
+  constexpr auto map = RBtreeMapSet::make_static_map<std::string_view, int>(
+      {{"one", 1}, {"two", 2}, {"three", 3}, {"four", 4}});
+  static_assert(map.at("three") == 3);
+  static_assert(!map.contains("five"));
+
+  EXPECT_EQ(map.at("one"), 1);
+  EXPECT_THROW(map.at("five"), std::out_of_range);
+  EXPECT_EQ(map.find("zero"), map.end());
+  EXPECT_EQ(map.find("two")->second, 2);
+
+  std::string_view expected[] = {"four", "one", "three", "two"};
+  int i = 0;
+  for (const auto &item : map) {
+    EXPECT_EQ(item.first, expected[i++]);
+  }
+
+  using pair = std::pair<const int, int>;
+  pair duplicates[] = {{1, 1}, {2, 2}, {1, 3}};
+  EXPECT_THROW((RBtreeMapSet::static_map<int, int, 3>(duplicates)),
+               std::invalid_argument);
+
+  constexpr auto reversed =
+      RBtreeMapSet::make_static_map<int, char, std::greater<int>>(
+          {{1, 'a'}, {3, 'c'}, {2, 'b'}});
+  static_assert(reversed.begin()->second == 'c');
+  EXPECT_EQ(reversed.at(2), 'b');
+
+  constexpr auto three_way =
+      RBtreeMapSet::make_static_map<int, char, DescendingThreeWay>(
+          {{1, 'a'}, {3, 'c'}, {2, 'b'}, {4, 'd'}});
+  static_assert(three_way.begin()->first == 4);
+  static_assert(three_way.at(1) == 'a');
+  static_assert(!three_way.contains(5));
+  EXPECT_EQ(three_way.lower_bound(0), three_way.end());
+  pair three_way_duplicates[] = {{1, 1}, {1, 2}};
+  EXPECT_THROW(
+      (RBtreeMapSet::static_map<int, int, 2, DescendingThreeWay>(
+          three_way_duplicates)),
+      std::invalid_argument);
+}
+
+TEST(StaticMap, EdgeCases) {
+  constexpr int kMin = std::numeric_limits<int>::min();
+  constexpr int kMax = std::numeric_limits<int>::max();
+
+  // An empty table does not compile; one element is the smallest.
+  constexpr auto single = RBtreeMapSet::make_static_map<int, int>({{7, 1}});
+  static_assert(single.size() == 1 && !single.empty());
+  static_assert(single.at(7) == 1);
+  EXPECT_EQ(single.find(6), single.end());
+  EXPECT_EQ(single.lower_bound(7), single.begin());
+  EXPECT_EQ(single.lower_bound(8), single.end());
+
+  constexpr auto bounds = RBtreeMapSet::make_static_map<int, char>(
+      {{kMax, 'z'}, {0, 'o'}, {kMin, 'a'}});
+  static_assert(bounds.begin()->first == kMin);
+  static_assert((bounds.end() - 1)->first == kMax);
+  static_assert(bounds.at(kMin) == 'a' && bounds.at(kMax) == 'z');
+  EXPECT_EQ(bounds.lower_bound(kMin), bounds.begin());
+  EXPECT_EQ(bounds.lower_bound(kMax)->second, 'z');
+  EXPECT_EQ(bounds.lower_bound(1)->first, kMax);
+  EXPECT_FALSE(bounds.contains(kMin + 1));
+
+  // Duplicates are found wherever they end up after sorting.
+  using pair = std::pair<const int, int>;
+  pair first[] = {{kMin, 1}, {0, 2}, {kMin, 3}};
+  pair last[] = {{kMax, 1}, {0, 2}, {kMax, 3}};
+  pair sorted[] = {{1, 1}, {2, 2}, {2, 3}};
+  EXPECT_THROW((RBtreeMapSet::static_map<int, int, 3>(first)),
+               std::invalid_argument);
+  EXPECT_THROW((RBtreeMapSet::static_map<int, int, 3>(last)),
+               std::invalid_argument);
+  EXPECT_THROW((RBtreeMapSet::static_map<int, int, 3>(sorted)),
+               std::invalid_argument);
+  EXPECT_THROW((RBtreeMapSet::static_map<int, int, 3, DescendingThreeWay>(
+                   sorted)),
+               std::invalid_argument);
+}
+
+// STATIC SET//
+
+TEST(StaticSet, Lookup) {
+  constexpr auto set = RBtreeMapSet::make_static_set<int>({5, 1, 4, 2, 3});
+  static_assert(set.contains(4));
+  static_assert(!set.contains(6));
+  static_assert(*set.begin() == 1);
+
+  int expected = 1;
+  for (int key : set) {
+    EXPECT_EQ(key, expected++);
+  }
+  EXPECT_EQ(set.find(0), set.end());
+  EXPECT_EQ(*set.lower_bound(3), 3);
+  EXPECT_EQ(set.size(), 5U);
+
+  constexpr auto descending =
+      RBtreeMapSet::make_static_set<int, DescendingThreeWay>({2, 5, 1});
+  static_assert(*descending.begin() == 5);
+  static_assert(descending.contains(1));
+  static_assert(!descending.contains(3));
+  EXPECT_EQ(*descending.lower_bound(3), 2);
+}
+
+TEST(StaticSet, EdgeCases) {
+  constexpr std::uint64_t kMax = std::numeric_limits<std::uint64_t>::max();
+
+  constexpr auto single = RBtreeMapSet::make_static_set<std::uint64_t>({0});
+  static_assert(single.size() == 1 && single.contains(0));
+  EXPECT_EQ(single.lower_bound(1), single.end());
+  EXPECT_EQ(single.find(kMax), single.end());
+
+  constexpr auto bounds =
+      RBtreeMapSet::make_static_set<std::uint64_t>({kMax, 0, kMax - 1, 1});
+  static_assert(*bounds.begin() == 0);
+  static_assert(*(bounds.end() - 1) == kMax);
+  EXPECT_EQ(*bounds.lower_bound(2), kMax - 1);
+  EXPECT_EQ(*bounds.lower_bound(kMax), kMax);
+  EXPECT_FALSE(bounds.contains(2));
+
+  std::uint64_t duplicates[] = {kMax, 0, kMax};
+  EXPECT_THROW((RBtreeMapSet::static_set<std::uint64_t, 3>(duplicates)),
+               std::invalid_argument);
+  int repeated[] = {4, 4};
+  EXPECT_THROW((RBtreeMapSet::static_set<int, 2, DescendingThreeWay>(repeated)),
+               std::invalid_argument);
+}
+
+// SMALL MAP//
+
+TEST(SmallMap, InlineAndSpill) {
+  RBtreeMapSet::small_map<int, std::string, std::less<int>, 4> map{
+      {3, "3"}, {1, "1"}};
+  EXPECT_TRUE(map.is_inline());
+  EXPECT_EQ(map.size(), 2U);
+  EXPECT_FALSE(map.insert(3, "x").second);
+  map[2] = "2";
+  auto it_4 = map.insert(4, "4").first;
+  EXPECT_TRUE(map.is_inline());
+  EXPECT_EQ(it_4->second, "4");
+
+  int expected = 1;
+  for (auto it = map.begin(); it != map.end(); ++it) {
+    EXPECT_EQ(it->first, expected);
+    EXPECT_EQ(it->second, std::to_string(expected));
+    ++expected;
+  }
+
+  auto last = map.end();
+  --last;
+  EXPECT_EQ(last->first, 4);
+  map.erase(map.find(2));
+  EXPECT_EQ(it_4->first, 4);
+  EXPECT_FALSE(map.contains(2));
+  EXPECT_THROW(map.at(2), std::out_of_range);
+
+  RBtreeMapSet::small_map<int, std::string, std::less<int>, 4> copy(map);
+  for (int i = 5; i < 100; ++i) {
+    map.insert(i, std::to_string(i));
+  }
+  EXPECT_FALSE(map.is_inline());
+  EXPECT_EQ(map.size(), 98U);
+  EXPECT_EQ(map.at(50), "50");
+  EXPECT_FALSE(map.insert_or_assign(50, "x").second);
+  EXPECT_EQ(map.at(50), "x");
+  EXPECT_EQ(map.begin()->first, 1);
+
+  EXPECT_TRUE(copy.is_inline());
+  EXPECT_EQ(copy.size(), 3U);
+  copy.swap(map);
+  EXPECT_EQ(map.size(), 3U);
+  EXPECT_EQ(copy.size(), 98U);
+
+  map.clear();
+  EXPECT_TRUE(map.empty());
+  EXPECT_TRUE(map.is_inline());
+}
+
+TEST(SmallMap, Merge) {
+  RBtreeMapSet::small_map<int, int, std::less<int>, 2> map_1{{1, 1}};
+  RBtreeMapSet::small_map<int, int, std::less<int>, 2> map_2{
+      {1, 10}, {2, 2}, {3, 3}};
+  map_1.merge(map_2);
+  EXPECT_EQ(map_1.size(), 3U);
+  EXPECT_EQ(map_1.at(1), 1);
+  EXPECT_EQ(map_2.size(), 1U);
+  EXPECT_EQ(map_2.at(1), 10);
+
+  RBtreeMapSet::small_map<int, int, std::less<int>, 2> map_3;
+  map_3 = map_1;
+  EXPECT_TRUE(map_3 == map_1);
+  map_3 = std::move(map_2);
+  EXPECT_EQ(map_3.size(), 1U);
+}
+
+TEST(SmallMap, EdgeCases) {
+  const int kMin = std::numeric_limits<int>::min();
+  const int kMax = std::numeric_limits<int>::max();
+  RBtreeMapSet::small_map<int, int, std::less<int>, 2> map;
+  const auto &view = map;
+
+  EXPECT_TRUE(map.empty());
+  EXPECT_TRUE(map.is_inline());
+  EXPECT_TRUE(map.begin() == map.end());
+  EXPECT_TRUE(view.find(0) == view.end());
+  EXPECT_FALSE(map.contains(0));
+  EXPECT_THROW(view.at(0), std::out_of_range);
+
+  // Duplicates of a full inline map do not spill it.
+  map.insert(kMax, 1);
+  map.insert(kMin, 2);
+  EXPECT_FALSE(map.insert(kMin, 3).second);
+  map[kMax] = 4;
+  EXPECT_TRUE(map.is_inline());
+  EXPECT_EQ(map.size(), 2U);
+  EXPECT_EQ(map.begin()->first, kMin);
+  EXPECT_EQ((--map.end())->second, 4);
+
+  while (!map.empty()) {
+    map.erase(map.begin());
+  }
+  EXPECT_TRUE(map.begin() == map.end());
+  EXPECT_FALSE(map.contains(kMin));
+
+  for (int key : {kMax, 0, kMin}) {
+    map.insert(key, key);
+  }
+  EXPECT_FALSE(map.is_inline());
+  EXPECT_EQ(map.begin()->first, kMin);
+  while (!map.empty()) {
+    map.erase(map.begin());
+  }
+  EXPECT_TRUE(map.begin() == map.end());
+  map.merge(map);
+  EXPECT_TRUE(map.empty());
+
+  // Only clear() goes back to inline storage.
+  map.clear();
+  EXPECT_TRUE(map.is_inline());
+  EXPECT_TRUE(map.insert(0, 0).second);
+  EXPECT_EQ(map.at(0), 0);
+}
+
+// SMALL SET//
+
+TEST(SmallSet, InlineAndSpill) {
+  RBtreeMapSet::small_set<std::string, std::less<std::string>, 3> set{"b", "a"};
+  EXPECT_TRUE(set.is_inline());
+  EXPECT_NE(set.find("a"), set.end());
+  EXPECT_EQ(set.find("z"), set.end());
+  set.insert("c");
+  EXPECT_TRUE(set.is_inline());
+  set.insert("d");
+  EXPECT_FALSE(set.is_inline());
+
+  std::string expected = "a";
+  for (const auto &key : set) {
+    EXPECT_EQ(key, expected);
+    ++expected[0];
+  }
+
+  set.erase(set.find("a"));
+  EXPECT_FALSE(set.contains("a"));
+  EXPECT_EQ(set.size(), 3U);
+
+  RBtreeMapSet::small_set<int, std::greater<int>> set_1{1, 2, 3};
+  EXPECT_EQ(*set_1.begin(), 3);
+}
+
+TEST(SmallSet, EdgeCases) {
+  const std::uint64_t kMax = std::numeric_limits<std::uint64_t>::max();
+  RBtreeMapSet::small_set<std::uint64_t, std::less<std::uint64_t>, 2> set;
+
+  EXPECT_TRUE(set.empty());
+  EXPECT_TRUE(set.begin() == set.end());
+  EXPECT_TRUE(set.find(0) == set.end());
+
+  EXPECT_TRUE(set.insert(kMax).second);
+  EXPECT_TRUE(set.insert(0).second);
+  EXPECT_FALSE(set.insert(kMax).second);
+  EXPECT_TRUE(set.is_inline());
+  EXPECT_EQ(*set.begin(), 0U);
+  EXPECT_EQ(*--set.end(), kMax);
+
+  // Erasing everything and refilling reuses the inline slots.
+  set.erase(set.find(0));
+  set.erase(set.find(kMax));
+  EXPECT_TRUE(set.empty());
+  EXPECT_TRUE(set.begin() == set.end());
+  EXPECT_TRUE(set.insert(1).second);
+  EXPECT_TRUE(set.insert(kMax - 1).second);
+  EXPECT_TRUE(set.is_inline());
+
+  RBtreeMapSet::small_set<std::uint64_t, std::less<std::uint64_t>, 2> other{
+      1, kMax};
+  set.merge(other);
+  EXPECT_FALSE(set.is_inline());
+  EXPECT_EQ(set.size(), 3U);
+  EXPECT_EQ(other.size(), 1U);
+  EXPECT_TRUE(other.contains(1));
+  EXPECT_EQ(*--set.end(), kMax);
+}
+
+// CONCURRENT SKIPLIST SET//
+
+TEST(ConcurrentSkiplistSet, Sequential) {
+  RBtreeMapSet::concurrent_skiplist_set<int> set{5, 1, 3};
+  std::set<int> expected{5, 1, 3};
+
+  for (int i = 0; i < 2000; ++i) {
+    int key = i * 7919 % 501;
+    if (i % 3 == 2) {
+      EXPECT_EQ(set.erase(key), expected.erase(key));
+    } else {
+      EXPECT_EQ(set.insert(key).second, expected.insert(key).second);
+      EXPECT_EQ(*set.find(key), key);
+    }
+  }
+
+  EXPECT_EQ(set.size(), expected.size());
+  EXPECT_EQ(std::vector<int>(set.begin(), set.end()),
+            std::vector<int>(expected.begin(), expected.end()));
+  EXPECT_TRUE(set.find(1000) == set.end());
+
+  RBtreeMapSet::concurrent_skiplist_set<int> copy(set);
+  set.clear();
+  EXPECT_TRUE(set.empty());
+  EXPECT_EQ(copy.size(), expected.size());
+  copy.erase(copy.begin());
+  EXPECT_EQ(copy.contains(*expected.begin()), false);
+}
+
+TEST(ConcurrentSkiplistSet, Threads) {
+  const int kThreads = 4;
+  const int kKeys = 20000;
+  RBtreeMapSet::concurrent_skiplist_set<int> set;
+  std::atomic<bool> done{false};
+
+  std::thread reader([&set, &done]() {
+    while (!done) {
+      int previous = -1;
+      for (int key : set) {
+        EXPECT_LT(previous, key);
+        previous = key;
+      }
+    }
+  });
+
+  std::vector<std::thread> writers;
+  for (int id = 0; id < kThreads; ++id) {
+    writers.emplace_back([&set, id]() {
+      for (int key = id; key < kKeys; key += kThreads) {
+        set.insert(key);
+        set.insert(key + 1);
+      }
+      for (int key = id; key < kKeys; key += kThreads) {
+        if (key % 2) {
+          set.erase(key);
+        }
+      }
+    });
+  }
+  for (std::thread &writer : writers) {
+    writer.join();
+  }
+  done = true;
+  reader.join();
+
+  EXPECT_EQ(set.size(), kKeys / 2 + 1U);
+  int expected = 0;
+  for (int key : set) {
+    EXPECT_EQ(key, expected);
+    expected += 2;
+  }
+}
+
+TEST(ConcurrentSkiplistSet, Stress) {
+  const int kThreads = 4;
+  const int kKeys = 6000;
+  const int kShared = 200;
+  RBtreeMapSet::concurrent_skiplist_set<int> set;
+  std::atomic<int> inserted{0};
+  std::atomic<int> erased{0};
+
+  // Every thread owns the keys equal to its id modulo kThreads, erases a
+  // third of them and probes the keys of the others. All threads race on
+  // the shared keys above kKeys: every successful insert of one of them must
+  // be matched by exactly one successful erase.
+  std::vector<std::thread> threads;
+  for (int id = 0; id < kThreads; ++id) {
+    threads.emplace_back([&, id]() {
+      for (int key = id; key < kKeys; key += kThreads) {
+        EXPECT_TRUE(set.insert(key).second);
+        EXPECT_TRUE(set.contains(key));
+        auto found = set.find(key + 1);
+        if (found != set.end()) {
+          EXPECT_EQ(*found, key + 1);
+        }
+        if (key % 3 == 0) {
+          EXPECT_EQ(set.erase(key), 1U);
+          EXPECT_TRUE(set.find(key) == set.end());
+        }
+      }
+      for (int key = kKeys; key < kKeys + kShared; ++key) {
+        inserted += set.insert(key).second;
+      }
+      for (int key = kKeys; key < kKeys + kShared; ++key) {
+        erased += static_cast<int>(set.erase(key));
+      }
+    });
+  }
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_GE(inserted, kShared);
+  EXPECT_EQ(erased, inserted.load());
+  std::vector<int> expected;
+  for (int key = 0; key < kKeys; ++key) {
+    if (key % 3) {
+      expected.push_back(key);
+    }
+  }
+  EXPECT_EQ(set.size(), expected.size());
+  EXPECT_EQ(std::vector<int>(set.begin(), set.end()), expected);
+}
+
+// CONCURRENT SKIPLIST MAP//
+
+TEST(ConcurrentSkiplistMap, InsertFindErase) {
+  RBtreeMapSet::concurrent_skiplist_map<std::string, int> map{{"b", 2},
+                                                              {"a", 1}};
+
+  EXPECT_EQ(map.insert("c", 3).second, true);
+  EXPECT_EQ(map.insert("c", 4).second, false);
+  EXPECT_EQ(map.at("c"), 3);
+  EXPECT_THROW(map.at("d"), std::out_of_range);
+  EXPECT_EQ(map.find("a")->second, 1);
+
+  std::string keys;
+  for (const auto &item : map) {
+    keys += item.first;
+  }
+  EXPECT_EQ(keys, "abc");
+
+  map.erase(map.find("b"));
+  EXPECT_EQ(map.erase("b"), 0U);
+  EXPECT_EQ(map.contains("b"), false);
+  EXPECT_EQ(map.size(), 2U);
+
+  int calls = 0;
+  RBtreeMapSet::concurrent_skiplist_map<int, int, CountingThreeWay> ordered{
+      CountingThreeWay{&calls}};
+  for (int key : {3, 1, 2, 1}) {
+    ordered.insert(key, key * 10);
+  }
+  EXPECT_EQ(ordered.size(), 3U);
+  int expected = 1;
+  for (const auto &item : ordered) {
+    EXPECT_EQ(item.first, expected++);
+  }
+  EXPECT_EQ(ordered.at(2), 20);
+}
+
+TEST(ConcurrentSkiplistMap, Stress) {
+  const int kThreads = 4;
+  const int kKeys = 4000;
+  RBtreeMapSet::concurrent_skiplist_map<int, int> map;
+  std::atomic<int> winners{0};
+
+  // Threads insert their own keys with a value derived from the key, erase
+  // every other one and race on inserting key 0 with their own id.
+  std::vector<std::thread> threads;
+  for (int id = 0; id < kThreads; ++id) {
+    threads.emplace_back([&, id]() {
+      winners += map.insert(0, id).second;
+      for (int key = id + 1; key < kKeys; key += kThreads) {
+        EXPECT_TRUE(map.insert(key, key * 2).second);
+        EXPECT_FALSE(map.insert(key, -1).second);
+        EXPECT_EQ(map.at(key), key * 2);
+        auto found = map.find(key + 1);
+        if (found != map.end()) {
+          EXPECT_EQ(found->second, (key + 1) * 2);
+        }
+        if (key % 2 == 0) {
+          map.erase(map.find(key));
+          EXPECT_FALSE(map.contains(key));
+        }
+      }
+    });
+  }
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(winners, 1);
+  EXPECT_GE(map.at(0), 0);
+  EXPECT_LT(map.at(0), kThreads);
+  map.erase(0);
+  EXPECT_EQ(map.size(), static_cast<std::size_t>(kKeys / 2));
+  int expected = 1;
+  for (const auto &item : map) {
+    EXPECT_EQ(item.first, expected);
+    EXPECT_EQ(item.second, expected * 2);
+    expected += 2;
+  }
+  EXPECT_EQ(expected, kKeys + 1);
+}
+
+// INTERVAL SET//
+
+namespace {
+
+std::vector<std::pair<int, int>> OverlappingBrute(
+    const std::set<std::pair<int, int>> &intervals, int lo, int hi) {
+  std::vector<std::pair<int, int>> res;
+  for (const auto &item : intervals) {
+    if (lo < hi && item.first < item.second && item.first < hi &&
+        lo < item.second) {
+      res.push_back(item);
+    }
+  }
+  return res;
+}
+
+std::vector<std::pair<int, int>> Pairs(
+    const std::vector<RBtreeMapSet::interval_set<int>::iterator> &its) {
+  std::vector<std::pair<int, int>> res;
+  for (auto it : its) {
+    res.push_back({(*it).lo, (*it).hi});
+  }
+  return res;
+}
+
+}  // namespace
+
+TEST(IntervalSet, Overlapping) {
+  RBtreeMapSet::interval_set<int> set{{1, 5}, {3, 4}, {6, 9}};
+  std::set<std::pair<int, int>> expected{{1, 5}, {3, 4}, {6, 9}};
+
+  for (int i = 0; i < 3000; ++i) {
+    int lo = i * 7919 % 997;
+    int hi = lo + i * 31 % 60;
+    if (i % 4 == 3) {
+      auto it = set.find({lo, hi});
+      EXPECT_EQ(it != set.end(), expected.erase({lo, hi}) == 1);
+      if (it != set.end()) {
+        set.erase(it);
+      }
+    } else {
+      EXPECT_EQ(set.insert(lo, hi).second, expected.insert({lo, hi}).second);
+    }
+  }
+  EXPECT_EQ(set.size(), expected.size());
+
+  RBtreeMapSet::interval_set<int> copy(set);
+  copy.compact();
+  for (int point = -5; point < 1070; point += 3) {
+    auto brute = OverlappingBrute(expected, point, point + 1);
+    EXPECT_EQ(Pairs(set.overlapping(point)), brute);
+    EXPECT_EQ(Pairs(copy.overlapping(point)), brute);
+
+    int hi = point + point % 40;
+    EXPECT_EQ(Pairs(set.overlapping(point, hi)),
+              OverlappingBrute(expected, point, hi));
+  }
+
+  std::size_t visited = 0;
+  set.for_each_overlapping(0, 2000, [&visited](const auto &) { ++visited; });
+  EXPECT_EQ(visited, OverlappingBrute(expected, 0, 2000).size());
+  EXPECT_TRUE(set.overlapping(10, 10).empty());
+  EXPECT_TRUE(set == copy);
+}
+
+TEST(IntervalSet, EdgeCases) {
+  const int kMin = std::numeric_limits<int>::min();
+  const int kMax = std::numeric_limits<int>::max();
+  RBtreeMapSet::interval_set<int> set;
+
+  EXPECT_TRUE(set.empty());
+  EXPECT_TRUE(set.begin() == set.end());
+  EXPECT_TRUE(set.overlapping(0).empty());
+  EXPECT_TRUE(set.overlapping(kMin, kMax).empty());
+  EXPECT_TRUE(set.find({0, 1}) == set.end());
+
+  // Empty and inverted intervals are stored but overlap nothing.
+  EXPECT_TRUE(set.insert(3, 3).second);
+  EXPECT_TRUE(set.insert(9, 2).second);
+  EXPECT_TRUE(set.overlapping(3).empty());
+  EXPECT_TRUE(set.overlapping(kMin, kMax).empty());
+
+  // Ends are half-open, also at the limits of int.
+  EXPECT_TRUE(set.insert(kMin, kMax).second);
+  EXPECT_TRUE(set.insert(-10, -5).second);
+  EXPECT_TRUE(set.insert(-5, 0).second);
+  EXPECT_FALSE(set.insert(-5, 0).second);
+  EXPECT_TRUE(set.insert(-5, 1).second);
+  EXPECT_EQ(set.size(), 6U);
+  EXPECT_EQ(Pairs(set.overlapping(kMin)),
+            (std::vector<std::pair<int, int>>{{kMin, kMax}}));
+  EXPECT_TRUE(set.overlapping(kMax).empty());
+  EXPECT_EQ(Pairs(set.overlapping(-5)),
+            (std::vector<std::pair<int, int>>{{kMin, kMax}, {-5, 0}, {-5, 1}}));
+  EXPECT_EQ(Pairs(set.overlapping(-20, -10)),
+            (std::vector<std::pair<int, int>>{{kMin, kMax}}));
+  EXPECT_EQ(Pairs(set.overlapping(-6, -5)),
+            (std::vector<std::pair<int, int>>{{kMin, kMax}, {-10, -5}}));
+  EXPECT_TRUE(set.overlapping(-6, -6).empty());
+
+  // The subtree bounds stay right while everything is erased.
+  set.erase(set.find({kMin, kMax}));
+  EXPECT_EQ(Pairs(set.overlapping(-7)),
+            (std::vector<std::pair<int, int>>{{-10, -5}}));
+  EXPECT_TRUE(set.overlapping(1).empty());
+  while (!set.empty()) {
+    set.erase(set.begin());
+    std::size_t found = 0;
+    std::size_t non_empty = 0;
+    set.for_each_overlapping(kMin, kMax, [&found](const auto &) { ++found; });
+    for (const auto &interval : set) {
+      non_empty += interval.lo < interval.hi;
+    }
+    EXPECT_EQ(found, non_empty);
+  }
+  EXPECT_TRUE(set.begin() == set.end());
+  EXPECT_TRUE(set.overlapping(-7).empty());
+}
+
+// INTERVAL MAP//
+
+TEST(IntervalMap, InsertFindErase) {
+  RBtreeMapSet::interval_map<int, std::string> map{{{0, 10}, "a"},
+                                                   {{5, 7}, "b"}};
+
+  EXPECT_EQ(map.insert({2, 3}, "c").second, true);
+  EXPECT_EQ(map.insert({2, 3}, "d").second, false);
+  EXPECT_EQ(map.insert_or_assign({2, 3}, "d").second, false);
+  EXPECT_EQ(map.at({2, 3}), "d");
+  EXPECT_THROW(map.at({2, 4}), std::out_of_range);
+  map[{8, 12}] = "e";
+
+  std::string values;
+  map.for_each_overlapping(6, [&values](const auto &item) {
+    values += item.second;
+  });
+  EXPECT_EQ(values, "ab");
+
+  for (auto it : map.overlapping(9, 20)) {
+    (*it).second += "!";
+  }
+  EXPECT_EQ(map.at({0, 10}), "a!");
+  EXPECT_EQ(map.at({8, 12}), "e!");
+
+  map.erase(map.find({0, 10}));
+  EXPECT_EQ(map.contains({0, 10}), false);
+  EXPECT_EQ(map.overlapping(2).size(), 1U);
+  EXPECT_EQ(map.size(), 3U);
+}
+
+TEST(IntervalMap, EdgeCases) {
+  const int kMin = std::numeric_limits<int>::min();
+  const int kMax = std::numeric_limits<int>::max();
+  RBtreeMapSet::interval_map<int, int> map;
+  const auto &view = map;
+
+  EXPECT_TRUE(map.empty());
+  EXPECT_TRUE(map.overlapping(0).empty());
+  EXPECT_TRUE(view.find({0, 1}) == view.end());
+  EXPECT_THROW(view.at({0, 1}), std::out_of_range);
+
+  map.insert({kMin, 0}, 1);
+  map.insert({0, kMax}, 2);
+  map.insert({5, 5}, 3);
+  EXPECT_FALSE(map.insert({0, kMax}, 4).second);
+  EXPECT_EQ(map.at({0, kMax}), 2);
+
+  int sum = 0;
+  map.for_each_overlapping(0, [&sum](const auto &item) {
+    sum += item.second;
+  });
+  EXPECT_EQ(sum, 2);
+  sum = 0;
+  map.for_each_overlapping(-1, 1, [&sum](const auto &item) {
+    sum += item.second;
+  });
+  EXPECT_EQ(sum, 3);
+  EXPECT_EQ(map.overlapping(kMin).size(), 1U);
+  EXPECT_TRUE(map.overlapping(kMax).empty());
+  EXPECT_EQ(map.overlapping(5).size(), 1U);
+
+  while (!map.empty()) {
+    map.erase(map.begin());
+  }
+  EXPECT_TRUE(map.overlapping(kMin, kMax).empty());
+  map[{1, 2}] = 7;
+  EXPECT_EQ(map.overlapping(1).size(), 1U);
+}
+
+// TTL MAP//
+
+namespace {
+
+struct FakeClock {
+  using duration = std::chrono::milliseconds;
+  using rep = duration::rep;
+  using period = duration::period;
+  using time_point = std::chrono::time_point<FakeClock>;
+  static constexpr bool is_steady = true;
+
+  static time_point now() noexcept { return current; }
+
+  static time_point current;
+};
+
+FakeClock::time_point FakeClock::current{};
+
+}  // namespace
+
+TEST(TtlMap, ExpireUntil) {
+  using ms = std::chrono::milliseconds;
+  RBtreeMapSet::ttl_map<int, std::string, std::less<int>, FakeClock> map;
+  FakeClock::current = FakeClock::time_point{};
+
+  EXPECT_EQ(map.insert(1, "a", ms(30)).second, true);
+  EXPECT_EQ(map.insert(2, "b", ms(10)).second, true);
+  EXPECT_EQ(map.insert(3, "c", ms(20)).second, true);
+  EXPECT_EQ(map.insert(2, "x", ms(50)).second, false);
+  EXPECT_EQ(map.expiry(map.find(2)), FakeClock::time_point{ms(10)});
+
+  FakeClock::current += ms(5);
+  EXPECT_TRUE(map.touch(2, ms(40)));
+  EXPECT_FALSE(map.touch(4, ms(40)));
+  map.insert_or_assign(3, "d", ms(0));
+
+  RBtreeMapSet::ttl_map<int, std::string, std::less<int>, FakeClock> copy(
+      map);
+  std::string expired;
+  EXPECT_EQ(map.expire_until(FakeClock::current + ms(30),
+                             [&expired](auto &item) {
+                               expired += std::move(item.second);
+                             }),
+            2U);
+  EXPECT_EQ(expired, "da");
+  EXPECT_EQ(map.size(), 1U);
+  EXPECT_EQ((*map.begin()).second, "b");
+  EXPECT_EQ(map.expire_until(FakeClock::current + ms(30)), 0U);
+
+  EXPECT_EQ(copy.expire_until(FakeClock::current + ms(45)), 3U);
+  EXPECT_TRUE(copy.empty());
+}
+
+TEST(TtlMap, ManyDeadlines) {
+  using ms = std::chrono::milliseconds;
+  RBtreeMapSet::ttl_map<int, int, std::less<int>, FakeClock> map;
+  FakeClock::current = FakeClock::time_point{};
+
+  for (int key = 0; key < 5000; ++key) {
+    map.insert(key * 7919 % 5003, key, ms(key % 97));
+  }
+  for (int key = 0; key < 5000; key += 3) {
+    map.erase(map.find(key * 7919 % 5003));
+  }
+
+  std::size_t total = map.size();
+  std::size_t expired = 0;
+  for (int step = 0; step < 100; step += 7) {
+    FakeClock::time_point now{ms(step)};
+    FakeClock::time_point previous{};
+    expired += map.expire_until(now, [&](auto &item) {
+      FakeClock::time_point deadline{ms(item.second % 97)};
+      EXPECT_FALSE(now < deadline);
+      EXPECT_FALSE(deadline < previous);
+      previous = deadline;
+    });
+    for (auto it = map.begin(); it != map.end(); ++it) {
+      EXPECT_TRUE(now < map.expiry(it));
+    }
+  }
+  EXPECT_EQ(expired, total);
+  EXPECT_TRUE(map.empty());
+}
+
+TEST(TtlMap, EdgeCases) {
+  using ms = std::chrono::milliseconds;
+  const int kMin = std::numeric_limits<int>::min();
+  const int kMax = std::numeric_limits<int>::max();
+  RBtreeMapSet::ttl_map<int, int, std::less<int>, FakeClock> map;
+  FakeClock::current = FakeClock::time_point{ms(100)};
+
+  int calls = 0;
+  auto count = [&calls](auto &) { ++calls; };
+  EXPECT_EQ(map.expire_until(FakeClock::current, count), 0U);
+  EXPECT_EQ(calls, 0);
+  EXPECT_TRUE(map.begin() == map.end());
+  EXPECT_FALSE(map.touch(0, ms(1)));
+
+  // A deadline equal to now has expired, a negative ttl is already past.
+  map.insert(kMin, 1, ms(10));
+  map.insert(kMax, 2, ms(-5));
+  map.insert(0, 3, ms(10));
+  EXPECT_FALSE(map.insert(0, 4, ms(1)).second);
+  EXPECT_EQ(map.expiry(map.find(0)), FakeClock::current + ms(10));
+  EXPECT_EQ((*map.begin()).first, kMin);
+  EXPECT_EQ((*--map.end()).first, kMax);
+  EXPECT_EQ(map.expire_until(FakeClock::current), 1U);
+  EXPECT_FALSE(map.contains(kMax));
+  EXPECT_EQ(map.expire_until(FakeClock::current + ms(9)), 0U);
+
+  // Entries sharing a deadline expire together.
+  for (int key = 1; key <= 100; ++key) {
+    map.insert(key, key, ms(10));
+  }
+  EXPECT_TRUE(map.touch(kMin, ms(20)));
+  EXPECT_EQ(map.expire_until(FakeClock::current + ms(10), count), 101U);
+  EXPECT_EQ(calls, 101);
+  EXPECT_EQ(map.size(), 1U);
+
+  // Erasing the entry with the earliest deadline updates the subtree
+  // minimum it held.
+  map.insert(5, 5, ms(1));
+  map.erase(map.find(5));
+  EXPECT_EQ(map.expire_until(FakeClock::current + ms(19)), 0U);
+  map.erase(map.begin());
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(map.expire_until(FakeClock::time_point::max()), 0U);
+}
+
+TEST(StringSet, MatchesStdSet) {
+  RBtreeMapSet::string_set set;
+  std::set<std::string> expected;
+
+  for (int i = 0; i < 3000; ++i) {
+    int id = i * 7919 % 3001;
+    std::string key = "/api/v" + std::to_string(id % 3) + "/users/" +
+                      std::to_string(id) + (id % 4 ? "/profile" : "");
+    EXPECT_EQ(set.insert(key).second, expected.insert(key).second);
+  }
+  set.insert("");
+  expected.insert("");
+  set.insert(std::string("/api/\xff"));
+  expected.insert(std::string("/api/\xff"));
+  for (int id = 0; id < 3001; id += 5) {
+    std::string key = "/api/v" + std::to_string(id % 3) + "/users/" +
+                      std::to_string(id);
+    auto it = set.find(key);
+    EXPECT_EQ(it != set.end(), expected.erase(key) == 1);
+    if (it != set.end()) {
+      set.erase(it);
+    }
+  }
+
+  EXPECT_EQ(set.size(), expected.size());
+  EXPECT_EQ(std::vector<std::string>(set.begin(), set.end()),
+            std::vector<std::string>(expected.begin(), expected.end()));
+  std::vector<std::string> backwards;
+  for (auto it = set.end(); it != set.begin();) {
+    backwards.push_back(*--it);
+  }
+  EXPECT_EQ(backwards, std::vector<std::string>(expected.rbegin(),
+                                                expected.rend()));
+
+  for (std::string key : {"", "/", "/api/v1/users/1", "/api/v1/users/10/q",
+                          "/api/v2/users/9999", "/api/v3", "/b"}) {
+    auto it = set.lower_bound(key);
+    auto std_it = expected.lower_bound(key);
+    EXPECT_EQ(it == set.end(), std_it == expected.end());
+    if (std_it != expected.end()) {
+      EXPECT_EQ(*it, *std_it);
+    }
+  }
+
+  for (std::string prefix : {"", "/api/v1/users/12", "/api/v0/users/2700/",
+                             "/api/v2/users/100/profile", "/x"}) {
+    std::vector<std::string> found;
+    for (const std::string &key : set.with_prefix(prefix)) {
+      found.push_back(key);
+    }
+    std::vector<std::string> scan;
+    for (const std::string &key : expected) {
+      if (key.compare(0, prefix.size(), prefix) == 0) {
+        scan.push_back(key);
+      }
+    }
+    EXPECT_EQ(found, scan);
+  }
+
+  RBtreeMapSet::string_set copy(set);
+  EXPECT_TRUE(copy == set);
+  copy.clear();
+  EXPECT_TRUE(copy.empty());
+  EXPECT_TRUE(copy.with_prefix("").empty());
+  copy = {"/api/v0/users/3/profile", "/z"};
+  set.merge(copy);
+  EXPECT_EQ(std::vector<std::string>(copy.begin(), copy.end()),
+            std::vector<std::string>{"/api/v0/users/3/profile"});
+  EXPECT_TRUE(set.contains("/z"));
+}
+
+TEST(StringSet, EdgeCases) {
+  RBtreeMapSet::string_set set;
+  const auto &view = set;
+
+  EXPECT_TRUE(set.empty());
+  EXPECT_TRUE(set.begin() == set.end());
+  EXPECT_TRUE(view.find("") == view.end());
+  EXPECT_TRUE(view.lower_bound("") == view.end());
+  EXPECT_TRUE(set.with_prefix("").empty());
+  EXPECT_FALSE(set.contains(""));
+
+  // Keys that are prefixes of each other, with NUL and high bytes, sort
+  // like std::string.
+  std::string long_key(1000, 'a');
+  std::set<std::string> expected{"",
+                                 "a",
+                                 "ab",
+                                 std::string("a\0b", 3),
+                                 std::string("a\0", 2),
+                                 "\x01",
+                                 "\x7f",
+                                 "\x80",
+                                 "\xff",
+                                 long_key,
+                                 long_key + "b"};
+  for (const std::string &key : expected) {
+    EXPECT_TRUE(set.insert(key).second);
+  }
+  for (const std::string &key : expected) {
+    EXPECT_FALSE(set.insert(key).second);
+  }
+  EXPECT_EQ(set.size(), expected.size());
+  EXPECT_EQ(std::vector<std::string>(set.begin(), set.end()),
+            std::vector<std::string>(expected.begin(), expected.end()));
+  EXPECT_FALSE(set.contains(std::string(999, 'a')));
+  EXPECT_EQ(*view.lower_bound(std::string(999, 'a')), long_key);
+  auto count = [](auto range) {
+    return std::distance(range.begin(), range.end());
+  };
+  EXPECT_EQ(count(set.with_prefix(std::string("a\0", 2))), 2);
+  EXPECT_EQ(count(set.with_prefix(std::string(1000, 'a'))), 2);
+
+  // Erasing inner keys leaves their extensions, in any order down to empty.
+  set.erase(set.find("a"));
+  EXPECT_TRUE(set.contains("ab"));
+  EXPECT_TRUE(set.contains(std::string("a\0b", 3)));
+  expected.erase("a");
+  for (const std::string &key : {std::string(""), long_key,
+                                 std::string("a\0", 2)}) {
+    set.erase(set.find(key));
+    expected.erase(key);
+    EXPECT_EQ(std::vector<std::string>(set.begin(), set.end()),
+              std::vector<std::string>(expected.begin(), expected.end()));
+  }
+  while (!set.empty()) {
+    set.erase(set.begin());
+  }
+  EXPECT_TRUE(set.begin() == set.end());
+  EXPECT_TRUE(set.with_prefix("a").empty());
+  EXPECT_TRUE(set.insert("ab").second);
+  EXPECT_EQ(*set.begin(), "ab");
+}
+
+TEST(StringMap, InsertFindErase) {
+  RBtreeMapSet::string_map<int> map{{"/usr/lib", 1}, {"/usr/bin", 2}};
+
+  map["/usr"] = 3;
+  map.insert("/usr/local/bin", 4);
+  map.insert_or_assign("/usr/bin", 5);
+  EXPECT_FALSE(map.insert("/usr", 6).second);
+  EXPECT_EQ(map.at("/usr"), 3);
+  EXPECT_EQ(map.at("/usr/bin"), 5);
+  EXPECT_THROW(map.at("/us"), std::out_of_range);
+
+  auto it = map.find("/usr/lib");
+  EXPECT_EQ(it->first, "/usr/lib");
+  it->second = 7;
+  EXPECT_EQ(map.at("/usr/lib"), 7);
+
+  std::vector<std::string> keys;
+  for (auto [key, value] : map.with_prefix("/usr/")) {
+    keys.push_back(key + "=" + std::to_string(value));
+  }
+  EXPECT_EQ(keys, (std::vector<std::string>{"/usr/bin=5", "/usr/lib=7",
+                                            "/usr/local/bin=4"}));
+
+  map.erase(map.find("/usr/bin"));
+  map.erase(map.find("/usr"));
+  EXPECT_EQ(map.size(), 2U);
+  EXPECT_EQ(map.begin()->first, "/usr/lib");
+  EXPECT_EQ(map.lower_bound("/usr/lo")->first, "/usr/local/bin");
+  EXPECT_EQ(map.lower_bound("/usr/m"), map.end());
+
+  const RBtreeMapSet::string_map<int> copy(map);
+  EXPECT_TRUE(copy == map);
+  EXPECT_EQ(copy.find("/usr/local/bin")->second, 4);
+}
+
+TEST(StringMap, EdgeCases) {
+  RBtreeMapSet::string_map<int> map;
+  const auto &view = map;
+
+  EXPECT_TRUE(map.empty());
+  EXPECT_TRUE(map.begin() == map.end());
+  EXPECT_THROW(view.at(""), std::out_of_range);
+  EXPECT_TRUE(view.find("") == view.end());
+  EXPECT_TRUE(map.with_prefix("").empty());
+
+  map[""] = 1;
+  map["abc"] = 2;
+  EXPECT_FALSE(map.insert("", 3).second);
+  EXPECT_EQ(map.at(""), 1);
+  EXPECT_THROW(view.at("ab"), std::out_of_range);
+  EXPECT_FALSE(map.contains("abcd"));
+  auto count = [](auto range) {
+    return std::distance(range.begin(), range.end());
+  };
+  EXPECT_EQ(count(map.with_prefix("ab")), 1);
+
+  // Splitting the edge "abc" at "ab" keeps both values.
+  map["ab"] = 4;
+  EXPECT_EQ(map.at("abc"), 2);
+  EXPECT_EQ(map.at("ab"), 4);
+  EXPECT_EQ(count(map.with_prefix("ab")), 2);
+  map.erase(map.find("ab"));
+  EXPECT_EQ(map.at("abc"), 2);
+  EXPECT_FALSE(map.contains("ab"));
+
+  while (!map.empty()) {
+    map.erase(map.begin());
+  }
+  EXPECT_TRUE(map.begin() == map.end());
+  EXPECT_TRUE(view.lower_bound("") == view.end());
+  EXPECT_TRUE(map.insert_or_assign("x", 5).second);
+  EXPECT_EQ(map.size(), 1U);
+}
+
+TEST(IntSet, MatchesStdSet) {
+  RBtreeMapSet::int_set<std::uint32_t> set;
+  std::set<std::uint32_t> expected;
+
+  for (std::uint32_t i = 0; i < 20000; ++i) {
+    std::uint32_t key = i % 2 ? i * 2654435761u % 5000 : 200000 + i / 2;
+    EXPECT_EQ(set.insert(key).second, expected.insert(key).second);
+    EXPECT_EQ(*set.insert(key).first, key);
+  }
+  for (std::uint32_t key : {0xffffffffu, 0xffff0000u, 65535u, 65536u}) {
+    set.insert(key);
+    expected.insert(key);
+  }
+  for (std::uint32_t key = 0; key < 5000; key += 3) {
+    EXPECT_EQ(set.erase(key), expected.erase(key));
+  }
+  auto found = set.find(200002);
+  ASSERT_NE(found, set.end());
+  set.erase(found);
+  expected.erase(200002);
+
+  auto check = [&] {
+    EXPECT_EQ(set.size(), expected.size());
+    EXPECT_EQ(std::vector<std::uint32_t>(set.begin(), set.end()),
+              std::vector<std::uint32_t>(expected.begin(), expected.end()));
+    std::vector<std::uint32_t> backwards;
+    for (auto it = set.end(); it != set.begin();) {
+      backwards.push_back(*--it);
+    }
+    EXPECT_EQ(backwards, std::vector<std::uint32_t>(expected.rbegin(),
+                                                    expected.rend()));
+    for (std::uint32_t key : {0u, 3u, 4999u, 5000u, 65535u, 70000u, 200002u,
+                              209999u, 210000u, 0xfffffffeu}) {
+      auto it = set.lower_bound(key);
+      auto std_it = expected.lower_bound(key);
+      ASSERT_EQ(it == set.end(), std_it == expected.end());
+      if (std_it != expected.end()) {
+        EXPECT_EQ(*it, *std_it);
+      }
+      EXPECT_EQ(set.contains(key), expected.count(key) == 1);
+    }
+  };
+
+  check();
+  std::size_t before = set.memory_usage();
+  set.optimize();
+  EXPECT_LT(set.memory_usage(), before);
+  check();
+  for (std::uint32_t key = 200100; key < 200200; key += 2) {
+    set.erase(key);
+    expected.erase(key);
+  }
+  set.insert(199999);
+  expected.insert(199999);
+  check();
+
+  RBtreeMapSet::int_set<std::uint64_t> wide{1, 1ull << 40, 1ull << 40 | 7,
+                                            ~0ull};
+  EXPECT_EQ(wide.size(), 4u);
+  EXPECT_EQ(*wide.lower_bound(2), 1ull << 40);
+  EXPECT_EQ(*--wide.end(), ~0ull);
+  EXPECT_FALSE(wide.contains(1ull << 41));
+}
+
+TEST(IntSet, SetAlgebra) {
+  using Set = RBtreeMapSet::int_set<std::uint32_t>;
+  Set a;
+  Set b;
+  std::set<std::uint32_t> std_a;
+  std::set<std::uint32_t> std_b;
+
+  for (std::uint32_t i = 0; i < 30000; ++i) {
+    std::uint32_t key = i * 2654435761u % 300000;
+    a.insert(key);
+    std_a.insert(key);
+    key = i < 15000 ? 100000 + i : i * 40503u % 200000;
+    b.insert(key);
+    std_b.insert(key);
+  }
+  b.optimize();
+
+  auto as_vector = [](const Set &set) {
+    return std::vector<std::uint32_t>(set.begin(), set.end());
+  };
+  std::vector<std::uint32_t> expected;
+  std::set_union(std_a.begin(), std_a.end(), std_b.begin(), std_b.end(),
+                 std::back_inserter(expected));
+  EXPECT_EQ(as_vector(a | b), expected);
+  EXPECT_EQ((a | b).size(), expected.size());
+  expected.clear();
+  std::set_intersection(std_a.begin(), std_a.end(), std_b.begin(),
+                        std_b.end(), std::back_inserter(expected));
+  EXPECT_EQ(as_vector(a & b), expected);
+  EXPECT_EQ((b & a).size(), expected.size());
+  expected.clear();
+  std::set_difference(std_a.begin(), std_a.end(), std_b.begin(), std_b.end(),
+                      std::back_inserter(expected));
+  EXPECT_EQ(as_vector(a - b), expected);
+  EXPECT_EQ((a - b).size(), expected.size());
+  expected.clear();
+  std::set_difference(std_b.begin(), std_b.end(), std_a.begin(), std_a.end(),
+                      std::back_inserter(expected));
+  EXPECT_EQ(as_vector(b - a), expected);
+
+  Set same = a;
+  same |= same;
+  EXPECT_TRUE(same == a);
+  same -= same;
+  EXPECT_TRUE(same.empty());
+
+  Set merged = a;
+  Set other = b;
+  merged.merge(other);
+  EXPECT_TRUE(merged == (a | b));
+  EXPECT_TRUE(other == (a & b));
+}
+
+TEST(IntSet, EdgeCases) {
+  using Set = RBtreeMapSet::int_set<std::uint32_t>;
+  const std::uint32_t kMax = std::numeric_limits<std::uint32_t>::max();
+  Set set;
+  const Set empty;
+
+  EXPECT_TRUE(set.empty());
+  EXPECT_TRUE(set.begin() == set.end());
+  EXPECT_TRUE(set.find(0) == set.end());
+  EXPECT_TRUE(set.lower_bound(0) == set.end());
+  EXPECT_EQ(set.erase(kMax), 0U);
+  EXPECT_EQ(set.memory_usage(), 0U);
+
+  // Neighbours across a chunk boundary and at both ends of the key range.
+  for (std::uint32_t key : {kMax, 65536u, 0u, 65535u}) {
+    EXPECT_TRUE(set.insert(key).second);
+  }
+  auto again = set.insert(65536);
+  EXPECT_FALSE(again.second);
+  EXPECT_EQ(*again.first, 65536U);
+  auto it = set.find(65535);
+  EXPECT_EQ(*++it, 65536U);
+  EXPECT_EQ(*--it, 65535U);
+  EXPECT_EQ(*set.lower_bound(1), 65535U);
+  EXPECT_EQ(*set.lower_bound(65537), kMax);
+  EXPECT_EQ(*--set.end(), kMax);
+  set.erase(set.find(kMax));
+  EXPECT_TRUE(set.lower_bound(65537) == set.end());
+
+  // Operators with an empty set.
+  EXPECT_TRUE((set | empty) == set);
+  EXPECT_TRUE((empty | set) == set);
+  EXPECT_TRUE((set & empty).empty());
+  EXPECT_TRUE((set - empty) == set);
+  EXPECT_TRUE((empty - set).empty());
+
+  // A chunk crosses from array to bitmap at 4097 keys and back when it
+  // shrinks; filling and then emptying a whole chunk drops it.
+  Set dense;
+  for (std::uint32_t key = 0; key <= 4096; ++key) {
+    dense.insert(1u << 20 | key);
+  }
+  EXPECT_EQ(dense.size(), 4097U);
+  dense.erase(1u << 20 | 4096);
+  dense.erase(1u << 20 | 4096);
+  EXPECT_EQ(dense.size(), 4096U);
+  EXPECT_EQ(*--dense.end(), (1u << 20 | 4095));
+  for (std::uint32_t key = 4096; key <= 65535; ++key) {
+    dense.insert(1u << 20 | key);
+  }
+  dense.optimize();
+  EXPECT_EQ(dense.size(), 65536U);
+  for (std::uint32_t key = 0; key <= 65535; ++key) {
+    EXPECT_EQ(dense.erase(1u << 20 | key), 1U);
+  }
+  EXPECT_TRUE(dense.empty());
+  EXPECT_TRUE(dense.begin() == dense.end());
+  EXPECT_EQ(dense.memory_usage(), 0U);
+
+  // One key per chunk over many chunks.
+  RBtreeMapSet::int_set<std::uint64_t> sparse;
+  for (std::uint64_t i = 0; i < 2000; ++i) {
+    sparse.insert((i * 7919 % 2000) << 32);
+  }
+  for (std::uint64_t i = 0; i < 2000; i += 2) {
+    EXPECT_EQ(sparse.erase(i << 32), 1U);
+  }
+  EXPECT_EQ(sparse.size(), 1000U);
+  std::uint64_t expected = 1;
+  for (std::uint64_t key : sparse) {
+    EXPECT_EQ(key, expected << 32);
+    expected += 2;
+  }
+  while (!sparse.empty()) {
+    sparse.erase(sparse.begin());
+  }
+  EXPECT_TRUE(sparse.begin() == sparse.end());
+}
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();